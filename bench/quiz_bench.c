@@ -0,0 +1,462 @@
+// quiz_bench.c - Microbenchmarks for the C Programming Quiz System
+// Times the core engine on synthetic question banks and writes the results
+// as JSON, so runs can be compared before and after a change
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "quiz_system.h"
+
+#include <unistd.h>
+
+#define BENCH_MAX_SIZES 8
+#define BENCH_WORDS_PER_QUESTION 8
+#define BENCH_RARE_WORDS 4096
+#define BENCH_OPERATIONS 17  // rows reported per bank size
+#define BENCH_SEARCH_HITS 20 // one page of interactive search results
+
+typedef struct {
+    int sizes[BENCH_MAX_SIZES];
+    int size_count;
+    int students;
+    int iterations;     // per fast operation
+    int io_iterations;  // per save/load
+    const char* output;
+} BenchConfig;
+
+typedef struct {
+    int bank_size;
+    const char* operation;
+    int iterations;
+    double mean_ns;
+    double p50_ns;
+    double p99_ns;
+    double ops_per_sec;
+} BenchResult;
+
+#define BENCH_MAX_RESULTS (BENCH_MAX_SIZES * BENCH_OPERATIONS)
+
+static BenchResult results[BENCH_MAX_RESULTS];
+static int result_count = 0;
+
+// ============================================================================
+// TIMING
+// ============================================================================
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_samples(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Every call is timed on its own so the tail is visible; the clock reads
+// add a few tens of nanoseconds to the fastest operations
+static void report(int bank_size, const char* operation, uint64_t* samples, int count) {
+    qsort(samples, count, sizeof(uint64_t), compare_samples);
+    double total = 0.0;
+    for (int i = 0; i < count; i++) {
+        total += (double)samples[i];
+    }
+
+    // A row past the table is still printed, but left out of the JSON
+    static BenchResult unstored;
+    int stored = result_count < BENCH_MAX_RESULTS;
+    BenchResult* result = stored ? &results[result_count++] : &unstored;
+    result->bank_size = bank_size;
+    result->operation = operation;
+    result->iterations = count;
+    result->mean_ns = total / count;
+    result->p50_ns = (double)samples[(count - 1) / 2];
+    result->p99_ns = (double)samples[(int)((count - 1) * 0.99)];
+    result->ops_per_sec = total > 0.0 ? count * 1e9 / total : 0.0;
+
+    printf("  %-30s %8d  %12.0f ns  p50 %12.0f  p99 %12.0f\n", operation, count, result->mean_ns,
+           result->p50_ns, result->p99_ns);
+    if (!stored) {
+        printf("⚠️  More than BENCH_OPERATIONS rows per size; %s is not saved\n", operation);
+    }
+}
+
+// ============================================================================
+// SYNTHETIC DATA
+// ============================================================================
+
+// Fixed-seed generator, so every run builds the same banks
+static uint64_t rng_state = 0x9E3779B97F4A7C15u;
+
+static uint32_t bench_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 32);
+}
+
+static const char* common_words[] = {
+    "pointer", "array", "struct", "union", "malloc", "free", "printf", "scanf",
+    "loop", "function", "recursion", "macro", "header", "compile", "variable", "integer",
+    "float", "char", "string", "buffer", "stack", "heap", "address", "value",
+    "return", "switch", "break", "static", "const", "volatile", "register", "extern",
+};
+#define COMMON_WORD_COUNT ((int)(sizeof(common_words) / sizeof(common_words[0])))
+
+// A quarter of the words come from a small common vocabulary and the rest
+// from a long tail, so searches range from broad to highly selective
+static void random_word(char* word, size_t size) {
+    uint32_t r = bench_random();
+    if (r % 4 == 0) {
+        snprintf(word, size, "%s", common_words[(r >> 2) % COMMON_WORD_COUNT]);
+    } else {
+        snprintf(word, size, "term%u", (r >> 2) % BENCH_RARE_WORDS);
+    }
+}
+
+static int build_bank(int size) {
+    char words[BENCH_WORDS_PER_QUESTION][32];
+    char text[MAX_STRING];
+    char options[MAX_OPTIONS][64];
+    char code[128];
+
+    question_store_reset();
+    for (int i = 0; i < size; i++) {
+        QuestionDraft draft;
+        memset(&draft, 0, sizeof(draft));
+        draft.id = -1;
+
+        size_t length = 0;
+        for (int w = 0; w < BENCH_WORDS_PER_QUESTION; w++) {
+            random_word(words[w], sizeof(words[w]));
+            length += snprintf(text + length, sizeof(text) - length, "%s%s", w ? " " : "What about ", words[w]);
+        }
+        snprintf(text + length, sizeof(text) - length, "?");
+        for (int o = 0; o < MAX_OPTIONS; o++) {
+            snprintf(options[o], sizeof(options[o]), "Option %d for question %d", o + 1, i);
+            draft.options[o] = options[o];
+        }
+        snprintf(code, sizeof(code), "int x = %d;\nprintf(\"%%d\", x);", i);
+
+        draft.question = text;
+        draft.correct_answer = (int)(bench_random() % MAX_OPTIONS);
+        draft.explanation = "Synthetic benchmark question";
+        draft.code_snippet = i % 3 == 0 ? code : NULL;
+        draft.difficulty = (int)(bench_random() % MAX_DIFFICULTY) + 1;
+        draft.topic = (TopicIndex)(bench_random() % NUM_C_TOPICS);
+        draft.type = MULTIPLE_CHOICE;
+        draft.hints[0] = "Think it through";
+        for (int k = 0; k < 3; k++) {
+            draft.keywords[k] = words[k];
+        }
+        draft.author = "quiz_bench";
+        draft.date_created = 1704067200;
+
+        if (add_question(&draft) < 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int register_students(int count) {
+    for (int i = 0; i < count; i++) {
+        Student profile;
+        memset(&profile, 0, sizeof(profile));
+        snprintf(profile.name, sizeof(profile.name), "Student %d", i + 1);
+        profile.student_id = i + 1;
+        reset_student_progress(&profile);
+        profile.last_practice = 1704067200;
+        profile.registration_date = 1704067200;
+        if (!register_student(&profile)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// ============================================================================
+// BENCHMARKS
+// ============================================================================
+
+static void bench_bank(const BenchConfig* config, int size, const char* path) {
+    int iterations = config->iterations;
+    int samples_needed = iterations > config->io_iterations ? iterations : config->io_iterations;
+    uint64_t* samples = malloc((size_t)samples_needed * sizeof(uint64_t));
+    if (!samples) {
+        return;
+    }
+    printf("\n📊 %d questions, %d students\n", size, config->students);
+
+    // Per-question and per-student state refers to slots in the old bank
+    reset_review_decks();
+    reset_response_sketches();
+    reset_system_analytics();
+
+    uint64_t start = now_ns();
+    if (!build_bank(size)) {
+        printf("❌ Could not build a %d-question bank\n", size);
+        free(samples);
+        return;
+    }
+    samples[0] = now_ns() - start;
+    report(size, "build_bank", samples, 1);
+
+    // Saving to the file the bank is attached to only rewrites statistics,
+    // so full saves alternate between two files
+    char other_path[MAX_STRING + 8];
+    snprintf(other_path, sizeof(other_path), "%s.b", path);
+    for (int i = 0; i < config->io_iterations; i++) {
+        start = now_ns();
+        save_questions_to_file(i % 2 ? path : other_path);
+        samples[i] = now_ns() - start;
+    }
+    report(size, "save_questions_to_file", samples, config->io_iterations);
+    if (config->io_iterations % 2) {
+        save_questions_to_file(path);
+    }
+
+    for (int i = 0; i < config->io_iterations; i++) {
+        start = now_ns();
+        int loaded = load_questions_from_file(path);
+        samples[i] = now_ns() - start;
+        if (loaded != size) {
+            printf("❌ Loaded %d of %d questions\n", loaded, size);
+        }
+    }
+    report(size, "load_questions_from_file", samples, config->io_iterations);
+
+    for (int i = 0; i < config->io_iterations; i++) {
+        start = now_ns();
+        save_questions_to_file(path);
+        samples[i] = now_ns() - start;
+    }
+    report(size, "save_question_stats", samples, config->io_iterations);
+
+    for (int i = 0; i < iterations; i++) {
+        TopicIndex topic = (TopicIndex)(bench_random() % NUM_C_TOPICS);
+        int difficulty = (int)(bench_random() % MAX_DIFFICULTY) + 1;
+        int count;
+        start = now_ns();
+        Question** found = filter_questions_by_criteria(topic, difficulty, &count);
+        samples[i] = now_ns() - start;
+        free(found);
+    }
+    report(size, "filter_questions_by_criteria", samples, iterations);
+
+    for (int i = 0; i < iterations; i++) {
+        char keyword[32];
+        random_word(keyword, sizeof(keyword));
+        int count;
+        start = now_ns();
+        Question** found = search_questions_by_keyword(keyword, &count);
+        samples[i] = now_ns() - start;
+        free(found);
+    }
+    report(size, "search_questions_by_keyword", samples, iterations);
+
+    // The interactive path: one ranked page streamed into a caller buffer
+    for (int i = 0; i < iterations; i++) {
+        char keyword[32];
+        SearchHit hits[BENCH_SEARCH_HITS];
+        random_word(keyword, sizeof(keyword));
+        start = now_ns();
+        search_questions(keyword, SEARCH_ALL, hits, BENCH_SEARCH_HITS);
+        samples[i] = now_ns() - start;
+    }
+    report(size, "search_questions top 20", samples, iterations);
+
+    // Recommendations and answers alternate across random students, as in
+    // a live deployment; the progress log is not open, so update_student_stats
+    // measures the in-memory work only
+    QuestionHotTable* hot = get_question_hot_table();
+    for (int i = 0; i < iterations; i++) {
+        Student* student = get_student_at((int)(bench_random() % config->students));
+        start = now_ns();
+        AIRecommendation recommendation = get_ai_recommendation(student);
+        samples[i] = now_ns() - start;
+        if (!recommendation.recommended_question) {
+            printf("❌ No recommendation for student %d\n", student->student_id);
+            break;
+        }
+    }
+    report(size, "get_ai_recommendation", samples, iterations);
+
+    for (int i = 0; i < iterations; i++) {
+        Student* student = get_student_at((int)(bench_random() % config->students));
+        Question* question = get_question_by_id(hot->id[bench_random() % hot->count]);
+        int is_correct = bench_random() % 3 != 0;
+        float time_taken = 5.0f + (float)(bench_random() % 600) / 10.0f;
+        start = now_ns();
+        update_student_stats(student, question, is_correct, time_taken);
+        samples[i] = now_ns() - start;
+    }
+    report(size, "update_student_stats", samples, iterations);
+
+    // Rendering text of random questions, read through the text cache
+    for (int i = 0; i < iterations; i++) {
+        Question* question = question_at((int)(bench_random() % hot->count));
+        start = now_ns();
+        size_t length = strlen(text_get(question->question)) + text_length(question->explanation);
+        samples[i] = now_ns() - start;
+        if (length == 0) {
+            printf("❌ Question %d has no text\n", question->id);
+            break;
+        }
+    }
+    report(size, "text_get", samples, iterations);
+
+    // One mock-exam variant per sitting from a shared plan
+    ExamBlueprint blueprint;
+    exam_blueprint_for_level(&blueprint, INTERMEDIATE, 40, NULL, 0);
+    ExamPlan* plan = exam_plan_build(&blueprint);
+    if (plan) {
+        int question_ids[EXAM_MAX_QUESTIONS];
+        uint64_t exam_state = rng_state;
+        for (int i = 0; i < iterations; i++) {
+            start = now_ns();
+            exam_plan_sample(plan, &exam_state, question_ids, NULL);
+            samples[i] = now_ns() - start;
+        }
+        report(size, "exam_plan_sample", samples, iterations);
+        exam_plan_free(plan);
+    }
+
+    // Embedding the bank for the tutor, then single-session chat turns
+    start = now_ns();
+    int embedded = tutor_start();
+    samples[0] = now_ns() - start;
+    TutorSession* session = embedded == size ? tutor_session_open(0) : NULL;
+    if (session) {
+        report(size, "tutor_start", samples, 1);
+        char reply[TUTOR_REPLY_LENGTH];
+        for (int i = 0; i < iterations; i++) {
+            char message[80];
+            random_word(message, 32);
+            strcat(message, " ");
+            random_word(message + strlen(message), 32);
+            start = now_ns();
+            tutor_reply(session, message, reply, sizeof(reply));
+            samples[i] = now_ns() - start;
+        }
+        report(size, "tutor_reply", samples, iterations);
+        tutor_session_close(session);
+    }
+    tutor_stop();
+
+    // The nightly cohort report, formatted on one thread and on four
+    char export_path[MAX_STRING + 8];
+    snprintf(export_path, sizeof(export_path), "%s.csv", path);
+    CohortExportOptions formats[] = {
+        { REPORT_FORMAT_CSV, 1 }, { REPORT_FORMAT_CSV, 4 }, { REPORT_FORMAT_COLUMNAR, 1 }, { REPORT_FORMAT_COLUMNAR, 4 }
+    };
+    const char* format_names[] = {
+        "export_cohort_report csv", "export_cohort_report csv x4", "export_cohort_report columnar",
+        "export_cohort_report columnar x4"
+    };
+    for (int f = 0; f < 4; f++) {
+        for (int i = 0; i < config->io_iterations; i++) {
+            start = now_ns();
+            export_cohort_report(export_path, &formats[f], NULL);
+            samples[i] = now_ns() - start;
+        }
+        report(size, format_names[f], samples, config->io_iterations);
+    }
+
+    free(samples);
+    remove(path);
+    remove(other_path);
+    remove(export_path);
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+static int write_json(const BenchConfig* config, const char* filename) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        printf("❌ Could not write %s\n", filename);
+        return 0;
+    }
+    fprintf(file, "{\n  \"benchmark\": \"quiz_bench\",\n  \"timestamp\": %lld,\n", (long long)time(NULL));
+    fprintf(file, "  \"students\": %d,\n  \"results\": [\n", config->students);
+    for (int i = 0; i < result_count; i++) {
+        BenchResult* r = &results[i];
+        fprintf(file,
+                "    {\"bank_size\": %d, \"operation\": \"%s\", \"iterations\": %d, \"mean_ns\": %.1f, "
+                "\"p50_ns\": %.1f, \"p99_ns\": %.1f, \"ops_per_sec\": %.1f}%s\n",
+                r->bank_size, r->operation, r->iterations, r->mean_ns, r->p50_ns, r->p99_ns, r->ops_per_sec,
+                i + 1 < result_count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+static void print_usage(const char* program) {
+    printf("Usage: %s [--quick] [--sizes N,N,...] [--students N] [--iterations N] [--output FILE]\n", program);
+}
+
+static int parse_sizes(BenchConfig* config, const char* list) {
+    config->size_count = 0;
+    while (*list && config->size_count < BENCH_MAX_SIZES) {
+        char* end;
+        long size = strtol(list, &end, 10);
+        if (end == list || size <= 0) {
+            return 0;
+        }
+        config->sizes[config->size_count++] = (int)size;
+        list = *end == ',' ? end + 1 : end;
+    }
+    return config->size_count > 0;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config = { { 1000, 10000, 100000 }, 3, 10000, 10000, 5, "quiz_bench.json" };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            config.iterations = 1000;
+            config.io_iterations = 2;
+        } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            if (!parse_sizes(&config, argv[++i])) {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--students") == 0 && i + 1 < argc) {
+            config.students = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            config.iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            config.output = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.students <= 0 || config.iterations <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    const char* tmpdir = getenv("TMPDIR");
+    char path[MAX_STRING];
+    snprintf(path, sizeof(path), "%s/quiz_bench_%ld.dat", tmpdir ? tmpdir : "/tmp", (long)getpid());
+
+    printf("⏱️  Quiz engine benchmarks\n");
+    reset_system_analytics();
+    if (!register_students(config.students)) {
+        printf("❌ Could not register %d students\n", config.students);
+        return 1;
+    }
+    for (int i = 0; i < config.size_count; i++) {
+        bench_bank(&config, config.sizes[i], path);
+    }
+
+    if (!write_json(&config, config.output)) {
+        return 1;
+    }
+    printf("\n💾 Results written to %s\n", config.output);
+    return 0;
+}
@@ -0,0 +1,560 @@
+// quiz_analytics.c - System analytics for the C Programming Quiz System
+// Tracks who was active on which day as bitmaps, keeps fixed-size hourly and
+// daily series of answers, and ranks questions by accuracy as they are
+// answered, so every figure in SystemAnalytics is maintained, not recomputed
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "quiz_system.h"
+#include <pthread.h>
+#include <unistd.h>
+
+// ============================================================================
+// ACTIVITY BITMAPS
+// ============================================================================
+
+#define SECONDS_PER_DAY 86400
+#define ACTIVITY_WORDS (ACTIVITY_DAYS / 64)
+
+static int day_number(time_t when) {
+    return (int)(when / SECONDS_PER_DAY);
+}
+
+static void activity_clear(ActivityBitmap* bitmap) {
+    memset(bitmap, 0, sizeof(ActivityBitmap));
+    bitmap->last_day = -1;
+}
+
+// Shifts the register so bit 0 is `day`, dropping days past the window
+static void activity_advance(ActivityBitmap* bitmap, int day) {
+    int shift = day - bitmap->last_day;
+    bitmap->last_day = day;
+    if (shift >= ACTIVITY_DAYS) {
+        memset(bitmap->bits, 0, sizeof(bitmap->bits));
+        return;
+    }
+    int words = shift / 64;
+    int bits = shift % 64;
+    for (int w = ACTIVITY_WORDS - 1; w >= 0; w--) {
+        uint64_t value = w >= words ? bitmap->bits[w - words] << bits : 0;
+        if (bits > 0 && w > words) {
+            value |= bitmap->bits[w - words - 1] >> (64 - bits);
+        }
+        bitmap->bits[w] = value;
+    }
+}
+
+void activity_mark(ActivityBitmap* bitmap, time_t when) {
+    int day = day_number(when);
+    if (bitmap->last_day < 0) {
+        activity_clear(bitmap);
+        bitmap->last_day = day;
+    } else if (day > bitmap->last_day) {
+        activity_advance(bitmap, day);
+    }
+    int age = bitmap->last_day - day; // late events land on earlier days
+    if (age < ACTIVITY_DAYS) {
+        bitmap->bits[age / 64] |= 1ull << (age % 64);
+    }
+}
+
+// Days with activity among the `window` days ending on `today`
+int activity_count(const ActivityBitmap* bitmap, time_t today, int window) {
+    if (bitmap->last_day < 0) {
+        return 0;
+    }
+    int offset = day_number(today) - bitmap->last_day; // days since bit 0
+    int end = window - offset;                          // bits [0, end) are in the window
+    if (end > ACTIVITY_DAYS) {
+        end = ACTIVITY_DAYS;
+    }
+    int count = 0;
+    for (int w = 0; w * 64 < end; w++) {
+        uint64_t word = bitmap->bits[w];
+        if (end - w * 64 < 64) {
+            word &= (1ull << (end - w * 64)) - 1;
+        }
+        count += __builtin_popcountll(word);
+    }
+    return count;
+}
+
+// Consecutive active days ending today, or yesterday if today has no
+// activity yet
+int activity_streak(const ActivityBitmap* bitmap, time_t today) {
+    if (bitmap->last_day < 0 || day_number(today) - bitmap->last_day > 1) {
+        return 0;
+    }
+    int streak = 0;
+    for (int w = 0; w < ACTIVITY_WORDS; w++) {
+        uint64_t gaps = ~bitmap->bits[w];
+        if (gaps != 0) {
+            return streak + __builtin_ctzll(gaps);
+        }
+        streak += 64;
+    }
+    return streak;
+}
+
+// ============================================================================
+// ANALYTICS STATE
+// ============================================================================
+
+// Per-day student bitsets cover the last ANALYTICS_DAY_SETS days so active
+// user counts are popcounts over a few KB. Each set is tagged with its day
+// and cleared when the ring wraps onto it.
+#define ANALYTICS_DAY_SETS 32
+#define ANALYTICS_MIN_ATTEMPTS 5 // answers before a question is ranked
+
+typedef struct {
+    int student_id;
+    ActivityBitmap activity;
+} StudentActivity;
+
+typedef struct {
+    int64_t stamp; // hour or day number the bucket currently holds
+    uint32_t attempts;
+    uint32_t correct;
+} SeriesBucket;
+
+static pthread_mutex_t analytics_lock = PTHREAD_MUTEX_INITIALIZER;
+static SystemAnalytics system_stats;
+static ChunkedArray student_activity = { sizeof(StudentActivity), 1024, 0, NULL, 0, 0 };
+static IdMap activity_index; // student_id -> student_activity index
+
+static uint64_t* day_students[ANALYTICS_DAY_SETS];
+static int day_stamps[ANALYTICS_DAY_SETS];
+static int day_set_words = 0;
+
+static SeriesBucket hourly_series[ANALYTICS_HOURS];
+static SeriesBucket daily_series[ANALYTICS_SERIES_DAYS];
+static uint64_t total_attempts = 0;
+static uint64_t total_correct = 0;
+static uint64_t topic_attempts[NUM_C_TOPICS];
+
+static RankTree hardest_questions; // score: 1 - accuracy
+static RankTree easiest_questions; // score: accuracy
+
+static int grow_day_sets(int students) {
+    int words = day_set_words ? day_set_words : 16;
+    while (words * 64 < students) {
+        words *= 2;
+    }
+    if (words == day_set_words) {
+        return 1;
+    }
+    for (int i = 0; i < ANALYTICS_DAY_SETS; i++) {
+        uint64_t* set = realloc(day_students[i], words * sizeof(uint64_t));
+        if (!set) {
+            return 0;
+        }
+        memset(set + day_set_words, 0, (words - day_set_words) * sizeof(uint64_t));
+        day_students[i] = set;
+    }
+    day_set_words = words;
+    return 1;
+}
+
+static uint64_t* day_set(int day) {
+    int index = day % ANALYTICS_DAY_SETS;
+    if (day_stamps[index] != day) {
+        if (day_stamps[index] > day) {
+            return NULL; // older than the ring
+        }
+        memset(day_students[index], 0, day_set_words * sizeof(uint64_t));
+        day_stamps[index] = day;
+    }
+    return day_students[index];
+}
+
+static StudentActivity* student_activity_for(int student_id) {
+    int index = id_map_get(&activity_index, student_id);
+    if (index >= 0) {
+        return chunked_array_at(&student_activity, index);
+    }
+    index = student_activity.count;
+    if (!grow_day_sets(index + 1)) {
+        return NULL;
+    }
+    StudentActivity* entry = chunked_array_push(&student_activity);
+    if (entry) {
+        entry->student_id = student_id;
+        activity_clear(&entry->activity);
+        id_map_put(&activity_index, student_id, index);
+        system_stats.total_users = student_activity.count;
+    }
+    return entry;
+}
+
+static void series_add(SeriesBucket* series, int size, int64_t stamp, int is_correct) {
+    SeriesBucket* bucket = &series[stamp % size];
+    if (bucket->stamp != stamp) {
+        if (bucket->stamp > stamp) {
+            return;
+        }
+        bucket->stamp = stamp;
+        bucket->attempts = 0;
+        bucket->correct = 0;
+    }
+    bucket->attempts++;
+    bucket->correct += is_correct ? 1 : 0;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void reset_system_analytics(void) {
+    pthread_mutex_lock(&analytics_lock);
+    memset(&system_stats, 0, sizeof(SystemAnalytics));
+    activity_clear(&system_stats.daily_usage);
+    for (int i = 0; i < 10; i++) {
+        system_stats.most_difficult_questions[i] = -1;
+        system_stats.easiest_questions[i] = -1;
+    }
+    chunked_array_free(&student_activity);
+    id_map_free(&activity_index);
+    for (int i = 0; i < ANALYTICS_DAY_SETS; i++) {
+        free(day_students[i]);
+        day_students[i] = NULL;
+        day_stamps[i] = 0;
+    }
+    day_set_words = 0;
+    memset(hourly_series, 0, sizeof(hourly_series));
+    memset(daily_series, 0, sizeof(daily_series));
+    total_attempts = total_correct = 0;
+    memset(topic_attempts, 0, sizeof(topic_attempts));
+    rank_tree_free(&hardest_questions);
+    rank_tree_free(&easiest_questions);
+    pthread_mutex_unlock(&analytics_lock);
+}
+
+// Counts one answer toward activity, the time series and topic usage.
+// Safe to call from session engine workers.
+void record_activity(Student* student, TopicIndex topic, int is_correct, time_t when) {
+    int day = day_number(when);
+    pthread_mutex_lock(&analytics_lock);
+
+    StudentActivity* entry = student_activity_for(student->student_id);
+    if (entry) {
+        activity_mark(&entry->activity, when);
+        uint64_t* set = day_set(day);
+        if (set) {
+            int index = id_map_get(&activity_index, student->student_id);
+            set[index / 64] |= 1ull << (index % 64);
+        }
+    }
+    activity_mark(&system_stats.daily_usage, when);
+
+    series_add(hourly_series, ANALYTICS_HOURS, when / 3600, is_correct);
+    series_add(daily_series, ANALYTICS_SERIES_DAYS, day, is_correct);
+    total_attempts++;
+    total_correct += is_correct ? 1 : 0;
+    system_stats.avg_accuracy = (float)total_correct / total_attempts;
+    topic_attempts[topic]++;
+
+    // Twelve topics: a single insertion pass keeps them ordered
+    int position = 0;
+    while (position < NUM_C_TOPICS && system_stats.most_practiced_topics[position] != topic) {
+        position++;
+    }
+    if (total_attempts == 1) {
+        for (int t = 0; t < NUM_C_TOPICS; t++) {
+            system_stats.most_practiced_topics[t] = (TopicIndex)t;
+        }
+        position = topic;
+    }
+    while (position > 0 &&
+           topic_attempts[system_stats.most_practiced_topics[position - 1]] < topic_attempts[topic]) {
+        system_stats.most_practiced_topics[position] = system_stats.most_practiced_topics[position - 1];
+        position--;
+    }
+    system_stats.most_practiced_topics[position] = topic;
+
+    pthread_mutex_unlock(&analytics_lock);
+}
+
+// ============================================================================
+// ACTIVITY FILE
+// ============================================================================
+
+// Written at each progress checkpoint, so streaks and active-day counts
+// survive restarts. Answers logged after checkpoint_lsn are replayed on top.
+#define ACTIVITY_MAGIC "CQACTIVE"
+#define ACTIVITY_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t entries_checksum;
+    uint32_t reserved;
+    uint64_t checkpoint_lsn; // last progress log record reflected here
+    ActivityBitmap daily_usage;
+} ActivityFileHeader;
+
+static uint64_t loaded_activity_lsn = 0;
+
+int save_student_activity(const char* filename, uint64_t checkpoint_lsn) {
+    char temp_path[MAX_STRING + 8];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", filename);
+    FILE* fp = fopen(temp_path, "wb");
+    if (!fp) {
+        return 0;
+    }
+
+    ActivityFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ACTIVITY_MAGIC, sizeof(header.magic));
+    header.version = ACTIVITY_VERSION;
+    header.entries_checksum = 2166136261u;
+    header.checkpoint_lsn = checkpoint_lsn;
+
+    pthread_mutex_lock(&analytics_lock);
+    header.daily_usage = system_stats.daily_usage;
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    for (int i = 0; ok && i < student_activity.count; i++) {
+        // Copied field by field so padding bytes are zero, not stale memory
+        StudentActivity entry;
+        memset(&entry, 0, sizeof(entry));
+        const StudentActivity* source = chunked_array_at(&student_activity, i);
+        entry.student_id = source->student_id;
+        entry.activity.last_day = source->activity.last_day;
+        memcpy(entry.activity.bits, source->activity.bits, sizeof(entry.activity.bits));
+        header.entries_checksum = checksum_update(header.entries_checksum, &entry, sizeof(entry));
+        header.entry_count++;
+        ok = fwrite(&entry, sizeof(entry), 1, fp) == 1;
+    }
+    pthread_mutex_unlock(&analytics_lock);
+
+    ok = ok && fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1 &&
+         fflush(fp) == 0;
+#ifndef _WIN32
+    ok = ok && fsync(fileno(fp)) == 0;
+#endif
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(temp_path, filename) != 0) {
+        remove(temp_path);
+        return 0;
+    }
+    return 1;
+}
+
+// Returns how many students' activity was restored, or -1 if the file
+// exists but is unusable. The per-day sets are rebuilt from the bitmaps.
+int load_student_activity(const char* filename) {
+    loaded_activity_lsn = 0;
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) {
+        return 0;
+    }
+
+    ActivityFileHeader header;
+    int ok = fread(&header, sizeof(header), 1, fp) == 1 &&
+             memcmp(header.magic, ACTIVITY_MAGIC, sizeof(header.magic)) == 0 &&
+             header.version == ACTIVITY_VERSION;
+    StudentActivity* entries = ok ? malloc((size_t)header.entry_count * sizeof(StudentActivity) + 1) : NULL;
+    ok = entries && fread(entries, sizeof(StudentActivity), header.entry_count, fp) == header.entry_count &&
+         checksum_update(2166136261u, entries, (size_t)header.entry_count * sizeof(StudentActivity)) ==
+             header.entries_checksum;
+    fclose(fp);
+    if (!ok) {
+        free(entries);
+        return -1;
+    }
+
+    pthread_mutex_lock(&analytics_lock);
+    loaded_activity_lsn = header.checkpoint_lsn;
+    system_stats.daily_usage = header.daily_usage;
+    int restored = 0;
+    for (uint32_t i = 0; i < header.entry_count; i++) {
+        StudentActivity* entry = student_activity_for(entries[i].student_id);
+        if (!entry) {
+            continue;
+        }
+        entry->activity = entries[i].activity;
+        restored++;
+        int index = id_map_get(&activity_index, entry->student_id);
+        for (int age = 0; age < ANALYTICS_DAY_SETS && entry->activity.last_day >= 0; age++) {
+            uint64_t* set = (entry->activity.bits[age / 64] >> (age % 64)) & 1
+                                ? day_set(entry->activity.last_day - age)
+                                : NULL;
+            if (set) {
+                set[index / 64] |= 1ull << (index % 64);
+            }
+        }
+    }
+    pthread_mutex_unlock(&analytics_lock);
+    free(entries);
+    return restored;
+}
+
+// Progress log records at or below this are already in the loaded activity
+uint64_t get_activity_checkpoint_lsn(void) {
+    return loaded_activity_lsn;
+}
+
+// Re-ranks one question after its counters change and refreshes the
+// hardest and easiest lists; O(log n) per call
+void refresh_question_analytics(int slot) {
+    QuestionHotTable* hot = get_question_hot_table();
+    if (slot < 0 || slot >= hot->count || hot->times_asked[slot] < ANALYTICS_MIN_ATTEMPTS) {
+        return;
+    }
+    double accuracy = (double)hot->times_correct[slot] / hot->times_asked[slot];
+
+    pthread_mutex_lock(&analytics_lock);
+    rank_tree_set(&hardest_questions, hot->id[slot], 1.0 - accuracy);
+    rank_tree_set(&easiest_questions, hot->id[slot], accuracy);
+    int hardest = rank_tree_top(&hardest_questions, system_stats.most_difficult_questions, NULL, 10);
+    int easiest = rank_tree_top(&easiest_questions, system_stats.easiest_questions, NULL, 10);
+    for (int i = hardest; i < 10; i++) {
+        system_stats.most_difficult_questions[i] = -1;
+    }
+    for (int i = easiest; i < 10; i++) {
+        system_stats.easiest_questions[i] = -1;
+    }
+    pthread_mutex_unlock(&analytics_lock);
+}
+
+void record_session_started(void) {
+    pthread_mutex_lock(&analytics_lock);
+    system_stats.total_sessions++;
+    pthread_mutex_unlock(&analytics_lock);
+}
+
+void get_system_analytics(SystemAnalytics* analytics) {
+    pthread_mutex_lock(&analytics_lock);
+    *analytics = system_stats;
+    pthread_mutex_unlock(&analytics_lock);
+}
+
+// Distinct students active in the `window` days ending on `today`, e.g.
+// 1 for daily and 30 for monthly active users. Windows longer than the
+// per-day ring fall back to each student's own bitmap.
+int count_active_students(time_t today, int window) {
+    int day = day_number(today);
+    int active = 0;
+    pthread_mutex_lock(&analytics_lock);
+    if (window <= ANALYTICS_DAY_SETS) {
+        for (int w = 0; w < day_set_words; w++) {
+            uint64_t any = 0;
+            for (int d = day - window + 1; d <= day; d++) {
+                int index = ((d % ANALYTICS_DAY_SETS) + ANALYTICS_DAY_SETS) % ANALYTICS_DAY_SETS;
+                if (day_stamps[index] == d) {
+                    any |= day_students[index][w];
+                }
+            }
+            active += __builtin_popcountll(any);
+        }
+    } else {
+        for (int i = 0; i < student_activity.count; i++) {
+            StudentActivity* entry = chunked_array_at(&student_activity, i);
+            active += activity_count(&entry->activity, today, window) > 0;
+        }
+    }
+    pthread_mutex_unlock(&analytics_lock);
+    return active;
+}
+
+// Consecutive days the student has practised, ending today or yesterday
+int get_practice_streak(int student_id, time_t today) {
+    pthread_mutex_lock(&analytics_lock);
+    int index = id_map_get(&activity_index, student_id);
+    int streak = index >= 0
+                     ? activity_streak(&((StudentActivity*)chunked_array_at(&student_activity, index))->activity, today)
+                     : 0;
+    pthread_mutex_unlock(&analytics_lock);
+    return streak;
+}
+
+int get_active_days(int student_id, time_t today, int window) {
+    pthread_mutex_lock(&analytics_lock);
+    int index = id_map_get(&activity_index, student_id);
+    int days = index >= 0
+                   ? activity_count(&((StudentActivity*)chunked_array_at(&student_activity, index))->activity, today, window)
+                   : 0;
+    pthread_mutex_unlock(&analytics_lock);
+    return days;
+}
+
+// The last `count` hours (or days) ending at `now`, oldest first; buckets
+// outside the ring or without answers come back empty. Returns how many
+// buckets were filled.
+int get_usage_series(int hourly, time_t now, UsageBucket* buckets, int count) {
+    SeriesBucket* series = hourly ? hourly_series : daily_series;
+    int size = hourly ? ANALYTICS_HOURS : ANALYTICS_SERIES_DAYS;
+    int64_t width = hourly ? 3600 : SECONDS_PER_DAY;
+    int64_t current = now / width;
+    if (count > size) {
+        count = size;
+    }
+
+    pthread_mutex_lock(&analytics_lock);
+    for (int i = 0; i < count; i++) {
+        int64_t stamp = current - (count - 1 - i);
+        const SeriesBucket* bucket = &series[stamp % size];
+        buckets[i].start = (time_t)(stamp * width);
+        buckets[i].attempts = bucket->stamp == stamp ? bucket->attempts : 0;
+        buckets[i].correct = bucket->stamp == stamp ? bucket->correct : 0;
+    }
+    pthread_mutex_unlock(&analytics_lock);
+    return count;
+}
+
+void display_system_analytics(void) {
+    SystemAnalytics analytics;
+    get_system_analytics(&analytics);
+    time_t now = time(NULL);
+
+    printf("\n📈 System Analytics\n");
+    printf("   Users: %d tracked, %d active today, %d this week, %d this month\n",
+           analytics.total_users, count_active_students(now, 1), count_active_students(now, 7),
+           count_active_students(now, 30));
+    printf("   Days with activity (last 30): %d\n", activity_count(&analytics.daily_usage, now, 30));
+    printf("   Sessions: %d, overall accuracy: %.1f%%\n", analytics.total_sessions,
+           analytics.avg_accuracy * 100.0f);
+
+    UsageBucket day[7];
+    get_usage_series(0, now, day, 7);
+    printf("   Answers per day (last 7):");
+    for (int i = 0; i < 7; i++) {
+        printf(" %u", day[i].attempts);
+    }
+    printf("\n");
+
+    if (analytics.most_difficult_questions[0] >= 0) {
+        printf("   Hardest questions:");
+        for (int i = 0; i < 10 && analytics.most_difficult_questions[i] >= 0; i++) {
+            printf(" #%d", analytics.most_difficult_questions[i]);
+        }
+        printf("\n   Easiest questions:");
+        for (int i = 0; i < 10 && analytics.easiest_questions[i] >= 0; i++) {
+            printf(" #%d", analytics.easiest_questions[i]);
+        }
+        printf("\n");
+    }
+    if (analytics.total_users > 0) {
+        printf("   Most practiced topic: %s\n", get_topic_name(analytics.most_practiced_topics[0]));
+    }
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    QuestionBankStats bank;
+    analyze_question_bank(&bank, cores > 0 ? (int)cores : 1);
+    if (bank.accuracy.count > 0) {
+        printf("   Question accuracy: mean %.1f%%, spread %.1f%%; time vs accuracy r = %.2f\n",
+               bank.accuracy.mean * 100.0, sqrt(running_stats_variance(&bank.accuracy)) * 100.0,
+               paired_stats_correlation(&bank.time_vs_accuracy));
+    }
+    int students = predict_cohort_exam_scores();
+    if (students > 0) {
+        RunningStats predicted;
+        running_stats_init(&predicted);
+        for (int i = 0; i < students; i++) {
+            running_stats_push(&predicted, get_student_at(i)->predicted_exam_score);
+        }
+        printf("   Predicted exam score: mean %.1f%%, spread %.1f%%\n", predicted.mean,
+               sqrt(running_stats_variance(&predicted)));
+    }
+    display_response_time_report();
+}
@@ -0,0 +1,632 @@
+// quiz_backup.c - Incremental background backups for the C Programming Quiz System
+// Copies the data files into a content-addressed chunk store under
+// data/backups from a worker thread, storing only chunks it has not seen.
+// Backups start on their own while the quiz runs, at most once per
+// BACKUP_INTERVAL_SECONDS.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "quiz_system.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ============================================================================
+// FILE PINNING
+// ============================================================================
+
+// A backup opens every data file at one instant and then reads the open
+// descriptors. Files replaced by rename keep their old contents behind the
+// descriptor, so they are copy-on-write for free. Writers that would modify
+// a file in place ask first, and while a backup still reads that file they
+// fall back to writing a replacement (or skip the in-place step).
+#define BACKUP_MAX_FILES 6
+
+static pthread_mutex_t pin_lock = PTHREAD_MUTEX_INITIALIZER;
+static char pinned_paths[BACKUP_MAX_FILES][MAX_STRING];
+
+// Returns 1 with the pin lock held if the file may be modified in place;
+// the caller must then call end_in_place_write. Returns 0 if a backup is
+// reading the file.
+int begin_in_place_write(const char* path) {
+    pthread_mutex_lock(&pin_lock);
+    for (int i = 0; i < BACKUP_MAX_FILES; i++) {
+        if (pinned_paths[i][0] && strcmp(pinned_paths[i], path) == 0) {
+            pthread_mutex_unlock(&pin_lock);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void end_in_place_write(void) {
+    pthread_mutex_unlock(&pin_lock);
+}
+
+static void unpin_file(int index) {
+    pthread_mutex_lock(&pin_lock);
+    pinned_paths[index][0] = '\0';
+    pthread_mutex_unlock(&pin_lock);
+}
+
+// ============================================================================
+// CHUNK DIGESTS
+// ============================================================================
+
+// SHA-256, so chunks can be deduplicated by digest alone: two different
+// chunks sharing a name would silently corrupt a restore
+#define BACKUP_DIGEST_SIZE SHA256_DIGEST_SIZE
+
+typedef Sha256Digest BackupDigest;
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static uint32_t rotate_right(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static void sha256_block(uint32_t state[8], const unsigned char* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t)block[4 * i] << 24 | (uint32_t)block[4 * i + 1] << 16 | (uint32_t)block[4 * i + 2] << 8 |
+               block[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotate_right(w[i - 15], 7) ^ rotate_right(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotate_right(w[i - 2], 17) ^ rotate_right(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (rotate_right(e, 6) ^ rotate_right(e, 11) ^ rotate_right(e, 25)) + ((e & f) ^ (~e & g)) +
+                      sha256_k[i] + w[i];
+        uint32_t t2 = (rotate_right(a, 2) ^ rotate_right(a, 13) ^ rotate_right(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+Sha256Digest sha256_digest(const void* bytes, size_t length) {
+    const unsigned char* data = bytes;
+    uint32_t state[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                          0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    size_t done = 0;
+    for (; length - done >= 64; done += 64) {
+        sha256_block(state, data + done);
+    }
+
+    // Padding: a 1 bit, zeros, then the length in bits, in one or two blocks
+    unsigned char tail[128] = { 0 };
+    size_t rest = length - done;
+    size_t tail_length = rest + 9 <= 64 ? 64 : 128;
+    memcpy(tail, data + done, rest);
+    tail[rest] = 0x80;
+    uint64_t bits = (uint64_t)length * 8;
+    for (int i = 0; i < 8; i++) {
+        tail[tail_length - 1 - i] = (unsigned char)(bits >> (8 * i));
+    }
+    for (size_t offset = 0; offset < tail_length; offset += 64) {
+        sha256_block(state, tail + offset);
+    }
+
+    Sha256Digest digest;
+    for (int i = 0; i < 8; i++) {
+        digest.bytes[4 * i] = (unsigned char)(state[i] >> 24);
+        digest.bytes[4 * i + 1] = (unsigned char)(state[i] >> 16);
+        digest.bytes[4 * i + 2] = (unsigned char)(state[i] >> 8);
+        digest.bytes[4 * i + 3] = (unsigned char)state[i];
+    }
+    return digest;
+}
+
+// ============================================================================
+// MANIFESTS
+// ============================================================================
+
+// A backup is a text manifest listing, for each file, its identity and the
+// SHA-256 digests of its 4 KB chunks; chunks live once in
+// data/backups/chunks named by digest. A file whose size, mtime and inode match the previous backup is
+// listed again without being read.
+#define BACKUP_DIR "data/backups"
+#define BACKUP_CHUNK_DIR "data/backups/chunks"
+#define BACKUP_LATEST_FILE "data/backups/LATEST"
+#define BACKUP_MANIFEST_MAGIC "CQUIZBACKUP"
+#define BACKUP_MANIFEST_VERSION 2
+#define BACKUP_CHUNK_SIZE 4096
+#define BACKUP_INTERVAL_SECONDS 600
+
+static const char* backup_sources[BACKUP_MAX_FILES] = {
+    QUESTIONS_FILE, PROGRESS_FILE, PROGRESS_LOG_FILE, STUDENTS_FILE, ANALYTICS_FILE, REVIEWS_FILE
+};
+
+typedef struct {
+    char path[MAX_STRING];
+    int fd;              // pinned descriptor while the backup runs, else -1
+    uint64_t size;
+    int64_t mtime_ns;
+    uint64_t inode;
+    BackupDigest* chunks;
+    int chunk_count;
+} BackupFile;
+
+typedef struct {
+    BackupFile files[BACKUP_MAX_FILES];
+    int file_count;
+} BackupManifest;
+
+static void digest_to_hex(const BackupDigest* digest, char hex[BACKUP_DIGEST_SIZE * 2 + 1]) {
+    for (int i = 0; i < BACKUP_DIGEST_SIZE; i++) {
+        snprintf(hex + 2 * i, 3, "%02x", digest->bytes[i]);
+    }
+}
+
+static int digest_from_hex(const char* hex, BackupDigest* digest) {
+    if (strlen(hex) != BACKUP_DIGEST_SIZE * 2) {
+        return 0;
+    }
+    for (int i = 0; i < BACKUP_DIGEST_SIZE; i++) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) {
+            return 0;
+        }
+        digest->bytes[i] = (unsigned char)byte;
+    }
+    return 1;
+}
+
+static int same_digest(const BackupDigest* a, const BackupDigest* b) {
+    return memcmp(a->bytes, b->bytes, BACKUP_DIGEST_SIZE) == 0;
+}
+
+static void chunk_path(const BackupDigest* digest, char* path, size_t size) {
+    char hex[BACKUP_DIGEST_SIZE * 2 + 1];
+    digest_to_hex(digest, hex);
+    snprintf(path, size, "%s/%s", BACKUP_CHUNK_DIR, hex);
+}
+
+static void free_manifest(BackupManifest* manifest) {
+    for (int i = 0; i < manifest->file_count; i++) {
+        free(manifest->files[i].chunks);
+    }
+    memset(manifest, 0, sizeof(BackupManifest));
+}
+
+static int write_manifest(const char* filename, const BackupManifest* manifest, uint64_t* bytes) {
+    char temp_path[MAX_STRING + 8];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", filename);
+    FILE* fp = fopen(temp_path, "w");
+    if (!fp) {
+        return 0;
+    }
+
+    fprintf(fp, "%s %d\n", BACKUP_MANIFEST_MAGIC, BACKUP_MANIFEST_VERSION);
+    for (int i = 0; i < manifest->file_count; i++) {
+        const BackupFile* file = &manifest->files[i];
+        fprintf(fp, "file %s %llu %lld %llu %d\n", file->path, (unsigned long long)file->size,
+                (long long)file->mtime_ns, (unsigned long long)file->inode, file->chunk_count);
+        for (int c = 0; c < file->chunk_count; c++) {
+            char hex[BACKUP_DIGEST_SIZE * 2 + 1];
+            digest_to_hex(&file->chunks[c], hex);
+            fprintf(fp, "%s\n", hex);
+        }
+    }
+    long length = ftell(fp);
+    int ok = fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(temp_path, filename) != 0) {
+        remove(temp_path);
+        return 0;
+    }
+    *bytes += length > 0 ? (uint64_t)length : 0;
+    return 1;
+}
+
+static int read_manifest(const char* filename, BackupManifest* manifest) {
+    memset(manifest, 0, sizeof(BackupManifest));
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        return 0;
+    }
+
+    char magic[32];
+    int version = 0;
+    int ok = fscanf(fp, "%31s %d", magic, &version) == 2 &&
+             strcmp(magic, BACKUP_MANIFEST_MAGIC) == 0 && version == BACKUP_MANIFEST_VERSION;
+    while (ok && manifest->file_count < BACKUP_MAX_FILES) {
+        BackupFile* file = &manifest->files[manifest->file_count];
+        unsigned long long size, inode;
+        long long mtime;
+        if (fscanf(fp, " file %511s %llu %lld %llu %d", file->path, &size, &mtime, &inode,
+                   &file->chunk_count) != 5) {
+            break;
+        }
+        file->size = size;
+        file->mtime_ns = mtime;
+        file->inode = inode;
+        file->fd = -1;
+        file->chunks = file->chunk_count >= 0 ? malloc(((size_t)file->chunk_count + 1) * sizeof(BackupDigest))
+                                               : NULL;
+        ok = file->chunks != NULL;
+        for (int c = 0; ok && c < file->chunk_count; c++) {
+            char hex[BACKUP_DIGEST_SIZE * 2 + 1];
+            ok = fscanf(fp, "%64s", hex) == 1 && digest_from_hex(hex, &file->chunks[c]);
+        }
+        manifest->file_count++;
+    }
+    fclose(fp);
+    if (!ok) {
+        free_manifest(manifest);
+    }
+    return ok;
+}
+
+// ============================================================================
+// BACKUP WORKER
+// ============================================================================
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+    pthread_t thread;
+    int running;
+    int joinable;
+    atomic_int cancelled;  // set at shutdown; the worker stops at the next chunk
+    double last_started;   // 0 before the first backup of this run
+    int last_ok;
+    double started;
+    BackupManifest current;  // files pinned by the running backup
+    BackupManifest previous; // last completed backup, or loaded from LATEST
+    int previous_loaded;
+    BackupStats stats;
+} BackupState;
+
+static BackupState backup = { .lock = PTHREAD_MUTEX_INITIALIZER, .finished = PTHREAD_COND_INITIALIZER };
+
+static double backup_clock_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+}
+
+static const BackupFile* previous_entry(const char* path) {
+    for (int i = 0; i < backup.previous.file_count; i++) {
+        if (strcmp(backup.previous.files[i].path, path) == 0) {
+            return &backup.previous.files[i];
+        }
+    }
+    return NULL;
+}
+
+static int store_chunk(const BackupDigest* digest, const unsigned char* data, size_t length, BackupStats* stats) {
+    char path[MAX_STRING];
+    chunk_path(digest, path, sizeof(path));
+    struct stat existing;
+    if (stat(path, &existing) == 0) {
+        stats->chunks_reused++;
+        return 1;
+    }
+
+    char temp_path[MAX_STRING + 8];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    int fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return 0;
+    }
+    int ok = write(fd, data, length) == (ssize_t)length && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return 0;
+    }
+    stats->chunks_written++;
+    stats->bytes_written += length;
+    return 1;
+}
+
+// Chunks one pinned file. Chunks at the same position and with the same
+// digest as the previous backup are known to be stored already.
+static int backup_file(BackupFile* file, const BackupFile* previous, BackupStats* stats) {
+    file->chunk_count = (int)((file->size + BACKUP_CHUNK_SIZE - 1) / BACKUP_CHUNK_SIZE);
+    file->chunks = malloc(((size_t)file->chunk_count + 1) * sizeof(BackupDigest));
+    if (!file->chunks) {
+        return 0;
+    }
+
+    if (previous && previous->size == file->size && previous->mtime_ns == file->mtime_ns &&
+        previous->inode == file->inode) {
+        memcpy(file->chunks, previous->chunks, (size_t)file->chunk_count * sizeof(BackupDigest));
+        stats->files_unchanged++;
+        stats->chunks_reused += file->chunk_count;
+        return 1;
+    }
+
+    unsigned char buffer[BACKUP_CHUNK_SIZE];
+    for (int c = 0; c < file->chunk_count; c++) {
+        if (atomic_load(&backup.cancelled)) {
+            return 0;
+        }
+        uint64_t offset = (uint64_t)c * BACKUP_CHUNK_SIZE;
+        size_t length = file->size - offset < BACKUP_CHUNK_SIZE ? (size_t)(file->size - offset)
+                                                                : BACKUP_CHUNK_SIZE;
+        if (pread(file->fd, buffer, length, (off_t)offset) != (ssize_t)length) {
+            return 0;
+        }
+        stats->bytes_scanned += length;
+        file->chunks[c] = sha256_digest(buffer, length);
+        if (previous && c < previous->chunk_count && same_digest(&previous->chunks[c], &file->chunks[c])) {
+            stats->chunks_reused++;
+        } else if (!store_chunk(&file->chunks[c], buffer, length, stats)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void* backup_worker_main(void* arg) {
+    (void)arg;
+    BackupStats run;
+    memset(&run, 0, sizeof(run));
+
+    int ok = 1;
+    for (int i = 0; i < backup.current.file_count; i++) {
+        BackupFile* file = &backup.current.files[i];
+        ok = ok && backup_file(file, previous_entry(file->path), &run);
+        close(file->fd);
+        file->fd = -1;
+        unpin_file(i);
+    }
+
+    char manifest_path[MAX_STRING];
+    time_t now = time(NULL);
+    struct tm local;
+    localtime_r(&now, &local);
+    snprintf(manifest_path, sizeof(manifest_path), "%s/backup-%04d%02d%02d-%02d%02d%02d-%d.manifest",
+             BACKUP_DIR, local.tm_year + 1900, local.tm_mon + 1, local.tm_mday, local.tm_hour,
+             local.tm_min, local.tm_sec, backup.stats.backups_completed + backup.stats.backups_failed);
+    int cancelled = atomic_load(&backup.cancelled);
+    ok = ok && !cancelled && write_manifest(manifest_path, &backup.current, &run.bytes_written);
+
+    // LATEST names the newest complete manifest; it is replaced atomically
+    if (ok) {
+        FILE* fp = fopen(BACKUP_LATEST_FILE ".tmp", "w");
+        ok = fp && fprintf(fp, "%s\n", manifest_path) > 0;
+        ok = fp && fclose(fp) == 0 && ok && rename(BACKUP_LATEST_FILE ".tmp", BACKUP_LATEST_FILE) == 0;
+    }
+
+    pthread_mutex_lock(&backup.lock);
+    if (cancelled) {
+        // Abandoned, not failed: nothing was published and LATEST is intact
+        free_manifest(&backup.current);
+        backup.running = 0;
+        pthread_cond_broadcast(&backup.finished);
+        pthread_mutex_unlock(&backup.lock);
+        return NULL;
+    }
+    run.duration_ms = backup_clock_ms() - backup.started;
+    run.backups_completed = backup.stats.backups_completed + (ok ? 1 : 0);
+    run.backups_failed = backup.stats.backups_failed + (ok ? 0 : 1);
+    run.total_bytes_written = backup.stats.total_bytes_written + run.bytes_written;
+    backup.stats = run;
+    if (ok) {
+        free_manifest(&backup.previous);
+        backup.previous = backup.current;
+        memset(&backup.current, 0, sizeof(BackupManifest));
+    } else {
+        free_manifest(&backup.current);
+    }
+    backup.last_ok = ok;
+    backup.running = 0;
+    pthread_cond_broadcast(&backup.finished);
+    pthread_mutex_unlock(&backup.lock);
+    return NULL;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+// Starts a backup of the data files as they are on disk now and returns
+// without waiting; the student progress log is flushed first so every
+// answer given so far is included. Does nothing if a backup is running.
+void backup_data_files(void) {
+    pthread_mutex_lock(&backup.lock);
+    if (backup.running) {
+        pthread_mutex_unlock(&backup.lock);
+        printf("⏳ A backup is already running\n");
+        return;
+    }
+    if (backup.joinable) {
+        pthread_join(backup.thread, NULL);
+        backup.joinable = 0;
+    }
+    // Claimed before the lock is dropped, so two callers never both start
+    backup.running = 1;
+    backup.started = backup_clock_ms();
+    backup.last_started = backup.started;
+    atomic_store(&backup.cancelled, 0);
+    if (!backup.previous_loaded) {
+        char latest[MAX_STRING];
+        FILE* fp = fopen(BACKUP_LATEST_FILE, "r");
+        if (fp && fscanf(fp, "%511s", latest) == 1) {
+            read_manifest(latest, &backup.previous);
+        }
+        if (fp) {
+            fclose(fp);
+        }
+        backup.previous_loaded = 1;
+    }
+    pthread_mutex_unlock(&backup.lock);
+
+    if (!file_exists(BACKUP_CHUNK_DIR)) {
+        create_directory(BACKUP_DIR);
+        create_directory(BACKUP_CHUNK_DIR);
+    }
+    flush_student_progress();
+
+    // Open every file under the pin lock: no in-place write can be half
+    // done, and none starts on a pinned file until the worker releases it
+    BackupManifest* current = &backup.current;
+    memset(current, 0, sizeof(BackupManifest));
+    pthread_mutex_lock(&pin_lock);
+    for (int i = 0; i < BACKUP_MAX_FILES; i++) {
+        int fd = open(backup_sources[i], O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            continue;
+        }
+        BackupFile* file = &current->files[current->file_count];
+        snprintf(file->path, sizeof(file->path), "%s", backup_sources[i]);
+        snprintf(pinned_paths[current->file_count], MAX_STRING, "%s", backup_sources[i]);
+        file->fd = fd;
+        file->size = (uint64_t)info.st_size;
+        file->mtime_ns = (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+        file->inode = (uint64_t)info.st_ino;
+        current->file_count++;
+    }
+    pthread_mutex_unlock(&pin_lock);
+
+    pthread_mutex_lock(&backup.lock);
+    if (pthread_create(&backup.thread, NULL, backup_worker_main, NULL) == 0) {
+        backup.joinable = 1;
+        pthread_mutex_unlock(&backup.lock);
+        return;
+    }
+    pthread_mutex_unlock(&backup.lock);
+
+    // No thread available: back up inline rather than not at all
+    backup_worker_main(NULL);
+}
+
+// Starts a backup in the background once BACKUP_INTERVAL_SECONDS have
+// passed since the last one this run started, or if none has. Called at
+// startup, after progress checkpoints and between menu actions, so the
+// data files are backed up while the quiz keeps serving.
+void backup_if_due(void) {
+    pthread_mutex_lock(&backup.lock);
+    int due = !backup.running &&
+              (backup.last_started == 0 || backup_clock_ms() - backup.last_started >= BACKUP_INTERVAL_SECONDS * 1000.0);
+    pthread_mutex_unlock(&backup.lock);
+    if (due) {
+        backup_data_files();
+    }
+}
+
+// Stops a running backup at its next chunk and waits for that, which takes
+// milliseconds, so shutdown never waits for a whole backup. The abandoned
+// backup publishes nothing; the next one redoes its work.
+void cancel_backup(void) {
+    atomic_store(&backup.cancelled, 1);
+    wait_for_backup();
+}
+
+// Waits for a running backup; returns 1 if the last backup succeeded
+int wait_for_backup(void) {
+    pthread_mutex_lock(&backup.lock);
+    while (backup.running) {
+        pthread_cond_wait(&backup.finished, &backup.lock);
+    }
+    if (backup.joinable) {
+        pthread_join(backup.thread, NULL);
+        backup.joinable = 0;
+    }
+    int ok = backup.last_ok;
+    pthread_mutex_unlock(&backup.lock);
+    return ok;
+}
+
+// Counters of the last completed backup plus running totals
+void get_backup_stats(BackupStats* stats) {
+    pthread_mutex_lock(&backup.lock);
+    *stats = backup.stats;
+    pthread_mutex_unlock(&backup.lock);
+}
+
+void display_backup_stats(void) {
+    BackupStats stats;
+    get_backup_stats(&stats);
+
+    printf("\n🗄️  Backups\n");
+    printf("   Completed: %d (%d failed)\n", stats.backups_completed, stats.backups_failed);
+    if (stats.backups_completed + stats.backups_failed == 0) {
+        return;
+    }
+    printf("   Last backup: %.1f ms, %llu KB scanned, %llu KB written\n", stats.duration_ms,
+           (unsigned long long)(stats.bytes_scanned / 1024), (unsigned long long)(stats.bytes_written / 1024));
+    printf("   Chunks: %d written, %d reused; %d files unchanged\n",
+           stats.chunks_written, stats.chunks_reused, stats.files_unchanged);
+    printf("   Written across all backups: %llu KB\n",
+           (unsigned long long)(stats.total_bytes_written / 1024));
+}
+
+// Rebuilds every file listed in a manifest inside dest_dir, named by its
+// base name. Returns the number of files restored, or -1 on error.
+int restore_backup(const char* manifest_path, const char* dest_dir) {
+    BackupManifest manifest;
+    if (!read_manifest(manifest_path, &manifest)) {
+        return -1;
+    }
+
+    int restored = 0;
+    unsigned char buffer[BACKUP_CHUNK_SIZE];
+    for (int i = 0; i < manifest.file_count && restored >= 0; i++) {
+        const BackupFile* file = &manifest.files[i];
+        const char* base = strrchr(file->path, '/');
+        char target[MAX_STRING * 2];
+        snprintf(target, sizeof(target), "%s/%s", dest_dir, base ? base + 1 : file->path);
+
+        FILE* out = fopen(target, "wb");
+        uint64_t written = 0;
+        for (int c = 0; out && c < file->chunk_count; c++) {
+            char path[MAX_STRING];
+            chunk_path(&file->chunks[c], path, sizeof(path));
+            FILE* in = fopen(path, "rb");
+            size_t length = in ? fread(buffer, 1, sizeof(buffer), in) : 0;
+            if (in) {
+                fclose(in);
+            }
+            BackupDigest digest = sha256_digest(buffer, length);
+            if (length == 0 || !same_digest(&digest, &file->chunks[c]) ||
+                fwrite(buffer, 1, length, out) != length) {
+                break;
+            }
+            written += length;
+        }
+        if (!out || fclose(out) != 0 || written != file->size) {
+            restored = -1;
+        } else {
+            restored++;
+        }
+    }
+    free_manifest(&manifest);
+    return restored;
+}
@@ -0,0 +1,297 @@
+// quiz_batch.c - Headless batch grading for the C Programming Quiz System
+// Applies recorded answers without a terminal, either in order on the
+// calling thread or across session engine workers with one session per student
+
+#include "quiz_system.h"
+
+#include <ctype.h>
+#include <limits.h>
+
+// ============================================================================
+// GRADING
+// ============================================================================
+
+// Same per-session accounting as the session engine
+static void add_to_summary(QuizSession* summary, float* time_total, int is_correct, float time_taken) {
+    summary->questions_attempted++;
+    summary->questions_correct += is_correct;
+    summary->session_accuracy = calculate_accuracy(summary->questions_correct, summary->questions_attempted);
+    *time_total += time_taken;
+    summary->avg_response_time = *time_total / summary->questions_attempted;
+    sketch_record(&summary->response_times, time_taken);
+}
+
+static int grow_students(BatchGradeResult* result, Student*** students, int* capacity) {
+    if (result->student_count < *capacity) {
+        return 1;
+    }
+    int new_capacity = *capacity ? *capacity * 2 : 64;
+    int* ids = realloc(result->student_ids, new_capacity * sizeof(int));
+    if (ids) {
+        result->student_ids = ids;
+    }
+    QuizSession* sessions = realloc(result->sessions, new_capacity * sizeof(QuizSession));
+    if (sessions) {
+        result->sessions = sessions;
+    }
+    Student** grown = realloc(*students, new_capacity * sizeof(Student*));
+    if (grown) {
+        *students = grown;
+    }
+    if (!ids || !sessions || !grown) {
+        return 0;
+    }
+    *capacity = new_capacity;
+    return 1;
+}
+
+// Resolves the student answering, registering them if asked to; returns
+// their index in the result, or -1
+static int batch_student(BatchGradeResult* result, IdMap* index, Student*** students, int* capacity,
+                         int student_id, int register_unknown) {
+    int found = id_map_get(index, student_id);
+    if (found >= 0) {
+        return found;
+    }
+
+    Student* student = find_student_by_id(student_id);
+    if (!student && register_unknown) {
+        Student profile;
+        memset(&profile, 0, sizeof(profile));
+        snprintf(profile.name, sizeof(profile.name), "Student %d", student_id);
+        profile.student_id = student_id;
+        reset_student_progress(&profile);
+        profile.registration_date = time(NULL);
+        profile.last_practice = profile.registration_date;
+        student = register_student(&profile);
+        if (!student) {
+            // Registered by another thread since the lookup
+            student = find_student_by_id(student_id);
+        }
+    }
+    if (!student || !grow_students(result, students, capacity)) {
+        return -1;
+    }
+
+    int position = result->student_count++;
+    result->student_ids[position] = student_id;
+    (*students)[position] = student;
+    memset(&result->sessions[position], 0, sizeof(QuizSession));
+    id_map_put(index, student_id, position);
+    return position;
+}
+
+// Grades every answer through the update_student_stats path. Each student's
+// answers are applied in the order given, so a single worker replays a
+// recording exactly; with more workers, different students are graded in
+// parallel and only the order of shared question statistics may differ.
+// Returns the number of answers applied, or -1 if memory ran out.
+int grade_answer_batch(const GradedAnswer* answers, int count, const BatchGradeOptions* options,
+                       BatchGradeResult* result) {
+    BatchGradeOptions defaults = { 1, 0 };
+    if (!options) {
+        options = &defaults;
+    }
+    memset(result, 0, sizeof(BatchGradeResult));
+    uint64_t started = trace_now();
+    time_t now = time(NULL);
+
+    // Validate and assign owners up front, on this thread, so workers only
+    // ever see answers that will apply
+    IdMap index;
+    id_map_init(&index);
+    Student** students = NULL;
+    int capacity = 0;
+    int* owners = malloc((count > 0 ? count : 1) * sizeof(int));
+    if (!owners) {
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        const GradedAnswer* answer = &answers[i];
+        Question* question = get_question_by_id(answer->question_id);
+        owners[i] = question && answer->answer >= 0 && answer->answer < MAX_OPTIONS
+                        ? batch_student(result, &index, &students, &capacity, answer->student_id,
+                                        options->register_unknown)
+                        : -1;
+        if (owners[i] < 0) {
+            result->rejected++;
+            continue;
+        }
+
+        QuizSession* summary = &result->sessions[owners[i]];
+        time_t when = answer->answered_at ? answer->answered_at : now;
+        if (summary->start_time == 0 || when < summary->start_time) {
+            summary->start_time = when;
+        }
+        if (when > summary->end_time) {
+            summary->end_time = when;
+        }
+        result->applied++;
+        result->correct += answer->answer == question->correct_answer;
+    }
+
+    if (options->worker_count <= 1) {
+        float* time_totals = calloc(result->student_count > 0 ? result->student_count : 1, sizeof(float));
+        if (!time_totals) {
+            free(owners);
+            free(students);
+            id_map_free(&index);
+            free_batch_grade_result(result);
+            return -1;
+        }
+        for (int s = 0; s < result->student_count; s++) {
+            record_session_started();
+        }
+        for (int i = 0; i < count; i++) {
+            if (owners[i] < 0) {
+                continue;
+            }
+            const GradedAnswer* answer = &answers[i];
+            Question* question = get_question_by_id(answer->question_id);
+            int is_correct = answer->answer == question->correct_answer;
+            update_student_stats_at(students[owners[i]], question, is_correct, answer->response_time,
+                                    answer->answered_at ? answer->answered_at : now);
+            add_to_summary(&result->sessions[owners[i]], &time_totals[owners[i]], is_correct,
+                           answer->response_time);
+        }
+        free(time_totals);
+    } else {
+        SessionEngine* engine = session_engine_create(options->worker_count);
+        if (!engine) {
+            free(owners);
+            free(students);
+            id_map_free(&index);
+            free_batch_grade_result(result);
+            return -1;
+        }
+        // Sessions are opened in result order, so a session id is the
+        // student's position
+        session_engine_set_adaptive(engine, 0);
+        for (int s = 0; s < result->student_count; s++) {
+            session_engine_open(engine, students[s]);
+        }
+        for (int i = 0; i < count; i++) {
+            if (owners[i] >= 0) {
+                const GradedAnswer* answer = &answers[i];
+                session_engine_submit_at(engine, owners[i], answer->question_id, answer->answer,
+                                         answer->response_time, answer->answered_at ? answer->answered_at : now);
+            }
+        }
+        session_engine_sync(engine);
+        for (int s = 0; s < result->student_count; s++) {
+            QuizSession* summary = &result->sessions[s];
+            time_t start_time = summary->start_time;
+            time_t end_time = summary->end_time;
+            session_engine_session_summary(engine, s, summary);
+            summary->start_time = start_time;
+            summary->end_time = end_time;
+        }
+        session_engine_destroy(engine);
+    }
+
+    for (int s = 0; s < result->student_count; s++) {
+        result->sessions[s].session_level = students[s]->current_level;
+    }
+    free(owners);
+    free(students);
+    id_map_free(&index);
+    result->seconds = (trace_now() - started) / 1e9;
+    return (int)result->applied;
+}
+
+void free_batch_grade_result(BatchGradeResult* result) {
+    free(result->student_ids);
+    free(result->sessions);
+    memset(result, 0, sizeof(BatchGradeResult));
+}
+
+// ============================================================================
+// ANSWER FILES
+// ============================================================================
+
+// Reads "student_id,question_id,answer,response_time[,answered_at]" lines.
+// answer is the option number as shown to students (1-4); blank lines, '#'
+// comments and a header line are skipped. Returns the number of answers,
+// or -1 if the file cannot be read or a line is malformed.
+int load_graded_answers(const char* filename, GradedAnswer** answers) {
+    *answers = NULL;
+    FILE* fp = fopen(filename, "r");
+    if (!fp) {
+        return -1;
+    }
+
+    char line[MAX_STRING];
+    int count = 0;
+    int capacity = 0;
+    int line_number = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        line_number++;
+        char* text = trim_whitespace(line);
+        if (*text == '\0' || *text == '#' || isalpha((unsigned char)*text)) {
+            continue;
+        }
+
+        GradedAnswer answer;
+        memset(&answer, 0, sizeof(answer));
+        char* end;
+        int ok = 1;
+        // Ids must fit an int: student ids are positive, question ids not negative
+        long student_id = strtol(text, &end, 10);
+        ok = ok && end != text && *end == ',' && student_id > 0 && student_id <= INT_MAX;
+        answer.student_id = (int)student_id;
+        text = end + 1;
+        long question_id = strtol(text, &end, 10);
+        ok = ok && end != text && *end == ',' && question_id >= 0 && question_id <= INT_MAX;
+        answer.question_id = (int)question_id;
+        text = end + 1;
+        answer.answer = (int)strtol(text, &end, 10) - 1;
+        ok = ok && end != text && *end == ',';
+        text = end + 1;
+        answer.response_time = strtof(text, &end);
+        ok = ok && end != text && (*end == '\0' || *end == ',');
+        if (ok && *end == ',') {
+            text = end + 1;
+            answer.answered_at = (time_t)strtoll(text, &end, 10);
+            ok = end != text && *end == '\0';
+        }
+        if (!ok) {
+            printf("❌ %s:%d: expected student_id,question_id,answer,response_time[,answered_at]\n", filename,
+                   line_number);
+            fclose(fp);
+            free(*answers);
+            *answers = NULL;
+            return -1;
+        }
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            GradedAnswer* grown = realloc(*answers, capacity * sizeof(GradedAnswer));
+            if (!grown) {
+                fclose(fp);
+                free(*answers);
+                *answers = NULL;
+                return -1;
+            }
+            *answers = grown;
+        }
+        (*answers)[count++] = answer;
+    }
+    fclose(fp);
+    return count;
+}
+
+// One line per student, in the order they first answered
+int save_batch_grade_report(const char* filename, const BatchGradeResult* result) {
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        return 0;
+    }
+    fprintf(fp, "student_id,attempted,correct,accuracy,avg_response_time,p90_response_time\n");
+    for (int s = 0; s < result->student_count; s++) {
+        const QuizSession* session = &result->sessions[s];
+        fprintf(fp, "%d,%d,%d,%.4f,%.2f,%.1f\n", result->student_ids[s], session->questions_attempted,
+                session->questions_correct, session->session_accuracy, session->avg_response_time,
+                sketch_quantile(&session->response_times, 0.90f));
+    }
+    return fclose(fp) == 0;
+}
@@ -0,0 +1,493 @@
+// quiz_engine.c - Concurrent session engine for the C Programming Quiz System
+// Serves many students from one process: each session's answers are applied
+// on a worker thread, and per-question counters go to per-worker shards that
+// are merged on read and folded into the hot table at sync points
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "quiz_system.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+// ============================================================================
+// STATISTICS SHARDS
+// ============================================================================
+
+// One worker writes each shard, so updates are plain relaxed load/store
+// pairs with no read-modify-write and no cache line shared between workers.
+// Readers on other threads see each counter atomically.
+typedef struct {
+    _Atomic int* times_asked;
+    _Atomic int* times_correct;
+    _Atomic float* time_sum;
+    int capacity;
+} StatShard;
+
+static int shard_init(StatShard* shard, int capacity) {
+    shard->times_asked = calloc(capacity, sizeof(_Atomic int));
+    shard->times_correct = calloc(capacity, sizeof(_Atomic int));
+    shard->time_sum = calloc(capacity, sizeof(_Atomic float));
+    shard->capacity = capacity;
+    return shard->times_asked && shard->times_correct && shard->time_sum;
+}
+
+static void shard_free(StatShard* shard) {
+    free(shard->times_asked);
+    free(shard->times_correct);
+    free(shard->time_sum);
+}
+
+static void shard_add(StatShard* shard, int slot, int is_correct, float time_taken) {
+    atomic_store_explicit(&shard->times_asked[slot],
+                          atomic_load_explicit(&shard->times_asked[slot], memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    if (is_correct) {
+        atomic_store_explicit(&shard->times_correct[slot],
+                              atomic_load_explicit(&shard->times_correct[slot], memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+    }
+    atomic_store_explicit(&shard->time_sum[slot],
+                          atomic_load_explicit(&shard->time_sum[slot], memory_order_relaxed) + time_taken,
+                          memory_order_relaxed);
+}
+
+// ============================================================================
+// ENGINE STATE
+// ============================================================================
+
+typedef struct {
+    int session_id;
+    int question_id;
+    int answer;
+    float time_taken;
+    time_t answered_at; // 0: when the worker applies it
+} EngineAnswer;
+
+typedef struct {
+    Student* student;
+    int worker;          // every session of a student shares one worker
+    QuizSession summary;
+    float response_time_total;
+    _Atomic int next_question_id;
+} EngineSession;
+
+typedef struct {
+    SessionEngine* engine;
+    int index;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t idle;
+    EngineAnswer* queue; // ring buffer
+    int head;
+    int count;
+    int capacity;
+    int busy;            // an answer is being applied
+    StatShard shard;
+} EngineWorker;
+
+struct SessionEngine {
+    EngineWorker* workers;
+    int worker_count;
+    atomic_int paused;   // set by session_engine_sync, checked by idle workers
+    atomic_int stopping;
+    pthread_mutex_t sessions_lock;
+    ChunkedArray sessions;
+    pthread_mutex_t stats_lock; // readers of the shards against their growth
+    int bank_size;       // shards cover slots [0, bank_size)
+    int adaptive;        // pick each session's next question after an answer
+};
+
+// The recommender keeps shared caches, so picks are serialised. A pick costs
+// about a microsecond, far below the answer rate of a class.
+static pthread_mutex_t recommend_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static EngineSession* engine_session(SessionEngine* engine, int session_id) {
+    pthread_mutex_lock(&engine->sessions_lock);
+    EngineSession* session = session_id >= 0 && session_id < engine->sessions.count
+                                 ? chunked_array_at(&engine->sessions, session_id)
+                                 : NULL;
+    pthread_mutex_unlock(&engine->sessions_lock);
+    return session;
+}
+
+// Contention on the recommender shows up as its own trace point
+static void lock_recommender(void) {
+    TRACE_SCOPE(TRACE_RECOMMEND_LOCK_WAIT);
+    pthread_mutex_lock(&recommend_lock);
+}
+
+static void pick_next_question(EngineSession* session) {
+    lock_recommender();
+    AIRecommendation rec = get_ai_recommendation(session->student);
+    pthread_mutex_unlock(&recommend_lock);
+    atomic_store(&session->next_question_id,
+                 rec.recommended_question ? rec.recommended_question->id : -1);
+}
+
+// Runs on the student's worker, the only thread that touches the student
+static void apply_engine_answer(SessionEngine* engine, EngineWorker* worker, const EngineAnswer* answer) {
+    TRACE_SCOPE(TRACE_ENGINE_ANSWER);
+    EngineSession* session = engine_session(engine, answer->session_id);
+    Question* question = get_question_by_id(answer->question_id);
+    if (!session || !question) {
+        return;
+    }
+
+    int is_correct = answer->answer == question->correct_answer;
+    apply_answer_to_student(session->student, question_topic(question), is_correct);
+    if (answer->answered_at) {
+        session->student->last_practice = answer->answered_at;
+    }
+    log_student_answer(session->student, question, is_correct, answer->time_taken);
+    record_activity(session->student, question_topic(question), is_correct, session->student->last_practice);
+    // Questions are only added through session_engine_add_question, which
+    // sizes the shards to the bank before any worker runs again
+    shard_add(&worker->shard, question->slot, is_correct, answer->time_taken);
+    record_response_time(question->slot, answer->time_taken);
+
+    session->summary.questions_attempted++;
+    session->summary.questions_correct += is_correct;
+    session->summary.session_accuracy = calculate_accuracy(session->summary.questions_correct,
+                                                           session->summary.questions_attempted);
+    session->response_time_total += answer->time_taken;
+    session->summary.avg_response_time = session->response_time_total / session->summary.questions_attempted;
+    sketch_record(&session->summary.response_times, answer->time_taken);
+
+    lock_recommender();
+    recommendation_record_answer(session->student, question, is_correct, answer->time_taken);
+    pthread_mutex_unlock(&recommend_lock);
+    if (engine->adaptive) {
+        pick_next_question(session);
+    }
+}
+
+static void* engine_worker_main(void* arg) {
+    EngineWorker* worker = arg;
+    SessionEngine* engine = worker->engine;
+
+    pthread_mutex_lock(&worker->lock);
+    for (;;) {
+        while (!engine->stopping && (worker->count == 0 || engine->paused)) {
+            pthread_cond_wait(&worker->work_ready, &worker->lock);
+        }
+        if (engine->stopping && worker->count == 0) {
+            break;
+        }
+        EngineAnswer answer = worker->queue[worker->head];
+        worker->head = (worker->head + 1) % worker->capacity;
+        worker->count--;
+        worker->busy = 1;
+        pthread_mutex_unlock(&worker->lock);
+
+        apply_engine_answer(engine, worker, &answer);
+
+        pthread_mutex_lock(&worker->lock);
+        worker->busy = 0;
+        pthread_cond_broadcast(&worker->idle);
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return NULL;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+SessionEngine* session_engine_create(int worker_count) {
+    if (worker_count < 1) {
+        worker_count = 1;
+    }
+    SessionEngine* engine = calloc(1, sizeof(SessionEngine));
+    if (!engine) {
+        return NULL;
+    }
+    engine->workers = calloc(worker_count, sizeof(EngineWorker));
+    engine->worker_count = worker_count;
+    engine->bank_size = get_total_questions();
+    engine->adaptive = 1;
+    pthread_mutex_init(&engine->sessions_lock, NULL);
+    pthread_mutex_init(&engine->stats_lock, NULL);
+    chunked_array_init(&engine->sessions, sizeof(EngineSession), 256);
+
+    reserve_response_sketches(engine->bank_size);
+
+    for (int i = 0; engine->workers && i < worker_count; i++) {
+        EngineWorker* worker = &engine->workers[i];
+        worker->engine = engine;
+        worker->index = i;
+        worker->capacity = 256;
+        worker->queue = malloc(worker->capacity * sizeof(EngineAnswer));
+        pthread_mutex_init(&worker->lock, NULL);
+        pthread_cond_init(&worker->work_ready, NULL);
+        pthread_cond_init(&worker->idle, NULL);
+        if (!worker->queue || !shard_init(&worker->shard, engine->bank_size) ||
+            pthread_create(&worker->thread, NULL, engine_worker_main, worker) != 0) {
+            shard_free(&worker->shard);
+            free(worker->queue);
+            engine->worker_count = i;
+            session_engine_destroy(engine);
+            return NULL;
+        }
+    }
+    return engine;
+}
+
+// Registers a student's session and computes its first question. The
+// student must outlive the session; registry students always do.
+int session_engine_open(SessionEngine* engine, Student* student) {
+    pthread_mutex_lock(&engine->sessions_lock);
+    int session_id = engine->sessions.count;
+    EngineSession* session = chunked_array_push(&engine->sessions);
+    pthread_mutex_unlock(&engine->sessions_lock);
+    if (!session) {
+        return -1;
+    }
+
+    session->student = student;
+    session->worker = (int)((unsigned int)student->student_id % (unsigned int)engine->worker_count);
+    session->summary.start_time = time(NULL);
+    session->summary.session_level = student->current_level;
+    atomic_store(&session->next_question_id, -1);
+    record_session_started();
+    if (engine->adaptive) {
+        pick_next_question(session);
+    }
+    return session_id;
+}
+
+// Batch grading turns this off: nobody is waiting for a next question, and
+// picking one would serialise every answer on the recommender
+void session_engine_set_adaptive(SessionEngine* engine, int adaptive) {
+    engine->adaptive = adaptive;
+}
+
+// Queues an answer on the session's worker; returns 0 if it could not queue
+int session_engine_submit(SessionEngine* engine, int session_id, int question_id, int answer, float time_taken) {
+    return session_engine_submit_at(engine, session_id, question_id, answer, time_taken, 0);
+}
+
+// As session_engine_submit, for an answer given at a recorded time
+int session_engine_submit_at(SessionEngine* engine, int session_id, int question_id, int answer, float time_taken,
+                             time_t answered_at) {
+    EngineSession* session = engine_session(engine, session_id);
+    if (!session) {
+        return 0;
+    }
+    // Pinning a student to one worker keeps it single-writer, however many
+    // sessions it has open
+    EngineWorker* worker = &engine->workers[session->worker];
+    EngineAnswer item = { session_id, question_id, answer, time_taken, answered_at };
+
+    pthread_mutex_lock(&worker->lock);
+    if (worker->count == worker->capacity) {
+        int capacity = worker->capacity * 2;
+        EngineAnswer* queue = malloc(capacity * sizeof(EngineAnswer));
+        if (!queue) {
+            pthread_mutex_unlock(&worker->lock);
+            return 0;
+        }
+        for (int i = 0; i < worker->count; i++) {
+            queue[i] = worker->queue[(worker->head + i) % worker->capacity];
+        }
+        free(worker->queue);
+        worker->queue = queue;
+        worker->head = 0;
+        worker->capacity = capacity;
+    }
+    worker->queue[(worker->head + worker->count) % worker->capacity] = item;
+    worker->count++;
+    pthread_cond_signal(&worker->work_ready);
+    pthread_mutex_unlock(&worker->lock);
+    return 1;
+}
+
+// Id of the adaptive question the session should see next, or -1
+int session_engine_next_question(SessionEngine* engine, int session_id) {
+    EngineSession* session = engine_session(engine, session_id);
+    return session ? atomic_load(&session->next_question_id) : -1;
+}
+
+// Consistent once session_engine_sync has returned
+int session_engine_session_summary(SessionEngine* engine, int session_id, QuizSession* summary) {
+    EngineSession* session = engine_session(engine, session_id);
+    if (!session) {
+        return 0;
+    }
+    *summary = session->summary;
+    return 1;
+}
+
+// Merged counters for one question: the hot table plus every shard
+void session_engine_question_stats(SessionEngine* engine, int slot, QuestionStats* stats) {
+    QuestionHotTable* hot = get_question_hot_table();
+    pthread_mutex_lock(&engine->stats_lock);
+    float time_total = hot->avg_time_taken[slot] * hot->times_asked[slot];
+
+    stats->times_asked = hot->times_asked[slot];
+    stats->times_correct = hot->times_correct[slot];
+    for (int i = 0; i < engine->worker_count; i++) {
+        StatShard* shard = &engine->workers[i].shard;
+        if (slot < shard->capacity) {
+            stats->times_asked += atomic_load_explicit(&shard->times_asked[slot], memory_order_relaxed);
+            stats->times_correct += atomic_load_explicit(&shard->times_correct[slot], memory_order_relaxed);
+            time_total += atomic_load_explicit(&shard->time_sum[slot], memory_order_relaxed);
+        }
+    }
+    pthread_mutex_unlock(&engine->stats_lock);
+    stats->avg_time_taken = stats->times_asked > 0 ? time_total / stats->times_asked : 0.0f;
+}
+
+// Replaces every shard with a larger one, or none of them. Only while the
+// workers are paused and the shards have just been folded, so every counter
+// is zero and nothing is lost.
+static void grow_shards(SessionEngine* engine, int capacity) {
+    StatShard* grown = calloc(engine->worker_count, sizeof(StatShard));
+    int ok = grown && reserve_response_sketches(capacity);
+    for (int i = 0; ok && i < engine->worker_count; i++) {
+        ok = shard_init(&grown[i], capacity);
+    }
+    for (int i = 0; grown && i < engine->worker_count; i++) {
+        StatShard* retired = ok ? &engine->workers[i].shard : &grown[i];
+        shard_free(retired);
+        if (ok) {
+            engine->workers[i].shard = grown[i];
+        }
+    }
+    if (ok) {
+        engine->bank_size = capacity;
+    }
+    free(grown);
+}
+
+// Waits until every queued answer is applied, then stops the workers from
+// taking more. Answers may keep arriving; they are applied on resume.
+static void pause_workers(SessionEngine* engine) {
+    for (int i = 0; i < engine->worker_count; i++) {
+        EngineWorker* worker = &engine->workers[i];
+        pthread_mutex_lock(&worker->lock);
+        while (worker->count > 0 || worker->busy) {
+            pthread_cond_wait(&worker->idle, &worker->lock);
+        }
+        pthread_mutex_unlock(&worker->lock);
+    }
+    // Pause only once every queue has drained: a paused worker stops
+    // taking work, so pausing earlier would leave later queues stuck
+    for (int i = 0; i < engine->worker_count; i++) {
+        EngineWorker* worker = &engine->workers[i];
+        pthread_mutex_lock(&worker->lock);
+        engine->paused = 1;
+        while (worker->busy) {
+            pthread_cond_wait(&worker->idle, &worker->lock);
+        }
+        pthread_mutex_unlock(&worker->lock);
+    }
+}
+
+static void resume_workers(SessionEngine* engine) {
+    for (int i = 0; i < engine->worker_count; i++) {
+        EngineWorker* worker = &engine->workers[i];
+        pthread_mutex_lock(&worker->lock);
+        engine->paused = 0;
+        pthread_cond_signal(&worker->work_ready);
+        pthread_mutex_unlock(&worker->lock);
+    }
+}
+
+// Moves every shard counter into the hot table; workers must be paused and
+// recommend_lock held. Shard slots past the bank are never written.
+static void fold_shards_locked(SessionEngine* engine) {
+    QuestionHotTable* hot = get_question_hot_table();
+    for (int slot = 0; slot < engine->bank_size; slot++) {
+        int asked = 0;
+        int correct = 0;
+        float time_sum = 0.0f;
+        for (int i = 0; i < engine->worker_count; i++) {
+            StatShard* shard = &engine->workers[i].shard;
+            asked += atomic_exchange_explicit(&shard->times_asked[slot], 0, memory_order_relaxed);
+            correct += atomic_exchange_explicit(&shard->times_correct[slot], 0, memory_order_relaxed);
+            time_sum += atomic_exchange_explicit(&shard->time_sum[slot], 0.0f, memory_order_relaxed);
+        }
+        if (asked == 0) {
+            continue;
+        }
+        float time_total = hot->avg_time_taken[slot] * hot->times_asked[slot] + time_sum;
+        hot->times_asked[slot] += asked;
+        hot->times_correct[slot] += correct;
+        hot->avg_time_taken[slot] = time_total / hot->times_asked[slot];
+        refresh_question_recommendation(slot);
+        refresh_question_analytics(slot);
+    }
+}
+
+// Waits until every queued answer is applied, then folds the shards into
+// the hot table while the workers are paused. Answers may keep arriving;
+// they are applied after the fold.
+void session_engine_sync(SessionEngine* engine) {
+    pause_workers(engine);
+    pthread_mutex_lock(&recommend_lock);
+    fold_shards_locked(engine);
+    pthread_mutex_unlock(&recommend_lock);
+
+    // No answer is in flight, so the progress log can be compacted safely
+    if (student_progress_checkpoint_due()) {
+        checkpoint_student_progress();
+        backup_if_due();
+    }
+    resume_workers(engine);
+}
+
+// add_question for a running engine. Growing the bank moves the hot table
+// and the shards that workers write, so both happen with the workers paused;
+// calling add_question directly is only safe before the engine is created.
+// Returns the new question's id, or -1.
+int session_engine_add_question(SessionEngine* engine, const QuestionDraft* draft) {
+    pause_workers(engine);
+    pthread_mutex_lock(&recommend_lock);
+    fold_shards_locked(engine);
+    int id = -1;
+    QuestionHotTable* hot = get_question_hot_table();
+    pthread_mutex_lock(&engine->stats_lock);
+    if (hot->count >= engine->bank_size) {
+        grow_shards(engine, hot->count + 1);
+    }
+    // Shards that could not grow would have no room for the new slot
+    if (hot->count < engine->bank_size) {
+        id = add_question(draft);
+    }
+    pthread_mutex_unlock(&engine->stats_lock);
+    pthread_mutex_unlock(&recommend_lock);
+    resume_workers(engine);
+    return id;
+}
+
+// Applies every queued answer, folds the statistics and stops the workers
+void session_engine_destroy(SessionEngine* engine) {
+    if (!engine) {
+        return;
+    }
+    if (engine->workers && engine->worker_count > 0) {
+        session_engine_sync(engine);
+    }
+    for (int i = 0; engine->workers && i < engine->worker_count; i++) {
+        EngineWorker* worker = &engine->workers[i];
+        pthread_mutex_lock(&worker->lock);
+        engine->stopping = 1;
+        pthread_cond_signal(&worker->work_ready);
+        pthread_mutex_unlock(&worker->lock);
+        pthread_join(worker->thread, NULL);
+    }
+    for (int i = 0; engine->workers && i < engine->worker_count; i++) {
+        EngineWorker* worker = &engine->workers[i];
+        shard_free(&worker->shard);
+        free(worker->queue);
+        pthread_mutex_destroy(&worker->lock);
+        pthread_cond_destroy(&worker->work_ready);
+        pthread_cond_destroy(&worker->idle);
+    }
+    free(engine->workers);
+    chunked_array_free(&engine->sessions);
+    pthread_mutex_destroy(&engine->sessions_lock);
+    pthread_mutex_destroy(&engine->stats_lock);
+    free(engine);
+}
@@ -0,0 +1,434 @@
+// quiz_exam.c - Exam assembly for the C Programming Quiz System
+// Turns a blueprint (questions per topic and difficulty, a time budget)
+// into a plan of prebuilt alias tables, so each exam variant is drawn in
+// O(k) without retries. Plans are read-only once built and can be sampled
+// from any number of threads, each with its own random state.
+
+#include "quiz_system.h"
+
+#include <ctype.h>
+
+#define EXAM_BUDGET_ATTEMPTS 16    // draws tried to fit the time budget
+#define EXAM_DEFAULT_SECONDS 20.0f // expected time per difficulty step for unanswered questions
+
+// ============================================================================
+// INTERVIEW PROFILES
+// ============================================================================
+
+static const InterviewProfile interview_profiles[] = {
+    { "Embedded Systems", 3,
+      { "Pointers & Memory", "Operators & Expressions", "Structures & Unions", "Preprocessor Directives",
+        "Dynamic Memory Management" },
+      15, 30 },
+    { "Systems Programming", 4,
+      { "Pointers & Memory", "Dynamic Memory Management", "File Input/Output", "Advanced C Concepts",
+        "Functions & Recursion" },
+      20, 40 },
+    { "Game Engine", 4,
+      { "Pointers & Memory", "Arrays & Strings", "Structures & Unions", "Dynamic Memory Management",
+        "Advanced C Concepts" },
+      15, 30 },
+    { "Startup Generalist", 2,
+      { "C Basics & Syntax", "Control Structures", "Functions & Recursion", "Arrays & Strings",
+        "Pointers & Memory" },
+      10, 20 },
+};
+
+#define NUM_INTERVIEW_PROFILES ((int)(sizeof(interview_profiles) / sizeof(interview_profiles[0])))
+
+int get_interview_profiles(const InterviewProfile** profiles) {
+    *profiles = interview_profiles;
+    return NUM_INTERVIEW_PROFILES;
+}
+
+// Case-insensitive match on the profile name; NULL if none
+const InterviewProfile* find_interview_profile(const char* company) {
+    for (int p = 0; p < NUM_INTERVIEW_PROFILES; p++) {
+        const char* a = interview_profiles[p].company_name;
+        const char* b = company;
+        while (*a && tolower((unsigned char)*a) == tolower((unsigned char)*b)) {
+            a++;
+            b++;
+        }
+        if (*a == '\0' && *b == '\0') {
+            return &interview_profiles[p];
+        }
+    }
+    return NULL;
+}
+
+// Topics named in focus_areas; unknown names are skipped
+int get_profile_topics(const InterviewProfile* profile, TopicIndex* topics) {
+    int count = 0;
+    for (int f = 0; f < 5; f++) {
+        for (int t = 0; t < NUM_C_TOPICS; t++) {
+            if (strcmp(profile->focus_areas[f], c_topic_names[t]) == 0) {
+                topics[count++] = (TopicIndex)t;
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// BLUEPRINTS
+// ============================================================================
+
+// Share of an exam at each difficulty, per skill level
+static const float difficulty_mix[4][MAX_DIFFICULTY] = {
+    { 0.4f, 0.4f, 0.2f, 0.0f, 0.0f }, // Beginner
+    { 0.1f, 0.3f, 0.4f, 0.2f, 0.0f }, // Intermediate
+    { 0.0f, 0.1f, 0.3f, 0.4f, 0.2f }, // Advanced
+    { 0.0f, 0.0f, 0.2f, 0.4f, 0.4f }, // Expert
+};
+
+// Puts one more question at `difficulty` in the next topic, round robin,
+// that still has an unused question there
+static int place_question(ExamBlueprint* blueprint, const TopicIndex* topics, int topic_count, int difficulty,
+                          int* rotor) {
+    for (int i = 0; i < topic_count; i++) {
+        TopicIndex topic = topics[(*rotor + i) % topic_count];
+        int available;
+        get_question_bucket(topic, difficulty + 1, &available);
+        if (blueprint->counts[topic][difficulty] < available) {
+            blueprint->counts[topic][difficulty]++;
+            *rotor = (*rotor + i + 1) % topic_count;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Spreads num_questions over `topics` (every topic if topic_count is 0)
+// with the level's difficulty mix. Where the bank runs short, questions
+// move to the nearest difficulty that has some left. Returns the number
+// placed, which is less than asked only if the topics run out entirely.
+int exam_blueprint_for_level(ExamBlueprint* blueprint, SkillLevel level, int num_questions,
+                             const TopicIndex* topics, int topic_count) {
+    memset(blueprint, 0, sizeof(ExamBlueprint));
+    TopicIndex all_topics[NUM_C_TOPICS];
+    if (!topics || topic_count <= 0) {
+        for (int t = 0; t < NUM_C_TOPICS; t++) {
+            all_topics[t] = (TopicIndex)t;
+        }
+        topics = all_topics;
+        topic_count = NUM_C_TOPICS;
+    }
+    const float* mix = difficulty_mix[(level >= BEGINNER && level <= EXPERT ? level : BEGINNER) - 1];
+    num_questions = num_questions < EXAM_MAX_QUESTIONS ? num_questions : EXAM_MAX_QUESTIONS;
+
+    // Largest remainder split across difficulties
+    int targets[MAX_DIFFICULTY];
+    float remainders[MAX_DIFFICULTY];
+    int assigned = 0;
+    for (int d = 0; d < MAX_DIFFICULTY; d++) {
+        float share = mix[d] * num_questions;
+        targets[d] = (int)share;
+        remainders[d] = share - targets[d];
+        assigned += targets[d];
+    }
+    for (; assigned < num_questions; assigned++) {
+        int best = 0;
+        for (int d = 1; d < MAX_DIFFICULTY; d++) {
+            best = remainders[d] > remainders[best] ? d : best;
+        }
+        targets[best]++;
+        remainders[best] = -1.0f;
+    }
+
+    // Overflow goes to difficulties in order of preference: heaviest in the
+    // mix first, then closest to the level's peak
+    int peak = 0;
+    for (int d = 1; d < MAX_DIFFICULTY; d++) {
+        peak = mix[d] > mix[peak] ? d : peak;
+    }
+    int preference[MAX_DIFFICULTY];
+    for (int d = 0; d < MAX_DIFFICULTY; d++) {
+        preference[d] = d;
+    }
+    for (int i = 1; i < MAX_DIFFICULTY; i++) {
+        for (int j = i; j > 0; j--) {
+            int a = preference[j - 1];
+            int b = preference[j];
+            int b_first = mix[b] > mix[a] || (mix[b] == mix[a] && abs(b - peak) < abs(a - peak));
+            if (!b_first) {
+                break;
+            }
+            preference[j - 1] = b;
+            preference[j] = a;
+        }
+    }
+
+    int rotor = 0;
+    int placed = 0;
+    int overflow = 0;
+    for (int d = 0; d < MAX_DIFFICULTY; d++) {
+        for (int i = 0; i < targets[d]; i++) {
+            int ok = place_question(blueprint, topics, topic_count, d, &rotor);
+            placed += ok;
+            overflow += !ok;
+        }
+    }
+    for (int p = 0; p < MAX_DIFFICULTY && overflow > 0; p++) {
+        while (overflow > 0 && place_question(blueprint, topics, topic_count, preference[p], &rotor)) {
+            placed++;
+            overflow--;
+        }
+    }
+    return placed;
+}
+
+// ============================================================================
+// EXAM PLANS
+// ============================================================================
+
+// One (topic, difficulty) cell: its candidates and a Vose alias table over
+// them. Questions asked less often than their neighbours weigh more, so
+// exposure evens out across many variants.
+typedef struct {
+    int count; // questions drawn from this cell
+    int pool;
+    int* slots;
+    float* seconds; // expected answering time per candidate
+    float* probability;
+    int* alias;
+} ExamCell;
+
+struct ExamPlan {
+    unsigned int generation;
+    int total;
+    float time_budget;
+    int cell_count;
+    ExamCell cells[NUM_C_TOPICS * MAX_DIFFICULTY];
+};
+
+static int build_alias_table(ExamCell* cell, const float* weights) {
+    int* small = malloc(cell->pool * sizeof(int));
+    int* large = malloc(cell->pool * sizeof(int));
+    float* scaled = malloc(cell->pool * sizeof(float));
+    if (!small || !large || !scaled) {
+        free(small);
+        free(large);
+        free(scaled);
+        return 0;
+    }
+
+    double sum = 0.0;
+    for (int i = 0; i < cell->pool; i++) {
+        sum += weights[i];
+    }
+    int small_count = 0;
+    int large_count = 0;
+    for (int i = 0; i < cell->pool; i++) {
+        scaled[i] = (float)(weights[i] * cell->pool / sum);
+        if (scaled[i] < 1.0f) {
+            small[small_count++] = i;
+        } else {
+            large[large_count++] = i;
+        }
+    }
+    while (small_count > 0 && large_count > 0) {
+        int s = small[--small_count];
+        int l = large[large_count - 1];
+        cell->probability[s] = scaled[s];
+        cell->alias[s] = l;
+        scaled[l] -= 1.0f - scaled[s];
+        if (scaled[l] < 1.0f) {
+            large_count--;
+            small[small_count++] = l;
+        }
+    }
+    // Whatever is left is 1 up to rounding
+    while (large_count > 0) {
+        int l = large[--large_count];
+        cell->probability[l] = 1.0f;
+        cell->alias[l] = l;
+    }
+    while (small_count > 0) {
+        int s = small[--small_count];
+        cell->probability[s] = 1.0f;
+        cell->alias[s] = s;
+    }
+
+    free(small);
+    free(large);
+    free(scaled);
+    return 1;
+}
+
+void exam_plan_free(ExamPlan* plan) {
+    if (!plan) {
+        return;
+    }
+    for (int c = 0; c < plan->cell_count; c++) {
+        free(plan->cells[c].slots);
+    }
+    free(plan);
+}
+
+// Precomputes everything sampling needs. Returns NULL if the bank cannot
+// fill the blueprint or memory runs out. A plan only draws from questions
+// present when it was built, and stops working once the bank is reloaded.
+ExamPlan* exam_plan_build(const ExamBlueprint* blueprint) {
+    ExamPlan* plan = calloc(1, sizeof(ExamPlan));
+    if (!plan) {
+        return NULL;
+    }
+    plan->generation = question_store_generation();
+    plan->time_budget = blueprint->time_budget_seconds;
+    QuestionHotTable* hot = get_question_hot_table();
+
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        for (int d = 0; d < MAX_DIFFICULTY; d++) {
+            int count = blueprint->counts[t][d];
+            if (count <= 0) {
+                continue;
+            }
+            int pool;
+            const int* slots = get_question_bucket((TopicIndex)t, d + 1, &pool);
+            if (pool < count || plan->total + count > EXAM_MAX_QUESTIONS) {
+                exam_plan_free(plan);
+                return NULL;
+            }
+
+            // One block per cell: slots, alias, seconds, probability, weights
+            ExamCell* cell = &plan->cells[plan->cell_count++];
+            cell->count = count;
+            cell->pool = pool;
+            cell->slots = malloc((size_t)pool * (2 * sizeof(int) + 3 * sizeof(float)));
+            if (!cell->slots) {
+                exam_plan_free(plan);
+                return NULL;
+            }
+            cell->alias = cell->slots + pool;
+            cell->seconds = (float*)(cell->alias + pool);
+            cell->probability = cell->seconds + pool;
+            float* weights = cell->probability + pool;
+            memcpy(cell->slots, slots, pool * sizeof(int));
+
+            double asked = 0.0;
+            for (int i = 0; i < pool; i++) {
+                asked += hot->times_asked[slots[i]];
+            }
+            float typical = (float)(asked / pool) + 1.0f;
+            for (int i = 0; i < pool; i++) {
+                int slot = slots[i];
+                weights[i] = 1.0f / (1.0f + hot->times_asked[slot] / typical);
+                cell->seconds[i] = hot->times_asked[slot] > 0 ? hot->avg_time_taken[slot]
+                                                              : EXAM_DEFAULT_SECONDS * (d + 1);
+            }
+            if (!build_alias_table(cell, weights)) {
+                exam_plan_free(plan);
+                return NULL;
+            }
+            plan->total += count;
+        }
+    }
+    return plan;
+}
+
+int exam_plan_size(const ExamPlan* plan) {
+    return plan->total;
+}
+
+// xorshift64*; the state must not be 0
+static uint64_t exam_random(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ull;
+}
+
+static int bounded(uint64_t* state, int n) {
+    return (int)(((exam_random(state) >> 32) * (uint64_t)n) >> 32);
+}
+
+// Draws one variant into slots[0..total); returns its expected seconds
+static float draw_variant(const ExamPlan* plan, uint64_t* state, int* slots) {
+    float seconds = 0.0f;
+    int n = 0;
+    for (int c = 0; c < plan->cell_count; c++) {
+        const ExamCell* cell = &plan->cells[c];
+        int first = n;
+        if (cell->count * 4 <= cell->pool) {
+            // Sparse: alias draws, redrawing the rare repeat
+            while (n < first + cell->count) {
+                uint64_t r = exam_random(state);
+                int i = (int)(((r >> 32) * (uint64_t)cell->pool) >> 32);
+                if ((float)(uint32_t)r * (1.0f / 4294967296.0f) >= cell->probability[i]) {
+                    i = cell->alias[i];
+                }
+                int repeat = 0;
+                for (int j = first; j < n; j++) {
+                    repeat |= slots[j] == i;
+                }
+                if (!repeat) {
+                    slots[n++] = i;
+                }
+            }
+        } else {
+            // Dense: a partial shuffle of the small pool, unweighted
+            int order[4 * EXAM_MAX_QUESTIONS];
+            for (int i = 0; i < cell->pool; i++) {
+                order[i] = i;
+            }
+            for (int i = 0; i < cell->count; i++) {
+                int j = i + bounded(state, cell->pool - i);
+                int swap = order[i];
+                order[i] = order[j];
+                order[j] = swap;
+                slots[n++] = order[i];
+            }
+        }
+        // Candidate indexes become slots
+        for (int j = first; j < n; j++) {
+            seconds += cell->seconds[slots[j]];
+            slots[j] = cell->slots[slots[j]];
+        }
+    }
+    return seconds;
+}
+
+// Draws an exam that matches the blueprint with no repeated question, in
+// random order, into question_ids (room for exam_plan_size). With a time
+// budget, the first of a few draws that fits is kept, else the quickest.
+// `state` is the caller's random state (nonzero). Returns the number of
+// questions, or -1 if the bank was reloaded since the plan was built.
+int exam_plan_sample(const ExamPlan* plan, uint64_t* state, int* question_ids, float* expected_seconds) {
+    TRACE_SCOPE(TRACE_EXAM_SAMPLE);
+    if (plan->generation != question_store_generation()) {
+        return -1;
+    }
+    if (*state == 0) {
+        *state = 0x9E3779B97F4A7C15ull;
+    }
+
+    int best[EXAM_MAX_QUESTIONS];
+    int draw[EXAM_MAX_QUESTIONS];
+    float best_seconds = draw_variant(plan, state, best);
+    for (int attempt = 1; plan->time_budget > 0 && best_seconds > plan->time_budget && attempt < EXAM_BUDGET_ATTEMPTS;
+         attempt++) {
+        float seconds = draw_variant(plan, state, draw);
+        if (seconds < best_seconds) {
+            best_seconds = seconds;
+            memcpy(best, draw, plan->total * sizeof(int));
+        }
+    }
+
+    // Shuffle so topics and difficulties interleave
+    for (int i = plan->total - 1; i > 0; i--) {
+        int j = bounded(state, i + 1);
+        int swap = best[i];
+        best[i] = best[j];
+        best[j] = swap;
+    }
+    QuestionHotTable* hot = get_question_hot_table();
+    for (int i = 0; i < plan->total; i++) {
+        question_ids[i] = hot->id[best[i]];
+    }
+    if (expected_seconds) {
+        *expected_seconds = best_seconds;
+    }
+    return plan->total;
+}
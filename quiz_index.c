@@ -0,0 +1,189 @@
+// quiz_index.c - Question indexes for the C Programming Quiz System
+// Maintains the id -> slot hash index and the (topic, difficulty) posting
+// lists so lookups and candidate selection never scan the bank
+
+#include "quiz_system.h"
+
+// ============================================================================
+// ID MAP
+// ============================================================================
+
+// Open-addressing map from int keys to int values with linear probing.
+// INT32_MIN marks a free slot and cannot be used as a key.
+#define ID_MAP_EMPTY INT32_MIN
+#define ID_MAP_INITIAL_CAPACITY 1024
+
+static uint32_t id_map_hash(int key, int capacity) {
+    return ((uint32_t)key * 2654435761u) & (uint32_t)(capacity - 1);
+}
+
+void id_map_init(IdMap* map) {
+    memset(map, 0, sizeof(IdMap));
+}
+
+static int id_map_grow(IdMap* map) {
+    int capacity = map->capacity ? map->capacity * 2 : ID_MAP_INITIAL_CAPACITY;
+    int* keys = malloc(capacity * sizeof(int));
+    int* values = malloc(capacity * sizeof(int));
+    if (!keys || !values) {
+        free(keys);
+        free(values);
+        return 0;
+    }
+    for (int i = 0; i < capacity; i++) {
+        keys[i] = ID_MAP_EMPTY;
+    }
+
+    for (int i = 0; i < map->capacity; i++) {
+        if (map->keys[i] == ID_MAP_EMPTY) {
+            continue;
+        }
+        uint32_t pos = id_map_hash(map->keys[i], capacity);
+        while (keys[pos] != ID_MAP_EMPTY) {
+            pos = (pos + 1) & (uint32_t)(capacity - 1);
+        }
+        keys[pos] = map->keys[i];
+        values[pos] = map->values[i];
+    }
+
+    free(map->keys);
+    free(map->values);
+    map->keys = keys;
+    map->values = values;
+    map->capacity = capacity;
+    return 1;
+}
+
+// Inserts or replaces; returns 0 when out of memory or for the reserved key
+int id_map_put(IdMap* map, int key, int value) {
+    if (key == ID_MAP_EMPTY) {
+        return 0;
+    }
+    if ((map->count + 1) * 2 > map->capacity && !id_map_grow(map)) {
+        return 0;
+    }
+    uint32_t pos = id_map_hash(key, map->capacity);
+    while (map->keys[pos] != ID_MAP_EMPTY && map->keys[pos] != key) {
+        pos = (pos + 1) & (uint32_t)(map->capacity - 1);
+    }
+    if (map->keys[pos] == ID_MAP_EMPTY) {
+        map->keys[pos] = key;
+        map->count++;
+    }
+    map->values[pos] = value;
+    return 1;
+}
+
+// Returns the value stored for key, or -1
+int id_map_get(const IdMap* map, int key) {
+    if (map->count == 0) {
+        return -1;
+    }
+    uint32_t pos = id_map_hash(key, map->capacity);
+    while (map->keys[pos] != ID_MAP_EMPTY) {
+        if (map->keys[pos] == key) {
+            return map->values[pos];
+        }
+        pos = (pos + 1) & (uint32_t)(map->capacity - 1);
+    }
+    return -1;
+}
+
+void id_map_free(IdMap* map) {
+    free(map->keys);
+    free(map->values);
+    id_map_init(map);
+}
+
+// ============================================================================
+// QUESTION INDEXES
+// ============================================================================
+
+typedef struct {
+    int* slots;
+    int count;
+    int capacity;
+} PostingList;
+
+// Maintained eagerly by the writers (index_new_question and the store's
+// load and reset paths), so every lookup below is read-only and safe to run
+// from any number of threads while the bank is not being changed
+static IdMap question_ids;
+static PostingList buckets[NUM_C_TOPICS][MAX_DIFFICULTY];
+static int topic_counts[NUM_C_TOPICS];
+static int max_question_id = -1;
+
+static int posting_append(PostingList* list, int slot) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 64;
+        int* slots = realloc(list->slots, capacity * sizeof(int));
+        if (!slots) {
+            return 0;
+        }
+        list->slots = slots;
+        list->capacity = capacity;
+    }
+    list->slots[list->count++] = slot;
+    return 1;
+}
+
+static void clear_question_indexes(void) {
+    id_map_free(&question_ids);
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        for (int d = 0; d < MAX_DIFFICULTY; d++) {
+            buckets[t][d].count = 0;
+        }
+        topic_counts[t] = 0;
+    }
+    max_question_id = -1;
+}
+
+// Adds the question stored in `slot`; called once per appended question
+void index_new_question(int slot) {
+    QuestionHotTable* hot = get_question_hot_table();
+    int topic = hot->topic[slot];
+    int difficulty = hot->difficulty[slot];
+
+    id_map_put(&question_ids, hot->id[slot], slot);
+    if (hot->id[slot] > max_question_id) {
+        max_question_id = hot->id[slot];
+    }
+    if (topic < NUM_C_TOPICS && difficulty >= 1 && difficulty <= MAX_DIFFICULTY) {
+        posting_append(&buckets[topic][difficulty - 1], slot);
+        topic_counts[topic]++;
+    }
+}
+
+// Starts over from the store's current contents, after a load or reset
+void rebuild_question_indexes(void) {
+    clear_question_indexes();
+    QuestionHotTable* hot = get_question_hot_table();
+    for (int slot = 0; slot < hot->count; slot++) {
+        index_new_question(slot);
+    }
+}
+
+// Returns the slot of the question with this id, or -1
+int find_question_slot(int id) {
+    return id_map_get(&question_ids, id);
+}
+
+int next_question_id(void) {
+    return max_question_id + 1;
+}
+
+// Slots of every question in one (topic, difficulty) bucket. The array is
+// owned by the index and valid until the next question is added.
+const int* get_question_bucket(TopicIndex topic, int difficulty, int* count) {
+    if (topic < 0 || topic >= NUM_C_TOPICS || difficulty < 1 || difficulty > MAX_DIFFICULTY) {
+        *count = 0;
+        return NULL;
+    }
+    PostingList* list = &buckets[topic][difficulty - 1];
+    *count = list->count;
+    return list->slots;
+}
+
+int count_questions_in_topic(TopicIndex topic) {
+    return topic >= 0 && topic < NUM_C_TOPICS ? topic_counts[topic] : 0;
+}
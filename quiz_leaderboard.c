@@ -0,0 +1,436 @@
+// quiz_leaderboard.c - Live leaderboards for the C Programming Quiz System
+// Keeps students ranked by experience points and by each topic score in
+// order-statistic trees, so answers re-rank a student in O(log n) and rank
+// and top-N queries never sort the registry. Also awards achievements.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "quiz_system.h"
+#include <pthread.h>
+
+// ============================================================================
+// EXPERIENCE POINTS
+// ============================================================================
+
+#define XP_PER_CORRECT 10
+#define XP_PER_ATTEMPT 2
+#define XP_PER_STREAK_STEP 5
+#define XP_PER_ACHIEVEMENT 100
+
+int calculate_experience_points(Student* student) {
+    return student->total_questions_correct * XP_PER_CORRECT +
+           student->total_questions_attempted * XP_PER_ATTEMPT +
+           student->max_streak * XP_PER_STREAK_STEP +
+           __builtin_popcount(student->achievements) * XP_PER_ACHIEVEMENT;
+}
+
+// ============================================================================
+// ACHIEVEMENTS
+// ============================================================================
+
+#define TOPIC_MASTER_SCORE 0.9f
+#define TOPIC_MASTER_ANSWERS 10
+#define PERFECT_SCORE_ANSWERS 5
+#define SPEED_DEMON_SECONDS 10.0f
+#define PERSISTENT_LEARNER_DAYS 7
+#define INTERVIEW_READY_SCORE 80
+
+static const char* achievement_names[NUM_ACHIEVEMENTS] = {
+    "First Quiz", "Perfect Score", "5 in a Row", "10 in a Row", "Topic Master",
+    "Speed Demon", "Persistent Learner", "Code Reviewer", "Interview Ready", "C Expert"
+};
+
+static const char* achievement_descriptions[NUM_ACHIEVEMENTS] = {
+    "Answer your first question",
+    "Get every question right in a quiz of 5 or more",
+    "Answer 5 questions in a row correctly",
+    "Answer 10 questions in a row correctly",
+    "Reach 90% mastery in a topic over 10+ answers",
+    "Average under 10s a question in a quiz with 80%+ accuracy",
+    "Practice 7 days in a row",
+    "Review code for the question bank",
+    "Reach an interview readiness score of 80",
+    "Reach Expert level"
+};
+
+int has_achievement(const Student* student, AchievementType achievement) {
+    return (student->achievements >> achievement) & 1u;
+}
+
+// Evaluates every achievement as one mask: each test is a comparison
+// shifted into its bit, so there is no per-achievement branching and
+// already earned ones cost nothing extra. CODE_REVIEWER is awarded by
+// hand. Announces and returns the newly earned bits.
+uint32_t check_achievements(Student* student, QuizSession* session) {
+    uint32_t topic_master = 0;
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        topic_master |= (uint32_t)(student->topic_scores[t] >= TOPIC_MASTER_SCORE) &
+                        (uint32_t)(student->topic_questions_attempted[t] >= TOPIC_MASTER_ANSWERS);
+    }
+    uint32_t perfect = 0;
+    uint32_t fast = 0;
+    if (session) {
+        uint32_t long_enough = session->questions_attempted >= PERFECT_SCORE_ANSWERS;
+        perfect = long_enough & (uint32_t)(session->questions_correct == session->questions_attempted);
+        fast = long_enough & (uint32_t)(session->avg_response_time < SPEED_DEMON_SECONDS) &
+               (uint32_t)(session->session_accuracy >= 0.8f);
+    }
+
+    uint32_t earned =
+        (uint32_t)(student->total_questions_attempted > 0) << ACHIEVEMENT_FIRST_QUIZ |
+        perfect << ACHIEVEMENT_PERFECT_SCORE |
+        (uint32_t)(student->max_streak >= 5) << ACHIEVEMENT_STREAK_5 |
+        (uint32_t)(student->max_streak >= 10) << ACHIEVEMENT_STREAK_10 |
+        topic_master << ACHIEVEMENT_TOPIC_MASTER |
+        fast << ACHIEVEMENT_SPEED_DEMON |
+        (uint32_t)(get_practice_streak(student->student_id, time(NULL)) >= PERSISTENT_LEARNER_DAYS)
+            << ACHIEVEMENT_PERSISTENT_LEARNER |
+        (uint32_t)(student->interview_ready_score >= INTERVIEW_READY_SCORE) << ACHIEVEMENT_INTERVIEW_READY |
+        (uint32_t)(student->current_level == EXPERT) << ACHIEVEMENT_C_EXPERT;
+
+    uint32_t fresh = earned & ~student->achievements;
+    student->achievements |= earned;
+    for (uint32_t bits = fresh; bits; bits &= bits - 1) {
+        display_achievement_earned((AchievementType)__builtin_ctz(bits));
+    }
+    if (fresh) {
+        update_leaderboard(student, session ? (int)session->primary_topic : LEADERBOARD_OVERALL);
+    }
+    return fresh;
+}
+
+void display_achievement_earned(AchievementType achievement) {
+    printf("🏅 Achievement unlocked: %s - %s\n", achievement_names[achievement],
+           achievement_descriptions[achievement]);
+}
+
+void display_achievements(Student* student) {
+    printf("\n🏅 Achievements (%d/%d)\n", __builtin_popcount(student->achievements), NUM_ACHIEVEMENTS);
+    for (int a = 0; a < NUM_ACHIEVEMENTS; a++) {
+        printf("   %s %-20s %s\n", has_achievement(student, (AchievementType)a) ? "✅" : "⬜", achievement_names[a],
+               achievement_descriptions[a]);
+    }
+}
+
+// qsort order for students: most experience first, then lowest id
+int compare_students(const void* a, const void* b) {
+    Student* left = (Student*)a;
+    Student* right = (Student*)b;
+    int xp_left = calculate_experience_points(left);
+    int xp_right = calculate_experience_points(right);
+    if (xp_left != xp_right) {
+        return xp_left > xp_right ? -1 : 1;
+    }
+    return (left->student_id > right->student_id) - (left->student_id < right->student_id);
+}
+
+// ============================================================================
+// RANK TREES
+// ============================================================================
+
+// A treap over parallel node arrays, ordered by score descending and then
+// id ascending so every key is unique. Each node stores its subtree size,
+// which turns rank and k-th queries into one root-to-leaf walk. An id keeps
+// its node for life; a score change unlinks and relinks it.
+
+static int ranks_before(const RankTree* tree, int node, double score, int id) {
+    if (tree->score[node] != score) {
+        return tree->score[node] > score;
+    }
+    return tree->id[node] < id;
+}
+
+static int subtree_size(const RankTree* tree, int node) {
+    return node < 0 ? 0 : tree->size[node];
+}
+
+static void update_size(RankTree* tree, int node) {
+    tree->size[node] = 1 + subtree_size(tree, tree->left[node]) + subtree_size(tree, tree->right[node]);
+}
+
+// Splits into nodes ranked before (score, id) and the rest
+static void split(RankTree* tree, int node, double score, int id, int* before, int* after) {
+    if (node < 0) {
+        *before = *after = -1;
+        return;
+    }
+    if (ranks_before(tree, node, score, id)) {
+        split(tree, tree->right[node], score, id, &tree->right[node], after);
+        *before = node;
+    } else {
+        split(tree, tree->left[node], score, id, before, &tree->left[node]);
+        *after = node;
+    }
+    update_size(tree, node);
+}
+
+// Joins two trees where every node of `first` ranks before `second`
+static int merge(RankTree* tree, int first, int second) {
+    if (first < 0 || second < 0) {
+        return first < 0 ? second : first;
+    }
+    if (tree->priority[first] > tree->priority[second]) {
+        tree->right[first] = merge(tree, tree->right[first], second);
+        update_size(tree, first);
+        return first;
+    }
+    tree->left[second] = merge(tree, first, tree->left[second]);
+    update_size(tree, second);
+    return second;
+}
+
+static uint32_t next_priority(void) {
+    static uint32_t state = 2463534242u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static int rank_tree_grow(RankTree* tree) {
+    int capacity = tree->capacity ? tree->capacity * 2 : 256;
+    void** columns[] = { (void**)&tree->score, (void**)&tree->id, (void**)&tree->left,
+                         (void**)&tree->right, (void**)&tree->size, (void**)&tree->priority };
+    size_t sizes[] = { sizeof(double), sizeof(int), sizeof(int), sizeof(int), sizeof(int), sizeof(uint32_t) };
+    for (int i = 0; i < 6; i++) {
+        void* column = realloc(*columns[i], capacity * sizes[i]);
+        if (!column) {
+            return 0;
+        }
+        *columns[i] = column;
+    }
+    tree->capacity = capacity;
+    return 1;
+}
+
+// Detaches the node with this exact key; it must be in the tree
+static void rank_tree_unlink(RankTree* tree, int node) {
+    int before, rest, after;
+    split(tree, tree->root, tree->score[node], tree->id[node], &before, &rest);
+    // `rest` starts with the node itself, the lowest-ranked key in it
+    int single;
+    split(tree, rest, tree->score[node], tree->id[node] + 1, &single, &after);
+    tree->root = merge(tree, before, after);
+}
+
+static void rank_tree_link(RankTree* tree, int node) {
+    int before, after;
+    tree->left[node] = tree->right[node] = -1;
+    tree->size[node] = 1;
+    split(tree, tree->root, tree->score[node], tree->id[node], &before, &after);
+    tree->root = merge(tree, merge(tree, before, node), after);
+}
+
+void rank_tree_init(RankTree* tree) {
+    memset(tree, 0, sizeof(RankTree));
+    tree->root = -1;
+}
+
+void rank_tree_free(RankTree* tree) {
+    free(tree->score);
+    free(tree->id);
+    free(tree->left);
+    free(tree->right);
+    free(tree->size);
+    free(tree->priority);
+    id_map_free(&tree->nodes);
+    rank_tree_init(tree);
+}
+
+// Inserts the id or moves it to its new score
+void rank_tree_set(RankTree* tree, int id, double score) {
+    if (tree->count == 0) {
+        tree->root = -1; // zero-initialised trees are empty too
+    }
+    int node = id_map_get(&tree->nodes, id);
+    if (node >= 0) {
+        if (tree->score[node] == score) {
+            return;
+        }
+        rank_tree_unlink(tree, node);
+    } else {
+        if (tree->count == tree->capacity && !rank_tree_grow(tree)) {
+            return;
+        }
+        node = tree->count++;
+        tree->id[node] = id;
+        tree->priority[node] = next_priority();
+        id_map_put(&tree->nodes, id, node);
+    }
+    tree->score[node] = score;
+    rank_tree_link(tree, node);
+}
+
+// 1-based position of the id, or 0 if it is not in the tree
+int rank_tree_rank(const RankTree* tree, int id) {
+    int target = id_map_get(&tree->nodes, id);
+    if (target < 0) {
+        return 0;
+    }
+    int rank = 0;
+    int node = tree->root;
+    while (node >= 0) {
+        if (node == target) {
+            return rank + subtree_size(tree, tree->left[node]) + 1;
+        }
+        if (ranks_before(tree, node, tree->score[target], id)) {
+            rank += subtree_size(tree, tree->left[node]) + 1;
+            node = tree->right[node];
+        } else {
+            node = tree->left[node];
+        }
+    }
+    return 0;
+}
+
+// In-order walk that stops after max entries
+static void rank_tree_collect(const RankTree* tree, int node, int* ids, float* scores, int max, int* count) {
+    if (node < 0 || *count >= max) {
+        return;
+    }
+    rank_tree_collect(tree, tree->left[node], ids, scores, max, count);
+    if (*count < max) {
+        ids[*count] = tree->id[node];
+        if (scores) {
+            scores[*count] = (float)tree->score[node];
+        }
+        (*count)++;
+        rank_tree_collect(tree, tree->right[node], ids, scores, max, count);
+    }
+}
+
+// The best max entries in rank order; scores may be NULL. Returns how many.
+int rank_tree_top(const RankTree* tree, int* ids, float* scores, int max) {
+    int count = 0;
+    if (tree->count > 0) {
+        rank_tree_collect(tree, tree->root, ids, scores, max, &count);
+    }
+    return count;
+}
+
+int rank_tree_size(const RankTree* tree) {
+    return tree->count > 0 ? subtree_size(tree, tree->root) : 0;
+}
+
+// ============================================================================
+// LEADERBOARDS
+// ============================================================================
+
+// Index 0 ranks experience points; index 1 + t ranks topic t among students
+// who have attempted it
+#define LEADERBOARD_COUNT (NUM_C_TOPICS + 1)
+
+// Each answer re-ranks only the student who gave it, on that student's own
+// thread; register_student ranks every student as it enters the registry,
+// so loaded and replayed students are on the boards before any answer
+static pthread_mutex_t leaderboard_lock = PTHREAD_MUTEX_INITIALIZER;
+static RankTree leaderboards[LEADERBOARD_COUNT];
+static int leaderboards_ready = 0;
+
+static void init_leaderboards_locked(void) {
+    if (!leaderboards_ready) {
+        for (int i = 0; i < LEADERBOARD_COUNT; i++) {
+            rank_tree_init(&leaderboards[i]);
+        }
+        leaderboards_ready = 1;
+    }
+}
+
+// Re-ranks a student after an answer in `topic` (or every topic if topic < 0).
+// Reads only this student, so callers must own it, as its worker does.
+void update_leaderboard(Student* student, int topic) {
+    pthread_mutex_lock(&leaderboard_lock);
+    init_leaderboards_locked();
+    rank_tree_set(&leaderboards[0], student->student_id, calculate_experience_points(student));
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        if ((topic < 0 || t == topic) && student->topic_questions_attempted[t] > 0) {
+            rank_tree_set(&leaderboards[1 + t], student->student_id, student->topic_scores[t]);
+        }
+    }
+    pthread_mutex_unlock(&leaderboard_lock);
+}
+
+// 1-based rank overall (topic = LEADERBOARD_OVERALL) or within a topic;
+// 0 if the student is not on that board
+int get_leaderboard_rank(int student_id, int topic) {
+    if (topic < LEADERBOARD_OVERALL || topic >= NUM_C_TOPICS) {
+        return 0;
+    }
+    pthread_mutex_lock(&leaderboard_lock);
+    init_leaderboards_locked();
+    int rank = rank_tree_rank(&leaderboards[topic + 1], student_id);
+    pthread_mutex_unlock(&leaderboard_lock);
+    return rank;
+}
+
+// Fills entries with the best max_entries students; returns how many
+int get_leaderboard_top(int topic, LeaderboardEntry* entries, int max_entries) {
+    if (topic < LEADERBOARD_OVERALL || topic >= NUM_C_TOPICS) {
+        return 0;
+    }
+    int* ids = malloc(((size_t)max_entries + 1) * sizeof(int));
+    float* scores = malloc(((size_t)max_entries + 1) * sizeof(float));
+    int count = 0;
+    if (ids && scores) {
+        pthread_mutex_lock(&leaderboard_lock);
+        init_leaderboards_locked();
+        count = rank_tree_top(&leaderboards[topic + 1], ids, scores, max_entries);
+        pthread_mutex_unlock(&leaderboard_lock);
+    }
+    for (int i = 0; i < count; i++) {
+        entries[i].student_id = ids[i];
+        entries[i].rank = i + 1;
+        entries[i].score = scores[i];
+    }
+    free(ids);
+    free(scores);
+    return count;
+}
+
+int get_leaderboard_size(int topic) {
+    if (topic < LEADERBOARD_OVERALL || topic >= NUM_C_TOPICS) {
+        return 0;
+    }
+    pthread_mutex_lock(&leaderboard_lock);
+    init_leaderboards_locked();
+    int size = rank_tree_size(&leaderboards[topic + 1]);
+    pthread_mutex_unlock(&leaderboard_lock);
+    return size;
+}
+
+void display_topic_leaderboard(int topic) {
+    LeaderboardEntry entries[LEADERBOARD_DISPLAY_SIZE];
+    int count = get_leaderboard_top(topic, entries, LEADERBOARD_DISPLAY_SIZE);
+
+    if (topic == LEADERBOARD_OVERALL) {
+        printf("\n🏆 Leaderboard - Experience Points (%d students)\n", get_leaderboard_size(topic));
+    } else {
+        printf("\n🏆 Leaderboard - %s (%d students)\n", get_topic_name((TopicIndex)topic),
+               get_leaderboard_size(topic));
+    }
+    if (count == 0) {
+        printf("   No students ranked yet\n");
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const char* medal = i == 0 ? "🥇" : i == 1 ? "🥈" : i == 2 ? "🥉" : "  ";
+        Student* student = find_student_by_id(entries[i].student_id);
+        char name[32];
+        if (student && student->name[0]) {
+            snprintf(name, sizeof(name), "%.31s", student->name);
+        } else {
+            snprintf(name, sizeof(name), "Student #%d", entries[i].student_id);
+        }
+
+        if (topic == LEADERBOARD_OVERALL) {
+            printf("   %s %3d. %-30s %8.0f XP\n", medal, entries[i].rank, name, entries[i].score);
+        } else {
+            printf("   %s %3d. %-30s %7.1f%%\n", medal, entries[i].rank, name, entries[i].score * 100.0f);
+        }
+    }
+}
+
+void display_leaderboard(void) {
+    display_topic_leaderboard(LEADERBOARD_OVERALL);
+}
@@ -0,0 +1,520 @@
+// quiz_main.c - Command-line front end for the C Programming Quiz System
+// Signs a student in and runs the interactive menu
+
+#include "quiz_system.h"
+
+#define ADAPTIVE_QUIZ_LENGTH 10
+#define MOCK_EXAM_LENGTH 20
+#define MOCK_EXAM_SECONDS_PER_QUESTION 60.0f
+#define TRACE_EVENTS_PER_THREAD 65536
+
+// ============================================================================
+// INPUT UTILITIES
+// ============================================================================
+
+void clear_input_buffer(void) {
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF) {
+    }
+}
+
+// Re-prompts until a number in [min, max] is entered; returns min - 1 at
+// end of input so callers can bail out
+int get_user_choice(int min, int max) {
+    char line[MAX_STRING];
+    while (fgets(line, sizeof(line), stdin)) {
+        char* end;
+        long choice = strtol(line, &end, 10);
+        if (end != line && *trim_whitespace(end) == '\0' && choice >= min && choice <= max) {
+            return (int)choice;
+        }
+        printf("⚠️  Please enter a number from %d to %d: ", min, max);
+    }
+    return min - 1;
+}
+
+void wait_for_enter(void) {
+    printf("\nPress Enter to continue...");
+    clear_input_buffer();
+}
+
+// ============================================================================
+// QUIZ MODES
+// ============================================================================
+
+void display_quiz_results(QuizSession* session) {
+    ResponseTimePercentiles times;
+    sketch_percentiles(&session->response_times, &times);
+
+    printf("\n🏁 Quiz Complete!\n");
+    printf("   Score: %d/%d (%.1f%%)\n", session->questions_correct, session->questions_attempted,
+           session->session_accuracy * 100.0f);
+    printf("   Average time: %.1fs (p90 %.1fs)\n", session->avg_response_time, times.p90);
+    printf("   Level: %s\n", skill_level_names[session->session_level - 1]);
+}
+
+// Asks one question and records the answer against the student and the
+// session. Feedback is shown straight away unless it is held back for the
+// end of an exam. Returns whether the answer was correct, or -1 at end of input.
+static int ask_question(Student* student, QuizSession* session, Question* question, int show_feedback) {
+    display_question(question);
+    // The explanation and hints are read while the student thinks
+    prefetch_question_text(question);
+    time_t asked = time(NULL);
+    int answer;
+    int hints_shown = 0;
+    for (;;) {
+        printf(show_feedback ? "\nYour answer (0 for a hint): " : "\nYour answer: ");
+        answer = get_user_choice(show_feedback ? 0 : 1, MAX_OPTIONS);
+        if (answer != 0) {
+            break;
+        }
+        provide_intelligent_hint(question, -1, ++hints_shown);
+    }
+    if (answer < 1) {
+        return -1;
+    }
+    float time_taken = (float)difftime(time(NULL), asked);
+
+    int is_correct = answer - 1 == question->correct_answer;
+    if (show_feedback) {
+        if (is_correct) {
+            printf("✅ Correct!\n");
+        } else {
+            printf("❌ Incorrect. The answer was %d. %s\n", question->correct_answer + 1,
+                   text_get(question->options[question->correct_answer]));
+        }
+        if (text_length(question->explanation) > 0) {
+            printf("💡 %s\n", text_get(question->explanation));
+        }
+    }
+
+    update_student_stats(student, question, is_correct, time_taken);
+    session->questions_attempted++;
+    session->questions_correct += is_correct;
+    session->avg_response_time += (time_taken - session->avg_response_time) / session->questions_attempted;
+    sketch_record(&session->response_times, time_taken);
+    session->primary_topic = question_topic(question);
+    return is_correct;
+}
+
+static void finish_session(Student* student, QuizSession* session) {
+    if (session->questions_attempted > 0) {
+        session->end_time = time(NULL);
+        session->session_accuracy = calculate_accuracy(session->questions_correct, session->questions_attempted);
+        session->session_level = student->current_level;
+        display_quiz_results(session);
+        check_achievements(student, session);
+    }
+}
+
+void run_adaptive_quiz(Student* student) {
+    QuizSession session;
+    memset(&session, 0, sizeof(session));
+    session.start_time = time(NULL);
+    session.session_level = student->current_level;
+
+    for (int i = 0; i < ADAPTIVE_QUIZ_LENGTH; i++) {
+        AIRecommendation recommendation = get_ai_recommendation(student);
+        Question* question = recommendation.recommended_question;
+        if (!question) {
+            printf("❌ No questions available\n");
+            break;
+        }
+
+        printf("\n🤖 %s\n", recommendation.reasoning);
+        if (ask_question(student, &session, question, 1) < 0) {
+            break;
+        }
+    }
+    finish_session(student, &session);
+}
+
+// Draws one variant of the blueprint and sits it; answers are reviewed at
+// the end, as in a real exam
+static void run_exam(Student* student, const ExamBlueprint* blueprint, const char* title) {
+    ExamPlan* plan = exam_plan_build(blueprint);
+    if (!plan) {
+        printf("❌ The question bank cannot fill this exam\n");
+        return;
+    }
+    int question_ids[EXAM_MAX_QUESTIONS];
+    uint64_t seed = (uint64_t)time(NULL) * 0x9E3779B97F4A7C15ull ^ (uint64_t)student->student_id;
+    float expected_seconds;
+    int count = exam_plan_sample(plan, &seed, question_ids, &expected_seconds);
+    exam_plan_free(plan);
+
+    printf("\n📝 %s: %d questions, about %s\n", title, count, format_time_duration((int)expected_seconds));
+    if (blueprint->time_budget_seconds > 0) {
+        printf("   Time limit: %s\n", format_time_duration((int)blueprint->time_budget_seconds));
+    }
+
+    QuizSession session;
+    memset(&session, 0, sizeof(session));
+    session.start_time = time(NULL);
+    session.session_level = student->current_level;
+    int asked = 0;
+    for (; asked < count; asked++) {
+        printf("\n[%d/%d]", asked + 1, count);
+        if (asked + 1 < count) {
+            prefetch_question_text(get_question_by_id(question_ids[asked + 1]));
+        }
+        if (ask_question(student, &session, get_question_by_id(question_ids[asked]), 0) < 0) {
+            break;
+        }
+    }
+
+    if (asked > 0) {
+        printf("\n📖 Review\n");
+    }
+    for (int i = 0; i < asked; i++) {
+        Question* question = get_question_by_id(question_ids[i]);
+        printf("  %2d. %s — answer %d: %s\n", i + 1, get_topic_name(question_topic(question)),
+               question->correct_answer + 1, text_get(question->options[question->correct_answer]));
+    }
+    int elapsed = (int)difftime(time(NULL), session.start_time);
+    if (blueprint->time_budget_seconds > 0 && elapsed > blueprint->time_budget_seconds) {
+        printf("⏰ Over time by %s\n", format_time_duration(elapsed - (int)blueprint->time_budget_seconds));
+    }
+    finish_session(student, &session);
+}
+
+void run_mock_exam(Student* student, SkillLevel level, int num_questions) {
+    ExamBlueprint blueprint;
+    int placed = exam_blueprint_for_level(&blueprint, level, num_questions, NULL, 0);
+    if (placed < num_questions) {
+        printf("⚠️  Only %d questions available for this exam\n", placed);
+    }
+    blueprint.time_budget_seconds = placed * MOCK_EXAM_SECONDS_PER_QUESTION;
+    run_exam(student, &blueprint, "Mock exam");
+}
+
+void run_company_specific_prep(Student* student, const char* company) {
+    const InterviewProfile* profile = find_interview_profile(company);
+    if (!profile) {
+        printf("❌ No interview profile for %s\n", company);
+        return;
+    }
+    TopicIndex topics[5];
+    int topic_count = get_profile_topics(profile, topics);
+
+    // Profiles rate difficulty 1-5; blueprints mix by skill level
+    SkillLevel level = profile->difficulty_level >= 4   ? EXPERT
+                       : profile->difficulty_level == 3 ? ADVANCED
+                       : profile->difficulty_level == 2 ? INTERMEDIATE
+                                                        : BEGINNER;
+    ExamBlueprint blueprint;
+    int placed = exam_blueprint_for_level(&blueprint, level, profile->typical_question_count, topics, topic_count);
+    if (placed < profile->typical_question_count) {
+        printf("⚠️  Only %d questions available for this track\n", placed);
+    }
+    blueprint.time_budget_seconds = profile->time_limit_minutes * 60.0f;
+
+    char title[MAX_STRING];
+    snprintf(title, sizeof(title), "%s interview", profile->company_name);
+    run_exam(student, &blueprint, title);
+}
+
+// Lists the profiles and preps for the one picked
+static void choose_interview_prep(Student* student) {
+    const InterviewProfile* profiles;
+    int count = get_interview_profiles(&profiles);
+    printf("\n💼 Interview tracks\n");
+    for (int p = 0; p < count; p++) {
+        printf("  %d. %s (%d questions, %d min)\n", p + 1, profiles[p].company_name,
+               profiles[p].typical_question_count, profiles[p].time_limit_minutes);
+    }
+    printf("Choice: ");
+    int choice = get_user_choice(1, count);
+    if (choice >= 1) {
+        run_company_specific_prep(student, profiles[choice - 1].company_name);
+    }
+}
+
+void run_ai_tutor_chat(Student* student) {
+    if (tutor_start() < 0) {
+        printf("❌ The tutor needs a question bank\n");
+        return;
+    }
+    TutorSession* session = tutor_session_open(student->student_id);
+    if (!session) {
+        return;
+    }
+    printf("\n🤖 AI Tutor: ask about any C topic. Say \"hint\" or \"why\" about the question I suggest, "
+           "\"another\" for a similar one, or press Enter to leave.\n");
+
+    char line[MAX_STRING];
+    char reply[TUTOR_REPLY_LENGTH];
+    for (;;) {
+        printf("\nYou: ");
+        if (!fgets(line, sizeof(line), stdin)) {
+            break;
+        }
+        if (!strchr(line, '\n')) {
+            clear_input_buffer();
+        }
+        char* message = trim_whitespace(line);
+        if (*message == '\0' || strcmp(message, "quit") == 0 || strcmp(message, "exit") == 0) {
+            break;
+        }
+        if (tutor_reply(session, message, reply, sizeof(reply)) < 0) {
+            printf("❌ The tutor is not available\n");
+            break;
+        }
+        printf("🤖 %s\n", reply);
+    }
+    tutor_session_close(session);
+}
+
+// ============================================================================
+// MAIN MENU
+// ============================================================================
+
+// Returning students are looked up by id; anyone else gets a new profile
+static Student* sign_in_student(void) {
+    printf("\nEnter your student ID (0 for a new profile): ");
+    int student_id = get_user_choice(0, 1000000000);
+    if (student_id < 0) {
+        return NULL;
+    }
+
+    Student* student = find_student_by_id(student_id);
+    if (student) {
+        printf("👋 Welcome back, %s!\n", student->name);
+        return student;
+    }
+
+    Student profile;
+    memset(&profile, 0, sizeof(profile));
+    printf("Enter your name: ");
+    if (!fgets(profile.name, sizeof(profile.name), stdin)) {
+        return NULL;
+    }
+    if (!strchr(profile.name, '\n')) {
+        clear_input_buffer(); // longer names are cut to MAX_NAME_LENGTH - 1
+    }
+    char* name = trim_whitespace(profile.name);
+    memmove(profile.name, name, strlen(name) + 1);
+    do {
+        initialize_student(&profile);
+    } while (find_student_by_id(profile.student_id));
+    return register_student(&profile);
+}
+
+// ============================================================================
+// HEADLESS MODES
+// ============================================================================
+
+static void print_usage(const char* program) {
+    printf("Usage: %s\n", program);
+    printf("       %s --grade FILE [--workers N] [--register] [--report FILE]\n", program);
+    printf("       %s --replay LOG [--workers N] [--report FILE]\n", program);
+    printf("       %s --export FILE [--columnar] [--workers N]\n", program);
+}
+
+// Writes every student's progress in one pass, for nightly reporting
+static int run_cohort_export(const char* filename, const CohortExportOptions* options) {
+    if (initialize_quiz_system() != 0) {
+        return 1;
+    }
+    CohortExportStats stats;
+    int status = 0;
+    if (export_cohort_report(filename, options, &stats) < 0) {
+        printf("❌ Could not write %s\n", filename);
+        status = 1;
+    } else {
+        printf("✅ Exported %d students (%zu bytes) to %s in %.3fs\n", stats.students, stats.bytes, filename,
+               stats.seconds);
+    }
+    cleanup_quiz_system();
+    return status;
+}
+
+// --grade applies a file of submitted answers to the saved system, e.g. a
+// whole cohort's mock exam. --replay re-runs a recorded progress log into a
+// fresh in-memory registry and saves nothing, for load testing. --export
+// writes the cohort report.
+static int run_headless(int argc, char** argv) {
+    const char* grade_file = NULL;
+    const char* replay_log = NULL;
+    const char* report_file = NULL;
+    const char* export_file = NULL;
+    BatchGradeOptions options = { 1, 0 };
+    CohortExportOptions export_options = { REPORT_FORMAT_CSV, 1 };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--grade") == 0 && i + 1 < argc) {
+            grade_file = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_log = argv[++i];
+        } else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc) {
+            export_file = argv[++i];
+        } else if (strcmp(argv[i], "--columnar") == 0) {
+            export_options.format = REPORT_FORMAT_COLUMNAR;
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            options.worker_count = atoi(argv[++i]);
+            export_options.worker_count = options.worker_count;
+        } else if (strcmp(argv[i], "--register") == 0) {
+            options.register_unknown = 1;
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            report_file = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (export_file && !grade_file && !replay_log) {
+        return run_cohort_export(export_file, &export_options);
+    }
+    if (export_file || !grade_file == !replay_log) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    GradedAnswer* answers = NULL;
+    int count;
+    if (grade_file) {
+        initialize_quiz_system();
+        count = load_graded_answers(grade_file, &answers);
+    } else {
+        if (load_questions_from_file(QUESTIONS_FILE) == 0) {
+            create_default_question_bank();
+        }
+        options.register_unknown = 1;
+        count = read_progress_log_answers(replay_log, &answers);
+    }
+    if (count < 0) {
+        printf("❌ Could not read %s\n", grade_file ? grade_file : replay_log);
+        if (grade_file) {
+            cleanup_quiz_system();
+        }
+        return 1;
+    }
+
+    BatchGradeResult result;
+    int status = 0;
+    if (grade_answer_batch(answers, count, &options, &result) < 0) {
+        printf("❌ Not enough memory to grade %d answers\n", count);
+        status = 1;
+    } else {
+        printf("✅ Graded %ld answers from %d students in %.3fs (%.0f answers/s)\n", result.applied,
+               result.student_count, result.seconds, result.seconds > 0 ? result.applied / result.seconds : 0.0);
+        printf("   Correct: %ld (%.1f%%)   Rejected: %ld\n", result.correct,
+               calculate_accuracy((int)result.correct, (int)result.applied) * 100.0f, result.rejected);
+        if (report_file && !save_batch_grade_report(report_file, &result)) {
+            printf("❌ Could not write %s\n", report_file);
+            status = 1;
+        }
+        free_batch_grade_result(&result);
+    }
+    free(answers);
+
+    if (grade_file) {
+        cleanup_quiz_system();
+    }
+    return status;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        return run_headless(argc, argv);
+    }
+    printf("🎓 C Programming Quiz System\n");
+
+    // QUIZ_TRACE_FILE=trace.json records a timeline of the whole run for
+    // chrome://tracing or ui.perfetto.dev
+    const char* trace_file = getenv("QUIZ_TRACE_FILE");
+    if (trace_file && !trace_start_recording(TRACE_EVENTS_PER_THREAD)) {
+        printf("⚠️  Tracing is not compiled in; ignoring QUIZ_TRACE_FILE\n");
+        trace_file = NULL;
+    }
+
+    if (initialize_quiz_system() != 0) {
+        return 1;
+    }
+
+    Student* student = sign_in_student();
+    if (!student) {
+        cleanup_quiz_system();
+        return 1;
+    }
+
+    for (;;) {
+        printf("\n📋 Main Menu\n");
+        printf("  1. Adaptive quiz\n");
+        printf("  2. Leaderboard\n");
+        printf("  3. System analytics\n");
+        printf("  4. Memory footprint\n");
+        printf("  5. Backup status\n");
+        printf("  6. Latency breakdown\n");
+        printf("  7. Verify code questions\n");
+        printf("  8. Progress report\n");
+        printf("  9. Achievements\n");
+        printf(" 10. Mock exam\n");
+        printf(" 11. Interview prep\n");
+        printf(" 12. Learning path\n");
+        printf(" 13. AI tutor\n");
+        printf("  0. Exit\n");
+        printf("Choice: ");
+
+        int choice = get_user_choice(0, 13);
+        if (choice <= 0) {
+            break;
+        }
+        switch (choice) {
+            case 1:
+                run_adaptive_quiz(student);
+                break;
+            case 2:
+                display_leaderboard();
+                break;
+            case 3:
+                display_system_analytics();
+                break;
+            case 4:
+                display_memory_footprint();
+                break;
+            case 5:
+                display_backup_stats();
+                break;
+            case 6:
+                display_latency_breakdown();
+                break;
+            case 7:
+                run_code_quality_analyzer();
+                break;
+            case 8:
+                export_progress_report(student);
+                break;
+            case 9:
+                display_achievements(student);
+                break;
+            case 10:
+                run_mock_exam(student, student->current_level, MOCK_EXAM_LENGTH);
+                break;
+            case 11:
+                choose_interview_prep(student);
+                break;
+            case 12:
+                generate_ai_learning_path(student);
+                break;
+            case 13:
+                run_ai_tutor_chat(student);
+                break;
+        }
+        backup_if_due();
+    }
+
+    cleanup_quiz_system();
+    if (trace_file) {
+        trace_stop_recording();
+        int events = export_chrome_trace(trace_file);
+        if (events < 0) {
+            printf("❌ Could not write trace to %s\n", trace_file);
+        } else {
+            printf("📈 Wrote %d trace events to %s\n", events, trace_file);
+        }
+    }
+    printf("👋 Goodbye!\n");
+    return 0;
+}
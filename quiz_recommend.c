@@ -0,0 +1,397 @@
+// quiz_recommend.c - AI recommendation engine for the C Programming Quiz System
+// Scores questions against a student's mastery and keeps per-student caches
+// that are repaired one topic at a time as answers come in
+
+#include "quiz_system.h"
+
+// ============================================================================
+// SCORING
+// ============================================================================
+
+#define MATCH_WEIGHT 0.6f
+#define PRIORITY_WEIGHT 0.4f
+
+// Topics the student is weak in, or has barely practised, rank higher
+float calculate_topic_priority(Student* student, TopicIndex topic) {
+    float weakness = 1.0f - student->topic_scores[topic];
+    float exposure = 1.0f / (1.0f + student->topic_questions_attempted[topic] * 0.1f);
+    return weakness * 0.7f + exposure * 0.3f;
+}
+
+// Authored difficulty blended with the observed error rate once the question
+// has been asked. Depends only on the question, not on the student.
+float effective_question_difficulty(const QuestionHotTable* hot, int slot) {
+    float difficulty = hot->difficulty[slot];
+    if (hot->times_asked[slot] > 0) {
+        float accuracy = (float)hot->times_correct[slot] / hot->times_asked[slot];
+        float observed = 1.0f + (1.0f - accuracy) * (MAX_DIFFICULTY - 1);
+        difficulty = difficulty * 0.5f + observed * 0.5f;
+    }
+    return difficulty;
+}
+
+// 1 when the difficulty sits exactly at the student's level for the topic
+static float difficulty_match(float difficulty, float topic_score) {
+    float target = 1.0f + topic_score * (MAX_DIFFICULTY - 1);
+    return 1.0f - fabsf(difficulty - target) / (MAX_DIFFICULTY - 1);
+}
+
+float calculate_question_difficulty_score(Question* question, Student* student) {
+    QuestionHotTable* hot = get_question_hot_table();
+    return difficulty_match(effective_question_difficulty(hot, question->slot),
+                            student->topic_scores[question_topic(question)]);
+}
+
+// ============================================================================
+// DIFFICULTY BINS
+// ============================================================================
+
+// Each topic's questions are bucketed by effective difficulty, so the best
+// match for a target level is found by looking at the nearest bins instead
+// of scoring the whole topic. A stat update moves one question between bins.
+#define DIFFICULTY_BINS 64
+#define MAX_BIN_CANDIDATES 32
+
+typedef struct {
+    int* slots;
+    int count;
+    int capacity;
+} SlotBin;
+
+static SlotBin bins[NUM_C_TOPICS][DIFFICULTY_BINS];
+static int* slot_bin = NULL; // bin currently holding each slot
+static int* slot_pos = NULL; // position of each slot within its bin
+static int binned_count = 0;
+static int binned_capacity = 0;
+static unsigned int binned_generation = 0;
+static unsigned int topic_versions[NUM_C_TOPICS]; // bumped when a bin changes
+
+static int bin_for_difficulty(float difficulty) {
+    int bin = (int)((difficulty - 1.0f) / (MAX_DIFFICULTY - 1) * DIFFICULTY_BINS);
+    return bin < 0 ? 0 : (bin >= DIFFICULTY_BINS ? DIFFICULTY_BINS - 1 : bin);
+}
+
+static void bin_insert(int topic, int bin, int slot) {
+    SlotBin* b = &bins[topic][bin];
+    if (b->count == b->capacity) {
+        int capacity = b->capacity ? b->capacity * 2 : 16;
+        int* slots = realloc(b->slots, capacity * sizeof(int));
+        if (!slots) {
+            return;
+        }
+        b->slots = slots;
+        b->capacity = capacity;
+    }
+    slot_bin[slot] = bin;
+    slot_pos[slot] = b->count;
+    b->slots[b->count++] = slot;
+}
+
+static void bin_remove(int topic, int slot) {
+    SlotBin* b = &bins[topic][slot_bin[slot]];
+    int pos = slot_pos[slot];
+    int moved = b->slots[--b->count];
+    b->slots[pos] = moved;
+    slot_pos[moved] = pos;
+}
+
+static void sync_difficulty_bins(void) {
+    QuestionHotTable* hot = get_question_hot_table();
+    if (binned_generation != question_store_generation()) {
+        for (int t = 0; t < NUM_C_TOPICS; t++) {
+            for (int b = 0; b < DIFFICULTY_BINS; b++) {
+                bins[t][b].count = 0;
+            }
+            topic_versions[t]++;
+        }
+        binned_count = 0;
+        binned_generation = question_store_generation();
+    }
+    if (binned_count == hot->count) {
+        return;
+    }
+
+    if (hot->count > binned_capacity) {
+        int capacity = binned_capacity ? binned_capacity : 1024;
+        while (capacity < hot->count) {
+            capacity *= 2;
+        }
+        int* bin_of = realloc(slot_bin, capacity * sizeof(int));
+        if (bin_of) slot_bin = bin_of;
+        int* pos_of = realloc(slot_pos, capacity * sizeof(int));
+        if (pos_of) slot_pos = pos_of;
+        if (!bin_of || !pos_of) {
+            return;
+        }
+        binned_capacity = capacity;
+    }
+
+    for (; binned_count < hot->count; binned_count++) {
+        int slot = binned_count;
+        int topic = hot->topic[slot];
+        bin_insert(topic, bin_for_difficulty(effective_question_difficulty(hot, slot)), slot);
+        topic_versions[topic]++;
+    }
+}
+
+// Re-bins a question after its stats change
+void refresh_question_recommendation(int slot) {
+    sync_difficulty_bins();
+    if (slot < 0 || slot >= binned_count) {
+        return;
+    }
+    QuestionHotTable* hot = get_question_hot_table();
+    int topic = hot->topic[slot];
+    int bin = bin_for_difficulty(effective_question_difficulty(hot, slot));
+    if (bin != slot_bin[slot]) {
+        bin_remove(topic, slot);
+        bin_insert(topic, bin, slot);
+        topic_versions[topic]++;
+    }
+}
+
+// ============================================================================
+// PER-STUDENT CACHE
+// ============================================================================
+
+#define RECENT_QUESTIONS 8
+
+typedef struct {
+    int student_id;
+    int best_slot[NUM_C_TOPICS];        // cached pick per topic, -1 if none
+    unsigned int version[NUM_C_TOPICS]; // topic_versions seen at the pick
+    unsigned int dirty;                 // topics whose score moved since
+    int recent[RECENT_QUESTIONS];       // slots answered lately, skipped
+    int recent_next;
+} RecommendationCache;
+
+static ChunkedArray caches = { sizeof(RecommendationCache), 256, 0, NULL, 0, 0 };
+static IdMap cache_index; // student_id -> cache
+
+static RecommendationCache* find_cache(const Student* student) {
+    int index = id_map_get(&cache_index, student->student_id);
+    if (index >= 0) {
+        return chunked_array_at(&caches, index);
+    }
+
+    index = caches.count;
+    RecommendationCache* cache = chunked_array_push(&caches);
+    if (!cache) {
+        return NULL;
+    }
+    cache->student_id = student->student_id;
+    cache->dirty = (1u << NUM_C_TOPICS) - 1;
+    for (int i = 0; i < RECENT_QUESTIONS; i++) {
+        cache->recent[i] = -1;
+    }
+    id_map_put(&cache_index, student->student_id, index);
+    return cache;
+}
+
+static int recently_answered(const RecommendationCache* cache, int slot) {
+    for (int i = 0; i < RECENT_QUESTIONS; i++) {
+        if (cache->recent[i] == slot) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Best match in one topic, searching outward from the target's bin. Bins
+// one step past the first hit are still checked because a bin spans a
+// range of difficulties.
+static int find_best_in_topic(const RecommendationCache* cache, int topic, float topic_score) {
+    QuestionHotTable* hot = get_question_hot_table();
+    int target_bin = bin_for_difficulty(1.0f + topic_score * (MAX_DIFFICULTY - 1));
+    int best_slot = -1;
+    int fallback_slot = -1; // best among recently answered questions
+    float best_match = -1.0f;
+    float fallback_match = -1.0f;
+    int found_at = -1;
+
+    for (int distance = 0; distance < DIFFICULTY_BINS; distance++) {
+        if (found_at >= 0 && distance > found_at + 1) {
+            break;
+        }
+        for (int side = -1; side <= 1; side += 2) {
+            int bin = target_bin + side * distance;
+            if (bin < 0 || bin >= DIFFICULTY_BINS || (distance == 0 && side > 0)) {
+                continue;
+            }
+            SlotBin* b = &bins[topic][bin];
+            int limit = b->count < MAX_BIN_CANDIDATES ? b->count : MAX_BIN_CANDIDATES;
+            for (int i = 0; i < limit; i++) {
+                int slot = b->slots[i];
+                float match = difficulty_match(effective_question_difficulty(hot, slot), topic_score);
+                if (recently_answered(cache, slot)) {
+                    if (match > fallback_match) {
+                        fallback_match = match;
+                        fallback_slot = slot;
+                    }
+                } else if (match > best_match) {
+                    best_match = match;
+                    best_slot = slot;
+                    if (found_at < 0) {
+                        found_at = distance;
+                    }
+                }
+            }
+        }
+    }
+    return best_slot >= 0 ? best_slot : fallback_slot;
+}
+
+// Full pass for a cold cache, e.g. a new student or an imported profile:
+// scores the whole hot table with the batch kernel and takes the exact best
+// question of every topic at once
+#define SCORE_BLOCK 1024
+
+static void seed_cache_full_pass(RecommendationCache* cache, const Student* student) {
+    QuestionHotTable* hot = get_question_hot_table();
+    float best_match[NUM_C_TOPICS];
+    float scores[SCORE_BLOCK];
+
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        cache->best_slot[t] = -1;
+        best_match[t] = -1.0f;
+    }
+    for (int start = 0; start < hot->count; start += SCORE_BLOCK) {
+        int count = hot->count - start < SCORE_BLOCK ? hot->count - start : SCORE_BLOCK;
+        score_questions_batch(hot->difficulty + start, hot->topic + start,
+                              hot->times_asked + start, hot->times_correct + start,
+                              count, student->topic_scores, scores);
+        for (int i = 0; i < count; i++) {
+            int topic = hot->topic[start + i];
+            if (scores[i] > best_match[topic] && !recently_answered(cache, start + i)) {
+                best_match[topic] = scores[i];
+                cache->best_slot[topic] = start + i;
+            }
+        }
+    }
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        cache->version[t] = topic_versions[t];
+    }
+    cache->dirty = 0;
+}
+
+static void repair_topic(RecommendationCache* cache, const Student* student, int topic) {
+    cache->best_slot[topic] = find_best_in_topic(cache, topic, student->topic_scores[topic]);
+    cache->version[topic] = topic_versions[topic];
+    cache->dirty &= ~(1u << topic);
+}
+
+// Called for every answer: the student's score moved in one topic only, so
+// only that topic's cached pick is invalidated, and the question itself is
+// rescheduled for review
+void recommendation_record_answer(Student* student, Question* question, int is_correct, float time_taken) {
+    review_record_answer(student->student_id, question->slot, is_correct, time_taken, student->last_practice);
+    RecommendationCache* cache = find_cache(student);
+    if (!cache) {
+        return;
+    }
+    cache->dirty |= 1u << question_topic(question);
+    cache->recent[cache->recent_next] = question->slot;
+    cache->recent_next = (cache->recent_next + 1) % RECENT_QUESTIONS;
+}
+
+// Drops a student's cached picks, e.g. after their profile is replaced
+void invalidate_recommendations(Student* student) {
+    RecommendationCache* cache = find_cache(student);
+    if (cache) {
+        cache->dirty = (1u << NUM_C_TOPICS) - 1;
+    }
+}
+
+// ============================================================================
+// RECOMMENDATION
+// ============================================================================
+
+AIRecommendation get_ai_recommendation(Student* student) {
+    TRACE_SCOPE(TRACE_RECOMMENDATION);
+    AIRecommendation rec;
+    memset(&rec, 0, sizeof(AIRecommendation));
+
+    sync_difficulty_bins();
+    RecommendationCache* cache = find_cache(student);
+    if (!cache) {
+        snprintf(rec.reasoning, MAX_STRING, "Recommendation cache unavailable");
+        return rec;
+    }
+
+    // Questions due for spaced review come before new material
+    QuestionHotTable* hot = get_question_hot_table();
+    int due[RECENT_QUESTIONS + 1];
+    int due_count = review_due_questions(student->student_id, time(NULL), due, RECENT_QUESTIONS + 1);
+    for (int i = 0; i < due_count; i++) {
+        if (recently_answered(cache, due[i])) {
+            continue;
+        }
+        ReviewState state;
+        get_review_state(student->student_id, due[i], &state);
+        TopicIndex topic = (TopicIndex)hot->topic[due[i]];
+        rec.recommended_question = question_at(due[i]);
+        rec.difficulty_match = difficulty_match(effective_question_difficulty(hot, due[i]),
+                                                student->topic_scores[topic]);
+        rec.topic_priority = calculate_topic_priority(student, topic);
+        rec.confidence_score = 1.0f;
+        if (state.reps == 0) {
+            snprintf(rec.reasoning, MAX_STRING, "You missed this %s question recently; let's try it again",
+                     get_topic_name(topic));
+        } else {
+            snprintf(rec.reasoning, MAX_STRING, "Due for review: you last got this %s question right %s",
+                     get_topic_name(topic), state.interval >= 48 ? "a while ago" : "yesterday");
+        }
+        snprintf(rec.learning_objective, MAX_STRING, "Retain %s", get_topic_name(topic));
+        return rec;
+    }
+
+    if (cache->dirty == (1u << NUM_C_TOPICS) - 1) {
+        seed_cache_full_pass(cache, student);
+    }
+
+    float best_score = -1.0f;
+    float best_match = 0.0f;
+    float best_priority = 0.0f;
+    int best_slot = -1;
+    int best_fresh = -1;
+
+    // A topic whose every nearby question was just answered only offers a
+    // recent one, so any fresh pick in another topic is served first
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        if ((cache->dirty & (1u << t)) || cache->version[t] != topic_versions[t]) {
+            repair_topic(cache, student, t);
+        }
+        int slot = cache->best_slot[t];
+        if (slot < 0) {
+            continue;
+        }
+        float match = difficulty_match(effective_question_difficulty(hot, slot), student->topic_scores[t]);
+        float priority = calculate_topic_priority(student, (TopicIndex)t);
+        float score = match * MATCH_WEIGHT + priority * PRIORITY_WEIGHT;
+        int fresh = !recently_answered(cache, slot);
+        if (fresh > best_fresh || (fresh == best_fresh && score > best_score)) {
+            best_fresh = fresh;
+            best_score = score;
+            best_match = match;
+            best_priority = priority;
+            best_slot = slot;
+        }
+    }
+
+    if (best_slot < 0) {
+        snprintf(rec.reasoning, MAX_STRING, "No questions available");
+        return rec;
+    }
+
+    TopicIndex topic = (TopicIndex)hot->topic[best_slot];
+    rec.recommended_question = question_at(best_slot);
+    rec.difficulty_match = best_match;
+    rec.topic_priority = best_priority;
+    rec.confidence_score = best_score;
+    snprintf(rec.reasoning, MAX_STRING,
+             "Your mastery of %s is %.0f%%; this %s question matches your current level",
+             get_topic_name(topic), student->topic_scores[topic] * 100.0f,
+             difficulty_names[hot->difficulty[best_slot] - 1]);
+    snprintf(rec.learning_objective, MAX_STRING, "Strengthen %s", get_topic_name(topic));
+    return rec;
+}
@@ -0,0 +1,483 @@
+// quiz_report.c - Progress reports and cohort export for the C Programming Quiz System
+// Per-student reports, and a whole-cohort export that formats blocks of
+// students on worker threads and streams them, in order, through one
+// buffered writer as CSV or as a compact columnar file
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "quiz_system.h"
+
+#include <pthread.h>
+
+#define EXPORT_BLOCK_ROWS 256
+#define EXPORT_WRITE_BUFFER (1 << 20)
+#define CSV_ROW_BYTES (2 * MAX_NAME_LENGTH + 1024) // a fully quoted name plus every number
+#define MAX_REVIEW_PEEK 100
+
+// Columnar layout, all integers little-endian as written by this machine:
+//   "QZCOHORT" | u32 version | u32 column count | column count x (char name[32], u32 type)
+//   row groups: u32 rows | u32 payload bytes | each column's values for those rows
+//   end: u32 0
+// Fixed-width columns hold `rows` values; a string column holds `rows` u32
+// end offsets followed by the bytes.
+#define COLUMNAR_MAGIC "QZCOHORT"
+#define COLUMNAR_VERSION 1
+
+typedef enum {
+    COLUMN_INT32 = 1,
+    COLUMN_FLOAT32 = 2,
+    COLUMN_INT64 = 3,
+    COLUMN_STRING = 4
+} ColumnType;
+
+typedef struct {
+    const char* name;
+    ColumnType type;
+} ColumnSpec;
+
+// Mastery per topic follows these, then the name, which is the only
+// variable-width column
+static const ColumnSpec cohort_columns[] = {
+    { "student_id", COLUMN_INT32 },       { "level", COLUMN_INT32 },
+    { "attempted", COLUMN_INT32 },        { "correct", COLUMN_INT32 },
+    { "accuracy", COLUMN_FLOAT32 },       { "study_minutes", COLUMN_INT32 },
+    { "streak", COLUMN_INT32 },           { "max_streak", COLUMN_INT32 },
+    { "last_practice", COLUMN_INT64 },    { "predicted_exam_score", COLUMN_FLOAT32 },
+    { "interview_ready_score", COLUMN_INT32 }, { "strongest_topic", COLUMN_INT32 },
+    { "weakest_topic", COLUMN_INT32 },
+};
+
+#define COHORT_FIXED_COLUMNS ((int)(sizeof(cohort_columns) / sizeof(cohort_columns[0])))
+#define COHORT_COLUMNS (COHORT_FIXED_COLUMNS + NUM_C_TOPICS + 1)
+
+// ============================================================================
+// REPORT HELPERS
+// ============================================================================
+
+// Strongest and weakest topics by mastery among those practised; -1 if none
+static void topic_extremes(const Student* student, int* strongest, int* weakest) {
+    *strongest = -1;
+    *weakest = -1;
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        if (student->topic_questions_attempted[t] == 0) {
+            continue;
+        }
+        if (*strongest < 0 || student->topic_scores[t] > student->topic_scores[*strongest]) {
+            *strongest = t;
+        }
+        if (*weakest < 0 || student->topic_scores[t] < student->topic_scores[*weakest]) {
+            *weakest = t;
+        }
+    }
+}
+
+static const char* level_name(SkillLevel level) {
+    return level >= BEGINNER && level <= EXPERT ? skill_level_names[level - 1] : "Unknown";
+}
+
+// YYYY-MM-DD in UTC without localtime's locking, for per-row use
+static int format_date(char* out, time_t when) {
+    long days = (long)(when / 86400) - (when % 86400 < 0);
+    days += 719468;
+    long era = (days >= 0 ? days : days - 146096) / 146097;
+    long day_of_era = days - era * 146097;
+    long year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    long day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    long month_index = (5 * day_of_year + 2) / 153;
+    int day = (int)(day_of_year - (153 * month_index + 2) / 5 + 1);
+    int month = (int)(month_index < 10 ? month_index + 3 : month_index - 9);
+    long year = year_of_era + era * 400 + (month <= 2);
+    return sprintf(out, "%04ld-%02d-%02d", year, month, day);
+}
+
+// ============================================================================
+// CSV ROWS
+// ============================================================================
+
+static const char csv_header_fields[] =
+    "student_id,name,level,attempted,correct,accuracy,study_minutes,streak,max_streak,last_practice,"
+    "predicted_exam_score,interview_ready_score,strongest_topic,weakest_topic";
+
+static void write_csv_header(FILE* fp) {
+    fputs(csv_header_fields, fp);
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        fprintf(fp, ",\"%s\"", c_topic_names[t]);
+    }
+    fputc('\n', fp);
+}
+
+// Appends one student's row to `out`, which has room for CSV_ROW_BYTES;
+// returns the bytes written
+static size_t format_csv_row(const Student* student, char* out) {
+    char* p = out;
+    p += sprintf(p, "%d,\"", student->student_id);
+    for (const char* c = student->name; *c && c < student->name + sizeof(student->name); c++) {
+        if (*c == '"') {
+            *p++ = '"';
+        }
+        *p++ = *c == '\n' || *c == '\r' ? ' ' : *c;
+    }
+    int strongest, weakest;
+    topic_extremes(student, &strongest, &weakest);
+    p += sprintf(p, "\",%s,%d,%d,%.4f,%d,%d,%d,", level_name(student->current_level),
+                 student->total_questions_attempted, student->total_questions_correct, student->overall_accuracy,
+                 student->total_study_time, student->learning_streak, student->max_streak);
+    p += student->last_practice > 0 ? format_date(p, student->last_practice) : 0;
+    p += sprintf(p, ",%.1f,%d,%s,%s", student->predicted_exam_score, student->interview_ready_score,
+                 strongest >= 0 ? c_topic_names[strongest] : "", weakest >= 0 ? c_topic_names[weakest] : "");
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        p += sprintf(p, ",%.4f", student->topic_scores[t]);
+    }
+    *p++ = '\n';
+    return (size_t)(p - out);
+}
+
+// ============================================================================
+// COLUMNAR ROW GROUPS
+// ============================================================================
+
+static void write_columnar_header(FILE* fp) {
+    uint32_t header[2] = { COLUMNAR_VERSION, COHORT_COLUMNS };
+    fwrite(COLUMNAR_MAGIC, 1, 8, fp);
+    fwrite(header, sizeof(uint32_t), 2, fp);
+
+    char name[32];
+    uint32_t type;
+    for (int c = 0; c < COHORT_COLUMNS; c++) {
+        memset(name, 0, sizeof(name));
+        if (c < COHORT_FIXED_COLUMNS) {
+            snprintf(name, sizeof(name), "%s", cohort_columns[c].name);
+            type = cohort_columns[c].type;
+        } else if (c < COHORT_FIXED_COLUMNS + NUM_C_TOPICS) {
+            snprintf(name, sizeof(name), "mastery_%d", c - COHORT_FIXED_COLUMNS);
+            type = COLUMN_FLOAT32;
+        } else {
+            snprintf(name, sizeof(name), "name");
+            type = COLUMN_STRING;
+        }
+        fwrite(name, 1, sizeof(name), fp);
+        fwrite(&type, sizeof(type), 1, fp);
+    }
+}
+
+// Lays out rows [first, first + rows) column by column in one pass over
+// the students; returns the bytes written
+static size_t format_row_group(int first, int rows, char* out) {
+    char* columns[COHORT_FIXED_COLUMNS + NUM_C_TOPICS];
+    char* p = out + 2 * sizeof(uint32_t);
+    for (int c = 0; c < COHORT_FIXED_COLUMNS + NUM_C_TOPICS; c++) {
+        columns[c] = p;
+        p += (size_t)rows * (c < COHORT_FIXED_COLUMNS && cohort_columns[c].type == COLUMN_INT64 ? 8 : 4);
+    }
+    char* offsets = p;
+    char* names = p + (size_t)rows * sizeof(uint32_t);
+    uint32_t name_bytes = 0;
+
+    for (int r = 0; r < rows; r++) {
+        const Student* student = get_student_at(first + r);
+        int strongest, weakest;
+        topic_extremes(student, &strongest, &weakest);
+        int32_t ints[] = { student->student_id, (int32_t)student->current_level,
+                           student->total_questions_attempted, student->total_questions_correct };
+        int32_t activity[] = { student->total_study_time, student->learning_streak, student->max_streak };
+        int64_t last_practice = student->last_practice;
+        int32_t ranks[] = { student->interview_ready_score, strongest, weakest };
+
+        memcpy(columns[0] + r * 4, &ints[0], 4);
+        memcpy(columns[1] + r * 4, &ints[1], 4);
+        memcpy(columns[2] + r * 4, &ints[2], 4);
+        memcpy(columns[3] + r * 4, &ints[3], 4);
+        memcpy(columns[4] + r * 4, &student->overall_accuracy, 4);
+        memcpy(columns[5] + r * 4, &activity[0], 4);
+        memcpy(columns[6] + r * 4, &activity[1], 4);
+        memcpy(columns[7] + r * 4, &activity[2], 4);
+        memcpy(columns[8] + r * 8, &last_practice, 8);
+        memcpy(columns[9] + r * 4, &student->predicted_exam_score, 4);
+        memcpy(columns[10] + r * 4, &ranks[0], 4);
+        memcpy(columns[11] + r * 4, &ranks[1], 4);
+        memcpy(columns[12] + r * 4, &ranks[2], 4);
+        for (int t = 0; t < NUM_C_TOPICS; t++) {
+            memcpy(columns[COHORT_FIXED_COLUMNS + t] + r * 4, &student->topic_scores[t], 4);
+        }
+
+        size_t length = strnlen(student->name, sizeof(student->name));
+        memcpy(names + name_bytes, student->name, length);
+        name_bytes += (uint32_t)length;
+        memcpy(offsets + r * sizeof(uint32_t), &name_bytes, sizeof(uint32_t));
+    }
+
+    uint32_t header[2] = { (uint32_t)rows, (uint32_t)(names + name_bytes - out - 2 * sizeof(uint32_t)) };
+    memcpy(out, header, sizeof(header));
+    return (size_t)(names + name_bytes - out);
+}
+
+// ============================================================================
+// COHORT EXPORT PIPELINE
+// ============================================================================
+
+// Formatted blocks wait in a ring of slots until the writer reaches them.
+// Block b always uses slot b % slot_count, so a worker holding block b
+// waits for block b - slot_count to be written (not merely for the slot to
+// be free, which a later block could take first). That keeps order without
+// a per-row queue.
+typedef struct {
+    char* data;
+    size_t length;
+    int block; // held block, or -1 when free
+    int ready;
+} ExportSlot;
+
+typedef struct {
+    ReportFormat format;
+    int students;
+    int blocks;
+    int next_block;
+    int written; // blocks the writer has finished with
+    ExportSlot* slots;
+    int slot_count;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} CohortExport;
+
+static size_t format_block(const CohortExport* export, int block, char* out) {
+    int first = block * EXPORT_BLOCK_ROWS;
+    int rows = export->students - first < EXPORT_BLOCK_ROWS ? export->students - first : EXPORT_BLOCK_ROWS;
+    if (export->format == REPORT_FORMAT_COLUMNAR) {
+        return format_row_group(first, rows, out);
+    }
+    size_t length = 0;
+    for (int r = 0; r < rows; r++) {
+        length += format_csv_row(get_student_at(first + r), out + length);
+    }
+    return length;
+}
+
+static void* export_worker_main(void* arg) {
+    CohortExport* export = arg;
+    pthread_mutex_lock(&export->lock);
+    while (export->next_block < export->blocks) {
+        int block = export->next_block++;
+        ExportSlot* slot = &export->slots[block % export->slot_count];
+        while (block >= export->written + export->slot_count) {
+            pthread_cond_wait(&export->changed, &export->lock);
+        }
+        slot->block = block;
+        pthread_mutex_unlock(&export->lock);
+
+        size_t length = format_block(export, block, slot->data);
+
+        pthread_mutex_lock(&export->lock);
+        slot->length = length;
+        slot->ready = 1;
+        pthread_cond_broadcast(&export->changed);
+    }
+    pthread_mutex_unlock(&export->lock);
+    return NULL;
+}
+
+// Exports every registered student, one row each in registration order.
+// Memory use depends on the worker count, not the cohort size. Students
+// must not be updated while the export runs. Returns the number of
+// students written, or -1 on failure.
+int export_cohort_report(const char* filename, const CohortExportOptions* options, CohortExportStats* stats) {
+    TRACE_SCOPE(TRACE_COHORT_EXPORT);
+    CohortExportOptions defaults = { REPORT_FORMAT_CSV, 1 };
+    if (!options) {
+        options = &defaults;
+    }
+    uint64_t started = trace_now();
+
+    // Each prediction depends on the whole cohort, so all are refreshed
+    // from one fit before any row is written
+    predict_cohort_exam_scores();
+
+    CohortExport export;
+    memset(&export, 0, sizeof(export));
+    export.format = options->format;
+    export.students = get_total_students();
+    export.blocks = (export.students + EXPORT_BLOCK_ROWS - 1) / EXPORT_BLOCK_ROWS;
+    int workers = options->worker_count < export.blocks ? options->worker_count : export.blocks;
+    if (workers < 1) {
+        workers = 1;
+    }
+    export.slot_count = workers > 1 ? 2 * workers : 1;
+    export.slots = calloc(export.slot_count, sizeof(ExportSlot));
+    size_t slot_bytes = (size_t)EXPORT_BLOCK_ROWS * CSV_ROW_BYTES;
+    int ok = export.slots != NULL;
+    for (int s = 0; ok && s < export.slot_count; s++) {
+        export.slots[s].block = -1;
+        export.slots[s].data = malloc(slot_bytes);
+        ok = export.slots[s].data != NULL;
+    }
+
+    FILE* fp = ok ? fopen(filename, export.format == REPORT_FORMAT_COLUMNAR ? "wb" : "w") : NULL;
+    char* buffer = fp ? malloc(EXPORT_WRITE_BUFFER) : NULL;
+    if (buffer) {
+        setvbuf(fp, buffer, _IOFBF, EXPORT_WRITE_BUFFER);
+    }
+    if (fp) {
+        if (export.format == REPORT_FORMAT_COLUMNAR) {
+            write_columnar_header(fp);
+        } else {
+            write_csv_header(fp);
+        }
+
+        if (workers == 1) {
+            for (int block = 0; block < export.blocks; block++) {
+                size_t length = format_block(&export, block, export.slots[0].data);
+                fwrite(export.slots[0].data, 1, length, fp);
+            }
+        } else {
+            pthread_mutex_init(&export.lock, NULL);
+            pthread_cond_init(&export.changed, NULL);
+            pthread_t* threads = malloc(workers * sizeof(pthread_t));
+            int started_threads = 0;
+            while (threads && started_threads < workers &&
+                   pthread_create(&threads[started_threads], NULL, export_worker_main, &export) == 0) {
+                started_threads++;
+            }
+            if (started_threads == 0) {
+                export_worker_main(&export);
+            }
+
+            for (int block = 0; block < export.blocks; block++) {
+                ExportSlot* slot = &export.slots[block % export.slot_count];
+                pthread_mutex_lock(&export.lock);
+                while (slot->block != block || !slot->ready) {
+                    pthread_cond_wait(&export.changed, &export.lock);
+                }
+                pthread_mutex_unlock(&export.lock);
+
+                fwrite(slot->data, 1, slot->length, fp);
+
+                pthread_mutex_lock(&export.lock);
+                slot->block = -1;
+                slot->ready = 0;
+                export.written++;
+                pthread_cond_broadcast(&export.changed);
+                pthread_mutex_unlock(&export.lock);
+            }
+            for (int i = 0; i < started_threads; i++) {
+                pthread_join(threads[i], NULL);
+            }
+            free(threads);
+            pthread_cond_destroy(&export.changed);
+            pthread_mutex_destroy(&export.lock);
+        }
+
+        if (export.format == REPORT_FORMAT_COLUMNAR) {
+            uint32_t end = 0;
+            fwrite(&end, sizeof(end), 1, fp);
+        }
+        long bytes = ftell(fp);
+        ok = !ferror(fp);
+        ok = fclose(fp) == 0 && ok;
+        if (stats) {
+            stats->students = export.students;
+            stats->bytes = bytes > 0 ? (size_t)bytes : 0;
+            stats->seconds = (trace_now() - started) / 1e9;
+        }
+    } else {
+        ok = 0;
+    }
+
+    free(buffer);
+    for (int s = 0; export.slots && s < export.slot_count; s++) {
+        free(export.slots[s].data);
+    }
+    free(export.slots);
+    return ok ? export.students : -1;
+}
+
+// ============================================================================
+// STUDENT REPORTS
+// ============================================================================
+
+void generate_detailed_report(Student* student, ProgressReport* report) {
+    memset(report, 0, sizeof(ProgressReport));
+    time_t now = time(NULL);
+    format_date(report->report_date, now);
+    report->total_questions_attempted = student->total_questions_attempted;
+    report->overall_accuracy = student->overall_accuracy;
+    report->study_time_minutes = student->total_study_time;
+    report->current_level = student->current_level;
+
+    int strongest, weakest;
+    topic_extremes(student, &strongest, &weakest);
+    snprintf(report->strongest_topic, sizeof(report->strongest_topic), "%s",
+             strongest >= 0 ? c_topic_names[strongest] : "None yet");
+    snprintf(report->weakest_topic, sizeof(report->weakest_topic), "%s",
+             weakest >= 0 ? c_topic_names[weakest] : "None yet");
+
+    int count = 0;
+    if (weakest >= 0 && weakest != strongest) {
+        snprintf(report->recommendations[count++], sizeof(report->recommendations[0]),
+                 "Practice %s (%.0f%% mastery)", c_topic_names[weakest], student->topic_scores[weakest] * 100.0f);
+    }
+    int due_slots[MAX_REVIEW_PEEK];
+    int due = review_due_questions(student->student_id, now, due_slots, MAX_REVIEW_PEEK);
+    if (due > 0) {
+        snprintf(report->recommendations[count++], sizeof(report->recommendations[0]),
+                 "Review %d%s question%s due for repetition", due, due == MAX_REVIEW_PEEK ? "+" : "",
+                 due == 1 ? "" : "s");
+    }
+    for (int t = 0; t < NUM_C_TOPICS && count < 3; t++) {
+        if (student->topic_questions_attempted[t] == 0) {
+            snprintf(report->recommendations[count++], sizeof(report->recommendations[0]), "Start on %s",
+                     c_topic_names[t]);
+            break;
+        }
+    }
+    // Days practised in a row, not learning_streak (correct answers in a row)
+    int practice_streak = get_practice_streak(student->student_id, now);
+    if (practice_streak > 0) {
+        snprintf(report->recommendations[count++], sizeof(report->recommendations[0]),
+                 "Keep your %d-day streak going", practice_streak);
+    } else {
+        snprintf(report->recommendations[count++], sizeof(report->recommendations[0]),
+                 "Practice today to start a new streak");
+    }
+    if (student->current_level < EXPERT) {
+        snprintf(report->recommendations[count++], sizeof(report->recommendations[0]), "Work toward %s level",
+                 level_name(student->current_level + 1));
+    }
+}
+
+// One student in the cohort export's CSV layout
+int export_csv_report(Student* student, const char* filename) {
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        return 0;
+    }
+    char row[CSV_ROW_BYTES];
+    write_csv_header(fp);
+    fwrite(row, 1, format_csv_row(student, row), fp);
+    return fclose(fp) == 0;
+}
+
+void export_progress_report(Student* student) {
+    ProgressReport report;
+    generate_detailed_report(student, &report);
+
+    printf("\n📄 Progress Report for %s (%s)\n", student->name, report.report_date);
+    printf("   Level: %s\n", level_name(report.current_level));
+    printf("   Answered: %d (%.1f%% correct)\n", report.total_questions_attempted, report.overall_accuracy * 100.0f);
+    printf("   Study time: %d minutes\n", report.study_time_minutes);
+    printf("   Strongest: %s\n", report.strongest_topic);
+    printf("   Weakest: %s\n", report.weakest_topic);
+    char topics[NUM_C_TOPICS * 32];
+    if (describe_topics(student, 0, topics, sizeof(topics)) > 0) {
+        printf("   Needs work: %s\n", topics);
+    }
+    for (int i = 0; i < 5 && report.recommendations[i][0]; i++) {
+        printf("   💡 %s\n", report.recommendations[i]);
+    }
+
+    char filename[MAX_STRING];
+    snprintf(filename, sizeof(filename), "data/report_%d.csv", student->student_id);
+    if (export_csv_report(student, filename)) {
+        printf("💾 Saved to %s\n", filename);
+    } else {
+        printf("❌ Could not write %s\n", filename);
+    }
+}
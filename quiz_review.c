@@ -0,0 +1,411 @@
+// quiz_review.c - Spaced-repetition scheduling for the C Programming Quiz System
+// SM-2 review state per (student, question), packed into 8 bytes, with a
+// per-student min-heap so the next due question is found without scanning
+
+#include "quiz_system.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// ============================================================================
+// SCHEDULING
+// ============================================================================
+
+#define REVIEW_RELEARN_MINUTES 10   // a missed question comes back this session
+#define REVIEW_DEFAULT_EASE 120     // SM-2's starting ease of 2.5
+#define REVIEW_MIN_TIMING_SAMPLES 20
+
+static uint32_t review_minutes(time_t when) {
+    return when <= REVIEW_EPOCH ? 0 : (uint32_t)((when - REVIEW_EPOCH) / 60);
+}
+
+time_t review_due_time(const ReviewState* state) {
+    return REVIEW_EPOCH + (time_t)state->due * 60;
+}
+
+// SM-2 grades recall from 0 to 5. A wrong answer is a lapse; a right one is
+// graded by speed against the question's own median time once it has one.
+static int review_quality(int slot, int is_correct, float time_taken) {
+    if (!is_correct) {
+        return 1;
+    }
+    const ResponseTimeSketch* sketch = get_question_response_sketch(slot);
+    if (sketch && sketch_count(sketch) >= REVIEW_MIN_TIMING_SAMPLES) {
+        float median = sketch_quantile(sketch, 0.50f);
+        if (time_taken <= median * 0.5f) {
+            return 5;
+        }
+        if (time_taken > median * 2.0f) {
+            return 3;
+        }
+    }
+    return 4;
+}
+
+static void review_schedule(ReviewState* state, int quality, time_t when) {
+    uint32_t minutes;
+    if (quality < 3) {
+        state->reps = 0;
+        state->interval = 0;
+        minutes = REVIEW_RELEARN_MINUTES;
+    } else {
+        // EF' = EF + 0.1 - (5 - q) * (0.08 + (5 - q) * 0.02), in hundredths
+        int miss = 5 - quality;
+        int ease = state->ease + 10 - miss * (8 + miss * 2);
+        state->ease = ease < 0 ? 0 : ease > UINT8_MAX ? UINT8_MAX : ease;
+
+        unsigned long hours = state->reps == 0   ? 24
+                              : state->reps == 1 ? 6 * 24
+                                                 : (state->interval * (130ul + state->ease) + 50) / 100;
+        state->interval = hours > UINT16_MAX ? UINT16_MAX : (uint16_t)hours;
+        if (state->reps < UINT8_MAX) {
+            state->reps++;
+        }
+        minutes = state->interval * 60u;
+    }
+    state->due = review_minutes(when) + minutes;
+}
+
+// ============================================================================
+// REVIEW DECKS
+// ============================================================================
+
+// One deck per student. Items are appended on a question's first answer and
+// never removed, so an item index is stable; the heap orders items by due
+// time and heap_pos lets an answered item be re-sifted in place.
+typedef struct {
+    int student_id;
+    ReviewState* states; // by item
+    int* slots;          // item -> question slot
+    int* heap;           // items, earliest due first
+    int* heap_pos;       // item -> position in heap
+    int count;
+    int capacity;
+    IdMap items;         // question slot -> item
+} ReviewDeck;
+
+static ChunkedArray decks = { sizeof(ReviewDeck), 256, 0, NULL, 0, 0 };
+static IdMap deck_index; // student_id -> deck
+
+static ReviewDeck* find_deck(int student_id, int create) {
+    int index = id_map_get(&deck_index, student_id);
+    if (index >= 0) {
+        return chunked_array_at(&decks, index);
+    }
+    if (!create) {
+        return NULL;
+    }
+
+    index = decks.count;
+    ReviewDeck* deck = chunked_array_push(&decks);
+    if (!deck) {
+        return NULL;
+    }
+    memset(deck, 0, sizeof(ReviewDeck));
+    deck->student_id = student_id;
+    id_map_put(&deck_index, student_id, index);
+    return deck;
+}
+
+static int heap_before(const ReviewDeck* deck, int a, int b) {
+    uint32_t due_a = deck->states[a].due;
+    uint32_t due_b = deck->states[b].due;
+    return due_a < due_b || (due_a == due_b && a < b);
+}
+
+static void heap_place(ReviewDeck* deck, int position, int item) {
+    deck->heap[position] = item;
+    deck->heap_pos[item] = position;
+}
+
+// A review can move an item's due time either way, so it is sifted both
+static void heap_fix(ReviewDeck* deck, int position) {
+    int item = deck->heap[position];
+    while (position > 0) {
+        int parent = (position - 1) / 2;
+        if (!heap_before(deck, item, deck->heap[parent])) {
+            break;
+        }
+        heap_place(deck, position, deck->heap[parent]);
+        position = parent;
+    }
+    for (;;) {
+        int child = 2 * position + 1;
+        if (child >= deck->count) {
+            break;
+        }
+        if (child + 1 < deck->count && heap_before(deck, deck->heap[child + 1], deck->heap[child])) {
+            child++;
+        }
+        if (!heap_before(deck, deck->heap[child], item)) {
+            break;
+        }
+        heap_place(deck, position, deck->heap[child]);
+        position = child;
+    }
+    heap_place(deck, position, item);
+}
+
+static int deck_grow(ReviewDeck* deck) {
+    int capacity = deck->capacity ? deck->capacity * 2 : 16;
+    ReviewState* states = realloc(deck->states, capacity * sizeof(ReviewState));
+    if (states) {
+        deck->states = states;
+    }
+    int* slots = realloc(deck->slots, capacity * sizeof(int));
+    if (slots) {
+        deck->slots = slots;
+    }
+    int* heap = realloc(deck->heap, capacity * sizeof(int));
+    if (heap) {
+        deck->heap = heap;
+    }
+    int* heap_pos = realloc(deck->heap_pos, capacity * sizeof(int));
+    if (heap_pos) {
+        deck->heap_pos = heap_pos;
+    }
+    if (!states || !slots || !heap || !heap_pos) {
+        return 0;
+    }
+    deck->capacity = capacity;
+    return 1;
+}
+
+// Returns the item for a slot, adding a new one due at `when` if needed
+static int deck_item(ReviewDeck* deck, int slot, const ReviewState* initial) {
+    int item = id_map_get(&deck->items, slot);
+    if (item >= 0) {
+        return item;
+    }
+    if (deck->count == deck->capacity && !deck_grow(deck)) {
+        return -1;
+    }
+    item = deck->count++;
+    deck->states[item] = *initial;
+    deck->slots[item] = slot;
+    heap_place(deck, item, item);
+    heap_fix(deck, item);
+    id_map_put(&deck->items, slot, item);
+    return item;
+}
+
+static ReviewState new_review_state(time_t when) {
+    ReviewState state = { review_minutes(when), 0, REVIEW_DEFAULT_EASE, 0 };
+    return state;
+}
+
+// O(log n) in the student's deck size
+void review_record_answer(int student_id, int slot, int is_correct, float time_taken, time_t when) {
+    ReviewDeck* deck = find_deck(student_id, 1);
+    ReviewState initial = new_review_state(when);
+    int item = deck ? deck_item(deck, slot, &initial) : -1;
+    if (item < 0) {
+        return;
+    }
+    review_schedule(&deck->states[item], review_quality(slot, is_correct, time_taken), when);
+    heap_fix(deck, deck->heap_pos[item]);
+}
+
+// Slot of the student's most overdue question, or -1 if nothing is due
+int review_next_due(int student_id, time_t now) {
+    ReviewDeck* deck = find_deck(student_id, 0);
+    if (!deck || deck->count == 0 || deck->states[deck->heap[0]].due > review_minutes(now)) {
+        return -1;
+    }
+    return deck->slots[deck->heap[0]];
+}
+
+// Up to max due slots, most overdue first. Only due items and their direct
+// children are visited, so the cost follows the result size, not the deck.
+int review_due_questions(int student_id, time_t now, int* slots, int max) {
+    ReviewDeck* deck = find_deck(student_id, 0);
+    uint32_t cutoff = review_minutes(now);
+    if (!deck || deck->count == 0 || max <= 0 || deck->states[deck->heap[0]].due > cutoff) {
+        return 0;
+    }
+
+    // Best-first walk down the heap with a small heap of frontier positions
+    int* frontier = malloc((2 * (size_t)max + 1) * sizeof(int));
+    if (!frontier) {
+        return 0;
+    }
+    int frontier_count = 1;
+    int found = 0;
+    frontier[0] = 0;
+    while (frontier_count > 0 && found < max) {
+        int position = frontier[0];
+        frontier[0] = frontier[--frontier_count];
+        for (int i = 0;;) {
+            int child = 2 * i + 1;
+            if (child >= frontier_count) {
+                break;
+            }
+            if (child + 1 < frontier_count &&
+                heap_before(deck, deck->heap[frontier[child + 1]], deck->heap[frontier[child]])) {
+                child++;
+            }
+            if (!heap_before(deck, deck->heap[frontier[child]], deck->heap[frontier[i]])) {
+                break;
+            }
+            int swap = frontier[i];
+            frontier[i] = frontier[child];
+            frontier[child] = swap;
+            i = child;
+        }
+
+        slots[found++] = deck->slots[deck->heap[position]];
+        for (int c = 2 * position + 1; c <= 2 * position + 2 && c < deck->count; c++) {
+            if (deck->states[deck->heap[c]].due > cutoff) {
+                continue;
+            }
+            int i = frontier_count++;
+            frontier[i] = c;
+            while (i > 0 && heap_before(deck, deck->heap[frontier[i]], deck->heap[frontier[(i - 1) / 2]])) {
+                int swap = frontier[i];
+                frontier[i] = frontier[(i - 1) / 2];
+                frontier[(i - 1) / 2] = swap;
+                i = (i - 1) / 2;
+            }
+        }
+    }
+    free(frontier);
+    return found;
+}
+
+int get_review_state(int student_id, int slot, ReviewState* state) {
+    ReviewDeck* deck = find_deck(student_id, 0);
+    int item = deck ? id_map_get(&deck->items, slot) : -1;
+    if (item < 0) {
+        return 0;
+    }
+    *state = deck->states[item];
+    return 1;
+}
+
+int get_review_deck_size(int student_id) {
+    ReviewDeck* deck = find_deck(student_id, 0);
+    return deck ? deck->count : 0;
+}
+
+void reset_review_decks(void) {
+    for (int i = 0; i < decks.count; i++) {
+        ReviewDeck* deck = chunked_array_at(&decks, i);
+        free(deck->states);
+        free(deck->slots);
+        free(deck->heap);
+        free(deck->heap_pos);
+        id_map_free(&deck->items);
+    }
+    chunked_array_free(&decks);
+    id_map_free(&deck_index);
+}
+
+// ============================================================================
+// PERSISTENCE
+// ============================================================================
+
+// data/reviews.dat: a header, then one entry per (student, question) pair.
+// Questions are stored by id so the file survives a reordered bank. It is
+// written at each progress log checkpoint; answers logged after its
+// checkpoint LSN are replayed into it on startup.
+#define REVIEWS_MAGIC "CQREVIEW"
+#define REVIEWS_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t entries_checksum;
+    uint32_t reserved;
+    uint64_t checkpoint_lsn; // last progress log record reflected here
+} ReviewFileHeader;
+
+typedef struct {
+    int32_t student_id;
+    int32_t question_id;
+    ReviewState state;
+} ReviewFileEntry;
+
+static uint64_t loaded_checkpoint_lsn = 0;
+
+int save_review_decks(const char* filename, uint64_t checkpoint_lsn) {
+    char temp_path[MAX_STRING + 8];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", filename);
+    FILE* fp = fopen(temp_path, "wb");
+    if (!fp) {
+        return 0;
+    }
+
+    ReviewFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REVIEWS_MAGIC, sizeof(header.magic));
+    header.version = REVIEWS_VERSION;
+    header.entries_checksum = 2166136261u;
+    header.checkpoint_lsn = checkpoint_lsn;
+
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    QuestionHotTable* hot = get_question_hot_table();
+    for (int d = 0; ok && d < decks.count; d++) {
+        ReviewDeck* deck = chunked_array_at(&decks, d);
+        for (int i = 0; ok && i < deck->count; i++) {
+            ReviewFileEntry entry = { deck->student_id, hot->id[deck->slots[i]], deck->states[i] };
+            header.entries_checksum = checksum_update(header.entries_checksum, &entry, sizeof(entry));
+            header.entry_count++;
+            ok = fwrite(&entry, sizeof(entry), 1, fp) == 1;
+        }
+    }
+    ok = ok && fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1 &&
+         fflush(fp) == 0;
+#ifndef _WIN32
+    ok = ok && fsync(fileno(fp)) == 0;
+#endif
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(temp_path, filename) != 0) {
+        remove(temp_path);
+        return 0;
+    }
+    return 1;
+}
+
+// Returns how many review states were restored, or -1 if the file exists
+// but is unusable. Entries for questions no longer in the bank are dropped.
+int load_review_decks(const char* filename) {
+    loaded_checkpoint_lsn = 0;
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) {
+        return 0;
+    }
+
+    ReviewFileHeader header;
+    int ok = fread(&header, sizeof(header), 1, fp) == 1 &&
+             memcmp(header.magic, REVIEWS_MAGIC, sizeof(header.magic)) == 0 &&
+             header.version == REVIEWS_VERSION;
+    ReviewFileEntry* entries = ok ? malloc((size_t)header.entry_count * sizeof(ReviewFileEntry) + 1) : NULL;
+    ok = entries && fread(entries, sizeof(ReviewFileEntry), header.entry_count, fp) == header.entry_count &&
+         checksum_update(2166136261u, entries, (size_t)header.entry_count * sizeof(ReviewFileEntry)) ==
+             header.entries_checksum;
+    fclose(fp);
+    if (!ok) {
+        free(entries);
+        return -1;
+    }
+
+    reset_review_decks();
+    loaded_checkpoint_lsn = header.checkpoint_lsn;
+    int restored = 0;
+    for (uint32_t i = 0; i < header.entry_count; i++) {
+        int slot = find_question_slot(entries[i].question_id);
+        ReviewDeck* deck = slot >= 0 ? find_deck(entries[i].student_id, 1) : NULL;
+        if (deck && deck_item(deck, slot, &entries[i].state) >= 0) {
+            restored++;
+        }
+    }
+    free(entries);
+    return restored;
+}
+
+// Progress log records at or below this are already in the loaded decks
+uint64_t get_review_checkpoint_lsn(void) {
+    return loaded_checkpoint_lsn;
+}
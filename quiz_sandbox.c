@@ -0,0 +1,956 @@
+// quiz_sandbox.c - Code snippet execution for the C Programming Quiz System
+// Compiles snippets with the system compiler and runs them in child
+// processes under resource limits and a syscall filter. Binaries and
+// results are cached by SHA-256 of their content, so identical code is
+// built once and different code never shares a build.
+
+#define _GNU_SOURCE
+
+#include "quiz_system.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/audit.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <stddef.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#endif
+
+#define SANDBOX_OUTPUT_CACHE_MAX 4096
+#define SANDBOX_COMPILE_CPU_SECONDS 30
+#define SANDBOX_COMPILE_WALL_MS 60000
+#define SANDBOX_COMPILE_MEMORY (1024u * 1024u * 1024u)
+#define SANDBOX_COMPILE_OUTPUT 16384
+#define SANDBOX_BINARY_SIZE (64u * 1024u * 1024u)
+
+static const SandboxLimits default_sandbox_limits = { 2, 5000, 256u * 1024u * 1024u, 64u * 1024u };
+
+// ============================================================================
+// CONTENT-HASH TABLES
+// ============================================================================
+
+// Open addressing on SHA-256 digests, probed from their first bytes; a
+// NULL value marks an empty slot. A hit compares the whole digest.
+typedef struct {
+    Sha256Digest* keys;
+    void** values;
+    int capacity;
+    int count;
+} HashTable;
+
+static uint64_t digest_bucket(const Sha256Digest* key) {
+    uint64_t bucket;
+    memcpy(&bucket, key->bytes, sizeof(bucket));
+    return bucket;
+}
+
+static int same_key(const Sha256Digest* a, const Sha256Digest* b) {
+    return memcmp(a->bytes, b->bytes, SHA256_DIGEST_SIZE) == 0;
+}
+
+static void* hash_table_get(const HashTable* table, const Sha256Digest* key) {
+    if (table->capacity == 0) {
+        return NULL;
+    }
+    for (int i = (int)(digest_bucket(key) & (table->capacity - 1));; i = (i + 1) & (table->capacity - 1)) {
+        if (!table->values[i]) {
+            return NULL;
+        }
+        if (same_key(&table->keys[i], key)) {
+            return table->values[i];
+        }
+    }
+}
+
+static int hash_table_put(HashTable* table, const Sha256Digest* key, void* value) {
+    if ((table->count + 1) * 2 > table->capacity) {
+        int capacity = table->capacity ? table->capacity * 2 : 64;
+        Sha256Digest* keys = calloc(capacity, sizeof(Sha256Digest));
+        void** values = calloc(capacity, sizeof(void*));
+        if (!keys || !values) {
+            free(keys);
+            free(values);
+            return 0;
+        }
+        for (int i = 0; i < table->capacity; i++) {
+            if (table->values[i]) {
+                int j = (int)(digest_bucket(&table->keys[i]) & (capacity - 1));
+                while (values[j]) {
+                    j = (j + 1) & (capacity - 1);
+                }
+                keys[j] = table->keys[i];
+                values[j] = table->values[i];
+            }
+        }
+        free(table->keys);
+        free(table->values);
+        table->keys = keys;
+        table->values = values;
+        table->capacity = capacity;
+    }
+    int i = (int)(digest_bucket(key) & (table->capacity - 1));
+    while (table->values[i] && !same_key(&table->keys[i], key)) {
+        i = (i + 1) & (table->capacity - 1);
+    }
+    if (!table->values[i]) {
+        table->count++;
+    }
+    table->keys[i] = *key;
+    table->values[i] = value;
+    return 1;
+}
+
+static void hash_table_free(HashTable* table, void (*free_value)(void*)) {
+    for (int i = 0; i < table->capacity; i++) {
+        if (table->values[i]) {
+            free_value(table->values[i]);
+        }
+    }
+    free(table->keys);
+    free(table->values);
+    memset(table, 0, sizeof(HashTable));
+}
+
+// ============================================================================
+// SANDBOX STATE
+// ============================================================================
+
+typedef enum {
+    BINARY_BUILDING,
+    BINARY_BUILT,
+    BINARY_FAILED
+} BinaryState;
+
+typedef struct {
+    BinaryState state;
+    SandboxStatus failure; // COMPILE_ERROR or SETUP_ERROR when FAILED
+    char* diagnostics;
+} BinaryEntry;
+
+static pthread_mutex_t sandbox_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t binary_ready = PTHREAD_COND_INITIALIZER;
+static int sandbox_ready = 0;
+static char sandbox_dir[MAX_STRING];
+static const char* sandbox_compiler = "cc";
+static SandboxLimits sandbox_limits;
+static SandboxStats sandbox_stats;
+static HashTable binaries = { NULL, NULL, 0, 0 };
+static HashTable results = { NULL, NULL, 0, 0 }; // SandboxResult by binary and input
+
+static void free_binary_entry(void* value) {
+    BinaryEntry* entry = value;
+    free(entry->diagnostics);
+    free(entry);
+}
+
+static void free_cached_result(void* value) {
+    sandbox_result_free(value);
+    free(value);
+}
+
+static char* copy_text(const char* text, size_t length) {
+    char* copy = malloc(length + 1);
+    if (copy) {
+        memcpy(copy, text, length);
+        copy[length] = '\0';
+    }
+    return copy;
+}
+
+// ============================================================================
+// SYSCALL FILTER
+// ============================================================================
+
+#ifdef __linux__
+#if defined(__x86_64__)
+#define SANDBOX_AUDIT_ARCH AUDIT_ARCH_X86_64
+#elif defined(__aarch64__)
+#define SANDBOX_AUDIT_ARCH AUDIT_ARCH_AARCH64
+#endif
+#endif
+
+#ifdef SANDBOX_AUDIT_ARCH
+#define SECCOMP_ALLOW(nr) \
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, (nr), 0, 1), BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW)
+#define SECCOMP_WRITE_FLAGS (O_WRONLY | O_RDWR | O_CREAT | O_TRUNC | O_APPEND)
+#define SECCOMP_SELF_PID 0xFFFFFFFFu // replaced by the child's pid before loading
+#define SECCOMP_ARG_LOW(n) offsetof(struct seccomp_data, args[n]) // low half, little-endian targets
+
+// Programs may compute, print, read files and signal themselves (abort,
+// raise), nothing more. Only the calls listed are allowed: no new processes
+// or threads, no sockets, no writes or changes to the file system and no
+// ioctls (which could push input into a terminal). execve stays allowed as
+// the filter is loaded before the program itself is exec'd. Denied calls
+// fail with EPERM rather than killing the program, so its output still
+// explains what went wrong.
+static struct sock_filter sandbox_filter[] = {
+    BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, arch)),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, SANDBOX_AUDIT_ARCH, 1, 0),
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_KILL_PROCESS),
+    BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr)),
+#ifdef __x86_64__
+    BPF_JUMP(BPF_JMP | BPF_JGE | BPF_K, 0x40000000, 0, 1), // x32 calls
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_KILL_PROCESS),
+    // open(path, flags): read-only opens only
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_open, 0, 4),
+    BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SECCOMP_ARG_LOW(1)),
+    BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, SECCOMP_WRITE_FLAGS, 0, 1),
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | EPERM),
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW),
+#endif
+    // openat(dir, path, flags): likewise
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_openat, 0, 4),
+    BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SECCOMP_ARG_LOW(2)),
+    BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, SECCOMP_WRITE_FLAGS, 0, 1),
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | EPERM),
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW),
+#ifdef __NR_openat2
+    // Its flags are behind a pointer the filter cannot read; libc falls
+    // back to openat on ENOSYS
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_openat2, 0, 1),
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | ENOSYS),
+#endif
+    // tgkill(tgid, tid, sig) and tkill(tid, sig), at the program itself
+    // only; it has a single thread, so its tid is its pid
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_tgkill, 1, 0),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_tkill, 0, 4),
+    BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SECCOMP_ARG_LOW(0)),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, SECCOMP_SELF_PID, 0, 1),
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW),
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | EPERM),
+
+    SECCOMP_ALLOW(__NR_read), SECCOMP_ALLOW(__NR_write), SECCOMP_ALLOW(__NR_readv),
+    SECCOMP_ALLOW(__NR_writev), SECCOMP_ALLOW(__NR_pread64), SECCOMP_ALLOW(__NR_lseek),
+    SECCOMP_ALLOW(__NR_close), SECCOMP_ALLOW(__NR_fstat), SECCOMP_ALLOW(__NR_newfstatat),
+    SECCOMP_ALLOW(__NR_faccessat), SECCOMP_ALLOW(__NR_readlinkat), SECCOMP_ALLOW(__NR_getcwd),
+    SECCOMP_ALLOW(__NR_getdents64), SECCOMP_ALLOW(__NR_fcntl), SECCOMP_ALLOW(__NR_dup),
+    SECCOMP_ALLOW(__NR_dup3), SECCOMP_ALLOW(__NR_mmap), SECCOMP_ALLOW(__NR_mprotect),
+    SECCOMP_ALLOW(__NR_munmap), SECCOMP_ALLOW(__NR_mremap), SECCOMP_ALLOW(__NR_madvise),
+    SECCOMP_ALLOW(__NR_brk), SECCOMP_ALLOW(__NR_rt_sigaction), SECCOMP_ALLOW(__NR_rt_sigprocmask),
+    SECCOMP_ALLOW(__NR_rt_sigreturn), SECCOMP_ALLOW(__NR_sigaltstack), SECCOMP_ALLOW(__NR_set_tid_address),
+    SECCOMP_ALLOW(__NR_set_robust_list), SECCOMP_ALLOW(__NR_prlimit64), SECCOMP_ALLOW(__NR_getrlimit),
+    SECCOMP_ALLOW(__NR_futex), SECCOMP_ALLOW(__NR_sched_yield), SECCOMP_ALLOW(__NR_sched_getaffinity),
+    SECCOMP_ALLOW(__NR_nanosleep), SECCOMP_ALLOW(__NR_clock_nanosleep), SECCOMP_ALLOW(__NR_clock_gettime),
+    SECCOMP_ALLOW(__NR_clock_getres), SECCOMP_ALLOW(__NR_gettimeofday), SECCOMP_ALLOW(__NR_getpid),
+    SECCOMP_ALLOW(__NR_gettid), SECCOMP_ALLOW(__NR_getppid), SECCOMP_ALLOW(__NR_getuid),
+    SECCOMP_ALLOW(__NR_geteuid), SECCOMP_ALLOW(__NR_getgid), SECCOMP_ALLOW(__NR_getegid),
+    SECCOMP_ALLOW(__NR_uname), SECCOMP_ALLOW(__NR_sysinfo), SECCOMP_ALLOW(__NR_times),
+    SECCOMP_ALLOW(__NR_getrusage), SECCOMP_ALLOW(__NR_execve), SECCOMP_ALLOW(__NR_exit),
+    SECCOMP_ALLOW(__NR_exit_group), SECCOMP_ALLOW(__NR_restart_syscall),
+#ifdef __NR_statx
+    SECCOMP_ALLOW(__NR_statx),
+#endif
+#ifdef __NR_faccessat2
+    SECCOMP_ALLOW(__NR_faccessat2),
+#endif
+#ifdef __NR_rseq
+    SECCOMP_ALLOW(__NR_rseq),
+#endif
+#ifdef __NR_getrandom
+    SECCOMP_ALLOW(__NR_getrandom),
+#endif
+#ifdef __x86_64__
+    SECCOMP_ALLOW(__NR_access), SECCOMP_ALLOW(__NR_stat), SECCOMP_ALLOW(__NR_lstat),
+    SECCOMP_ALLOW(__NR_readlink), SECCOMP_ALLOW(__NR_arch_prctl), SECCOMP_ALLOW(__NR_time),
+    SECCOMP_ALLOW(__NR_dup2), SECCOMP_ALLOW(__NR_getdents),
+#endif
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | EPERM),
+};
+#endif
+
+// ============================================================================
+// CHILD PROCESSES
+// ============================================================================
+
+typedef struct {
+    char* output;
+    size_t length;
+    int exited;
+    int exit_code;
+    int signal;
+    int timed_out;
+    int truncated;
+    double ms;
+} ChildResult;
+
+static void set_limit(int resource, rlim_t soft, rlim_t hard) {
+    struct rlimit limit = { soft, hard };
+    setrlimit(resource, &limit);
+}
+
+// Runs in the forked child; only async-signal-safe calls until exec
+static void child_main(char* const argv[], int input_fd, int output_fd, const SandboxLimits* limits,
+                       size_t file_size, int confined) {
+    setpgid(0, 0);
+    dup2(input_fd, STDIN_FILENO);
+    dup2(output_fd, STDOUT_FILENO);
+    dup2(output_fd, STDERR_FILENO);
+    for (int fd = 3; fd < 1024; fd++) {
+        close(fd);
+    }
+    signal(SIGPIPE, SIG_DFL);
+    if (chdir(sandbox_dir) != 0) {
+        _exit(126);
+    }
+
+    set_limit(RLIMIT_CPU, (rlim_t)limits->cpu_seconds, (rlim_t)limits->cpu_seconds + 1);
+    set_limit(RLIMIT_AS, (rlim_t)limits->memory_bytes, (rlim_t)limits->memory_bytes);
+    set_limit(RLIMIT_FSIZE, (rlim_t)file_size, (rlim_t)file_size);
+    set_limit(RLIMIT_CORE, 0, 0);
+    if (confined) {
+        set_limit(RLIMIT_NOFILE, 16, 16);
+    }
+#ifdef __linux__
+    prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0);
+#ifdef SANDBOX_AUDIT_ARCH
+    if (confined) {
+        // The filter is this process's copy, so patching it is safe after fork
+        size_t length = sizeof(sandbox_filter) / sizeof(sandbox_filter[0]);
+        for (size_t i = 0; i < length; i++) {
+            if (sandbox_filter[i].code == (BPF_JMP | BPF_JEQ | BPF_K) && sandbox_filter[i].k == SECCOMP_SELF_PID) {
+                sandbox_filter[i].k = (uint32_t)getpid();
+            }
+        }
+        struct sock_fprog program = { (unsigned short)length, sandbox_filter };
+        if (prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &program) != 0) {
+            _exit(126);
+        }
+    }
+#endif
+#endif
+    execvp(argv[0], argv);
+    _exit(127);
+}
+
+// Feeds `input` to the child and collects its output until it exits, runs
+// out of wall-clock time or exceeds output_bytes; the whole process group
+// is killed in the last two cases. Closing its output does not stop the
+// clock: a child still running at the deadline is killed. Returns 0 if the child never started.
+static int run_child(char* const argv[], const char* input, const SandboxLimits* limits, size_t file_size,
+                     int confined, ChildResult* child) {
+    memset(child, 0, sizeof(ChildResult));
+    int input_pipe[2];
+    int output_pipe[2];
+    if (pipe(input_pipe) != 0) {
+        return 0;
+    }
+    if (pipe(output_pipe) != 0) {
+        close(input_pipe[0]);
+        close(input_pipe[1]);
+        return 0;
+    }
+
+    uint64_t started = trace_now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        child_main(argv, input_pipe[0], output_pipe[1], limits, file_size, confined);
+    }
+    close(input_pipe[0]);
+    close(output_pipe[1]);
+    if (pid < 0) {
+        close(input_pipe[1]);
+        close(output_pipe[0]);
+        return 0;
+    }
+    setpgid(pid, pid);
+
+    size_t input_length = input ? strlen(input) : 0;
+    size_t written = 0;
+    int input_fd = input_pipe[1];
+    fcntl(input_fd, F_SETFL, O_NONBLOCK);
+    if (input_length == 0) {
+        close(input_fd);
+        input_fd = -1;
+    }
+
+    size_t capacity = 4096;
+    child->output = malloc(capacity);
+    uint64_t deadline = started + (uint64_t)limits->wall_ms * 1000000u;
+    while (child->output) {
+        uint64_t now = trace_now();
+        if (now >= deadline) {
+            child->timed_out = 1;
+            break;
+        }
+        struct pollfd fds[2] = { { output_pipe[0], POLLIN, 0 }, { input_fd, POLLOUT, 0 } };
+        int ready = poll(fds, input_fd >= 0 ? 2 : 1, (int)((deadline - now) / 1000000u) + 1);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        if (input_fd >= 0 && (fds[1].revents & (POLLOUT | POLLERR | POLLHUP))) {
+            ssize_t n = write(input_fd, input + written, input_length - written);
+            if (n > 0) {
+                written += (size_t)n;
+            }
+            if (n < 0 ? errno != EAGAIN : written == input_length) {
+                close(input_fd);
+                input_fd = -1;
+            }
+        }
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            if (child->length + 4096 > capacity) {
+                char* grown = realloc(child->output, capacity * 2);
+                if (!grown) {
+                    break;
+                }
+                child->output = grown;
+                capacity *= 2;
+            }
+            ssize_t n = read(output_pipe[0], child->output + child->length, capacity - child->length - 1);
+            if (n == 0 || (n < 0 && errno != EINTR && errno != EAGAIN)) {
+                break;
+            }
+            if (n > 0) {
+                child->length += (size_t)n;
+                if (child->length > limits->output_bytes) {
+                    child->length = limits->output_bytes;
+                    child->truncated = 1;
+                    break;
+                }
+            }
+        }
+    }
+    if (child->timed_out || child->truncated || !child->output) {
+        kill(-pid, SIGKILL);
+    }
+    if (input_fd >= 0) {
+        close(input_fd);
+    }
+    close(output_pipe[0]);
+
+    int status = 0;
+    for (;;) {
+        pid_t done = waitpid(pid, &status, WNOHANG);
+        if (done == pid || (done < 0 && errno != EINTR)) {
+            break;
+        }
+        if (done == 0 && trace_now() >= deadline) {
+            child->timed_out = 1;
+            kill(-pid, SIGKILL);
+            while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+            }
+            break;
+        }
+        poll(NULL, 0, 1);
+    }
+    child->ms = (trace_now() - started) / 1e6;
+    if (child->output) {
+        child->output[child->length] = '\0';
+    }
+    if (WIFEXITED(status)) {
+        child->exited = 1;
+        child->exit_code = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        child->signal = WTERMSIG(status);
+        child->timed_out |= child->signal == SIGXCPU;
+    }
+    return child->output != NULL;
+}
+
+// ============================================================================
+// COMPILING
+// ============================================================================
+
+static void digest_to_hex(const Sha256Digest* key, char hex[SHA256_DIGEST_SIZE * 2 + 1]) {
+    for (int i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        snprintf(hex + 2 * i, 3, "%02x", key->bytes[i]);
+    }
+}
+
+// Builds the binary for `key` unless this or an earlier process already
+// has. Concurrent requests for the same source wait for one build. The
+// binary is named by the full digest, so one on disk is reused only for
+// the same compiler and source.
+static BinaryEntry* ensure_binary(const Sha256Digest* key, const char* source, int* cached) {
+    pthread_mutex_lock(&sandbox_lock);
+    BinaryEntry* entry;
+    while ((entry = hash_table_get(&binaries, key)) && entry->state == BINARY_BUILDING) {
+        pthread_cond_wait(&binary_ready, &sandbox_lock);
+    }
+    if (entry) {
+        sandbox_stats.compile_cache_hits++;
+        pthread_mutex_unlock(&sandbox_lock);
+        *cached = 1;
+        return entry;
+    }
+    entry = calloc(1, sizeof(BinaryEntry));
+    if (!entry || !hash_table_put(&binaries, key, entry)) {
+        free(entry);
+        pthread_mutex_unlock(&sandbox_lock);
+        return NULL;
+    }
+    pthread_mutex_unlock(&sandbox_lock);
+
+    char hex[SHA256_DIGEST_SIZE * 2 + 1];
+    digest_to_hex(key, hex);
+    char path[MAX_STRING + 96];
+    snprintf(path, sizeof(path), "%s/%s", sandbox_dir, hex);
+    BinaryState state = BINARY_BUILT;
+    SandboxStatus failure = SANDBOX_OK;
+    char* diagnostics = NULL;
+    *cached = file_exists(path);
+    if (!*cached) {
+        // The compiler reads the source from stdin and writes a temporary
+        // that is renamed into place, so a binary is never seen half-written
+        char temp_name[SHA256_DIGEST_SIZE * 2 + 32];
+        snprintf(temp_name, sizeof(temp_name), "%s.%ld.tmp", hex, (long)getpid());
+        char* argv[] = { (char*)sandbox_compiler, "-std=c11", "-O0", "-w", "-x", "c", "-o", temp_name, "-", "-lm",
+                         NULL };
+        SandboxLimits limits = { SANDBOX_COMPILE_CPU_SECONDS, SANDBOX_COMPILE_WALL_MS, SANDBOX_COMPILE_MEMORY,
+                                 SANDBOX_COMPILE_OUTPUT };
+        char temp_path[MAX_STRING + 160];
+        snprintf(temp_path, sizeof(temp_path), "%s/%s", sandbox_dir, temp_name);
+
+        ChildResult child;
+        if (!run_child(argv, source, &limits, SANDBOX_BINARY_SIZE, 0, &child) || !child.exited ||
+            child.exit_code == 126 || child.exit_code == 127) {
+            state = BINARY_FAILED;
+            failure = SANDBOX_SETUP_ERROR;
+            diagnostics = child.output;
+        } else if (child.exit_code != 0 || rename(temp_path, path) != 0) {
+            state = BINARY_FAILED;
+            failure = SANDBOX_COMPILE_ERROR;
+            diagnostics = child.output;
+        } else {
+            free(child.output);
+        }
+        if (state == BINARY_FAILED) {
+            remove(temp_path);
+        }
+    }
+
+    pthread_mutex_lock(&sandbox_lock);
+    entry->state = state;
+    entry->failure = failure;
+    entry->diagnostics = diagnostics;
+    sandbox_stats.compiles += !*cached;
+    sandbox_stats.compile_cache_hits += *cached;
+    pthread_cond_broadcast(&binary_ready);
+    pthread_mutex_unlock(&sandbox_lock);
+    return entry;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+// Binaries are kept in cache_dir across runs. NULL limits use 2 CPU
+// seconds, 5 s wall time, 256 MiB of address space and 64 KiB of output.
+// The compiler is $QUIZ_CC, or cc.
+int sandbox_init(const char* cache_dir, const SandboxLimits* limits) {
+    pthread_mutex_lock(&sandbox_lock);
+    if (!file_exists(cache_dir) && !create_directory(cache_dir)) {
+        pthread_mutex_unlock(&sandbox_lock);
+        return 0;
+    }
+    snprintf(sandbox_dir, sizeof(sandbox_dir), "%s", cache_dir);
+    sandbox_limits = limits ? *limits : default_sandbox_limits;
+    const char* compiler = getenv("QUIZ_CC");
+    sandbox_compiler = compiler && *compiler ? compiler : "cc";
+
+    // A program that exits without reading its input must not take the
+    // quiz system down with SIGPIPE
+    signal(SIGPIPE, SIG_IGN);
+    sandbox_ready = 1;
+    pthread_mutex_unlock(&sandbox_lock);
+    return 1;
+}
+
+// SHA-256 of "compiler\0source"
+static int sandbox_key(const char* compiler, const char* source, Sha256Digest* key) {
+    size_t compiler_length = strlen(compiler) + 1;
+    size_t source_length = strlen(source);
+    char* text = malloc(compiler_length + source_length + 1);
+    if (!text) {
+        return 0;
+    }
+    memcpy(text, compiler, compiler_length);
+    memcpy(text + compiler_length, source, source_length);
+    *key = sha256_digest(text, compiler_length + source_length);
+    free(text);
+    return 1;
+}
+
+// SHA-256 of the build's digest followed by the input; no input at all
+// differs from an empty one
+static int sandbox_key_with_input(const Sha256Digest* build, const char* input, Sha256Digest* key) {
+    size_t input_length = input ? strlen(input) + 1 : 0;
+    unsigned char* text = malloc(SHA256_DIGEST_SIZE + input_length + 1);
+    if (!text) {
+        return 0;
+    }
+    memcpy(text, build->bytes, SHA256_DIGEST_SIZE);
+    if (input) {
+        memcpy(text + SHA256_DIGEST_SIZE, input, input_length);
+    }
+    *key = sha256_digest(text, SHA256_DIGEST_SIZE + input_length);
+    free(text);
+    return 1;
+}
+
+// Compiles (or reuses) `source` and runs it with `input` on stdin. The
+// result is filled in either way; returns 0 only if the sandbox could not
+// be set up. Programs are assumed deterministic: a repeated source and
+// input pair returns the recorded result.
+int sandbox_run(const char* source, const char* input, SandboxResult* result) {
+    memset(result, 0, sizeof(SandboxResult));
+    if (!sandbox_ready && !sandbox_init(SANDBOX_CACHE_DIR, NULL)) {
+        result->status = SANDBOX_SETUP_ERROR;
+        return 0;
+    }
+
+    // The build is keyed by compiler and source, the result by the build
+    // and the input
+    Sha256Digest key;
+    Sha256Digest result_key;
+    if (!sandbox_key(sandbox_compiler, source, &key) ||
+        !sandbox_key_with_input(&key, input, &result_key)) {
+        result->status = SANDBOX_SETUP_ERROR;
+        return 0;
+    }
+
+    pthread_mutex_lock(&sandbox_lock);
+    SandboxResult* known = hash_table_get(&results, &result_key);
+    if (known) {
+        *result = *known;
+        result->output = copy_text(known->output, known->output_length);
+        result->diagnostics = known->diagnostics ? copy_text(known->diagnostics, strlen(known->diagnostics)) : NULL;
+        result->compile_cached = 1;
+        result->output_cached = 1;
+        sandbox_stats.output_cache_hits++;
+        pthread_mutex_unlock(&sandbox_lock);
+        return 1;
+    }
+    pthread_mutex_unlock(&sandbox_lock);
+
+    BinaryEntry* binary = ensure_binary(&key, source, &result->compile_cached);
+    if (!binary) {
+        result->status = SANDBOX_SETUP_ERROR;
+        return 0;
+    }
+    if (binary->state == BINARY_FAILED) {
+        result->status = binary->failure;
+        result->diagnostics = binary->diagnostics ? copy_text(binary->diagnostics, strlen(binary->diagnostics))
+                                                  : NULL;
+        result->output = copy_text("", 0);
+    } else {
+        char name[SHA256_DIGEST_SIZE * 2 + 3] = "./";
+        digest_to_hex(&key, name + 2);
+        char* argv[] = { name, NULL };
+        ChildResult child;
+        if (!run_child(argv, input, &sandbox_limits, 0, 1, &child)) {
+            result->status = SANDBOX_SETUP_ERROR;
+            return 0;
+        }
+        result->output = child.output;
+        result->output_length = child.length;
+        result->exit_code = child.exit_code;
+        result->signal = child.signal;
+        result->run_ms = child.ms;
+        result->status = child.timed_out ? SANDBOX_TIMEOUT
+                         : child.truncated ? SANDBOX_OUTPUT_LIMIT
+                         : child.exited ? (child.exit_code == 126 ? SANDBOX_SETUP_ERROR : SANDBOX_OK)
+                                        : SANDBOX_RUNTIME_ERROR;
+    }
+
+    // Setup failures may be transient, so only real outcomes are kept
+    pthread_mutex_lock(&sandbox_lock);
+    sandbox_stats.runs += binary->state == BINARY_BUILT;
+    if (result->status != SANDBOX_SETUP_ERROR && results.count < SANDBOX_OUTPUT_CACHE_MAX) {
+        SandboxResult* copy = malloc(sizeof(SandboxResult));
+        if (copy) {
+            *copy = *result;
+            copy->output = copy_text(result->output ? result->output : "", result->output_length);
+            copy->diagnostics = result->diagnostics ? copy_text(result->diagnostics, strlen(result->diagnostics))
+                                                    : NULL;
+            if (!hash_table_put(&results, &result_key, copy)) {
+                free_cached_result(copy);
+            }
+        }
+    }
+    pthread_mutex_unlock(&sandbox_lock);
+    return 1;
+}
+
+typedef struct {
+    SandboxJob* jobs;
+    int count;
+    int next;
+} SandboxBatch;
+
+static void* sandbox_worker_main(void* arg) {
+    SandboxBatch* batch = arg;
+    int i;
+    while ((i = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED)) < batch->count) {
+        sandbox_run(batch->jobs[i].source, batch->jobs[i].input, &batch->jobs[i].result);
+    }
+    return NULL;
+}
+
+// Runs every job across worker_count threads, the caller included; each
+// job's result is filled in. Returns the number that could be run.
+int sandbox_run_batch(SandboxJob* jobs, int count, int worker_count) {
+    SandboxBatch batch = { jobs, count, 0 };
+    if (worker_count > count) {
+        worker_count = count;
+    }
+    pthread_t* threads = worker_count > 1 ? malloc((worker_count - 1) * sizeof(pthread_t)) : NULL;
+    int started = 0;
+    while (threads && started < worker_count - 1 &&
+           pthread_create(&threads[started], NULL, sandbox_worker_main, &batch) == 0) {
+        started++;
+    }
+    sandbox_worker_main(&batch);
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    int ran = 0;
+    for (int i = 0; i < count; i++) {
+        ran += jobs[i].result.status != SANDBOX_SETUP_ERROR;
+    }
+    return ran;
+}
+
+static size_t trimmed_length(const char* text, size_t length) {
+    while (length > 0 && isspace((unsigned char)text[length - 1])) {
+        length--;
+    }
+    return length;
+}
+
+// 1 if a free-form submission ran cleanly and printed expected_output;
+// trailing whitespace is ignored
+int sandbox_grade_submission(const char* source, const char* input, const char* expected_output,
+                             SandboxResult* result) {
+    if (!sandbox_run(source, input, result) || result->status != SANDBOX_OK || result->exit_code != 0) {
+        return 0;
+    }
+    size_t length = trimmed_length(result->output, result->output_length);
+    size_t expected = trimmed_length(expected_output, strlen(expected_output));
+    return length == expected && memcmp(result->output, expected_output, length) == 0;
+}
+
+void sandbox_result_free(SandboxResult* result) {
+    free(result->output);
+    free(result->diagnostics);
+    result->output = NULL;
+    result->diagnostics = NULL;
+}
+
+void get_sandbox_stats(SandboxStats* stats) {
+    pthread_mutex_lock(&sandbox_lock);
+    *stats = sandbox_stats;
+    pthread_mutex_unlock(&sandbox_lock);
+}
+
+// Forgets cached results; built binaries stay on disk for the next run
+void sandbox_shutdown(void) {
+    pthread_mutex_lock(&sandbox_lock);
+    hash_table_free(&binaries, free_binary_entry);
+    hash_table_free(&results, free_cached_result);
+    memset(&sandbox_stats, 0, sizeof(SandboxStats));
+    sandbox_ready = 0;
+    pthread_mutex_unlock(&sandbox_lock);
+}
+
+// ============================================================================
+// CODE QUESTION VALIDATION
+// ============================================================================
+
+static int is_code_question(const Question* question) {
+    return (question->type == CODE_OUTPUT || question->type == DEBUG_CODE || question->type == CODE_COMPLETION ||
+            question->type == ALGORITHM_TRACE) &&
+           text_length(question->code_snippet) > 0;
+}
+
+// Options are written for people: "\n" may be spelled out, and the right
+// answer may describe the output ("Hello, World! followed by a newline").
+// Returns 2 for an exact match, 1 for a match up to trailing whitespace or
+// a descriptive suffix, 0 otherwise.
+static int option_match(const char* option, const SandboxResult* result) {
+    if (result->status == SANDBOX_COMPILE_ERROR) {
+        return strcasestr(option, "compil") && strcasestr(option, "error") ? 2 : 0;
+    }
+    if (result->status != SANDBOX_OK) {
+        return 0;
+    }
+
+    char decoded[MAX_STRING];
+    size_t length = 0;
+    for (const char* c = option; *c && length + 1 < sizeof(decoded); c++) {
+        if (c[0] == '\\' && (c[1] == 'n' || c[1] == 't')) {
+            decoded[length++] = c[1] == 'n' ? '\n' : '\t';
+            c++;
+        } else {
+            decoded[length++] = *c;
+        }
+    }
+    decoded[length] = '\0';
+
+    if (length == result->output_length && memcmp(decoded, result->output, length) == 0) {
+        return 2;
+    }
+    size_t output = trimmed_length(result->output, result->output_length);
+    size_t trimmed = trimmed_length(decoded, length);
+    if (output == 0 || trimmed < output || memcmp(decoded, result->output, output) != 0) {
+        return 0;
+    }
+    return trimmed == output || decoded[output] == ' ' ? 1 : 0;
+}
+
+// Snippets are built with the common headers in front, and a snippet with
+// no main() is taken to be the body of one. Returns NULL if out of memory.
+static char* snippet_program(const char* snippet, int* wrapped) {
+    static const char prelude[] = "#include <stdio.h>\n#include <stdlib.h>\n#include <string.h>\n";
+    *wrapped = strstr(snippet, "main(") == NULL;
+    size_t size = sizeof(prelude) + strlen(snippet) + 64;
+    char* program = malloc(size);
+    if (program) {
+        snprintf(program, size, *wrapped ? "%sint main(void) {\n%s\nreturn 0;\n}\n" : "%s%s\n", prelude, snippet);
+    }
+    return program;
+}
+
+// Runs the snippet of every code question, all in one batch, and checks
+// the output against the options. A question is verified when its correct
+// option matches, and flagged as a mismatch only when it does not and
+// another option matches outright. Debugging and completion questions
+// have no output to compare and are reported as unverified, as are
+// snippets that only compile once wrapped and then fail to. Returns the
+// number of checks written.
+int validate_code_questions(int worker_count, CodeQuestionCheck* checks, int max_checks) {
+    QuestionHotTable* hot = get_question_hot_table();
+    int capacity = hot->count > 0 ? hot->count : 1;
+    SandboxJob* jobs = calloc(capacity, sizeof(SandboxJob));
+    Question** questions = calloc(capacity, sizeof(Question*));
+    int* wrapped = calloc(capacity, sizeof(int));
+    if (!jobs || !questions || !wrapped) {
+        free(jobs);
+        free(questions);
+        free(wrapped);
+        return 0;
+    }
+
+    int count = 0;
+    for (int slot = 0; slot < hot->count && count < max_checks; slot++) {
+        Question* question = get_question_by_id(hot->id[slot]);
+        if (question && is_code_question(question)) {
+            jobs[count].source = snippet_program(text_get(question->code_snippet), &wrapped[count]);
+            if (!jobs[count].source) {
+                break;
+            }
+            questions[count++] = question;
+        }
+    }
+    sandbox_run_batch(jobs, count, worker_count);
+
+    for (int i = 0; i < count; i++) {
+        Question* question = questions[i];
+        CodeQuestionCheck* check = &checks[i];
+        SandboxResult* result = &jobs[i].result;
+        memset(check, 0, sizeof(CodeQuestionCheck));
+        check->question_id = question->id;
+        check->status = result->status;
+        check->matched_option = -1;
+        check->check = result->status == SANDBOX_SETUP_ERROR ? CODE_CHECK_FAILED : CODE_CHECK_UNVERIFIED;
+        const char* shown = result->status == SANDBOX_COMPILE_ERROR ? result->diagnostics : result->output;
+        snprintf(check->output, sizeof(check->output), "%s", shown ? shown : "");
+
+        int comparable = question->type == CODE_OUTPUT || question->type == ALGORITHM_TRACE;
+        if (comparable && !(wrapped[i] && result->status == SANDBOX_COMPILE_ERROR)) {
+            int exact = -1;
+            for (int o = 0; o < MAX_OPTIONS; o++) {
+                int match = text_length(question->options[o]) > 0 ? option_match(text_get(question->options[o]), result)
+                                                                  : 0;
+                if (o == question->correct_answer && match > 0) {
+                    check->check = CODE_CHECK_VERIFIED;
+                    check->matched_option = o;
+                } else if (match == 2 && exact < 0) {
+                    exact = o;
+                }
+            }
+            if (check->check != CODE_CHECK_VERIFIED && exact >= 0) {
+                check->check = CODE_CHECK_MISMATCH;
+                check->matched_option = exact;
+            }
+        }
+        sandbox_result_free(result);
+        free((char*)jobs[i].source);
+    }
+    free(jobs);
+    free(questions);
+    free(wrapped);
+    return count;
+}
+
+// ============================================================================
+// CODE QUALITY ANALYZER
+// ============================================================================
+
+static const char* sandbox_status_names[] = {
+    "ran", "compile error", "runtime error", "timed out", "too much output", "sandbox error"
+};
+
+void run_code_quality_analyzer(void) {
+    printf("\n🔬 Code Question Analyzer\n");
+    if (!sandbox_init(SANDBOX_CACHE_DIR, NULL)) {
+        printf("❌ Could not create %s\n", SANDBOX_CACHE_DIR);
+        return;
+    }
+
+    int total = get_total_questions();
+    CodeQuestionCheck* checks = malloc((total > 0 ? total : 1) * sizeof(CodeQuestionCheck));
+    if (!checks) {
+        printf("❌ Not enough memory\n");
+        return;
+    }
+    long workers = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t started = trace_now();
+    int count = validate_code_questions(workers > 0 ? (int)workers : 1, checks, total);
+    double seconds = (trace_now() - started) / 1e9;
+
+    int tally[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < count; i++) {
+        CodeQuestionCheck* check = &checks[i];
+        tally[check->check]++;
+        if (check->check == CODE_CHECK_VERIFIED) {
+            continue;
+        }
+        char first_line[80];
+        snprintf(first_line, sizeof(first_line), "%.79s", check->output);
+        first_line[strcspn(first_line, "\n")] = '\0';
+        if (check->check == CODE_CHECK_MISMATCH) {
+            Question* question = get_question_by_id(check->question_id);
+            printf("   ❌ #%d: output matches option %d, answer key says %d (%s)\n", check->question_id,
+                   check->matched_option + 1, question->correct_answer + 1, first_line);
+        } else if (check->check == CODE_CHECK_FAILED) {
+            printf("   ⚠️  #%d: %s\n", check->question_id, sandbox_status_names[check->status]);
+        } else {
+            printf("   ❔ #%d: %s: %s\n", check->question_id, sandbox_status_names[check->status],
+                   first_line[0] ? first_line : "no output to compare");
+        }
+    }
+
+    SandboxStats stats;
+    get_sandbox_stats(&stats);
+    printf("   %d code questions in %.2fs: %d verified, %d mismatched, %d unverified, %d failed\n", count, seconds,
+           tally[CODE_CHECK_VERIFIED], tally[CODE_CHECK_MISMATCH], tally[CODE_CHECK_UNVERIFIED],
+           tally[CODE_CHECK_FAILED]);
+    printf("   %ld compiled, %ld reused builds, %ld cached results\n", stats.compiles, stats.compile_cache_hits,
+           stats.output_cache_hits);
+    free(checks);
+}
@@ -0,0 +1,490 @@
+// quiz_search.c - Full-text question search for the C Programming Quiz System
+// Maintains an inverted index over question keywords, text and code so
+// searches touch only the postings of the query terms
+
+#include "quiz_system.h"
+#include <ctype.h>
+#include <limits.h>
+
+// ============================================================================
+// TERM DICTIONARY
+// ============================================================================
+
+#define MAX_TERM_LENGTH 32
+#define MIN_TERM_LENGTH 2
+
+// Field weights: a keyword match counts more than a mention in the code
+#define KEYWORD_WEIGHT 3
+#define QUESTION_WEIGHT 2
+#define CODE_WEIGHT 1
+
+typedef struct {
+    int slot;
+    int weight; // field-weighted term frequency
+} Posting;
+
+typedef struct {
+    uint32_t name;  // offset into term_names
+    Posting* postings;
+    int count;
+    int capacity;
+} Term;
+
+static Term* terms = NULL;
+static int term_count = 0;
+static int term_capacity = 0;
+static char* term_names = NULL;
+static uint32_t term_names_size = 0;
+static uint32_t term_names_capacity = 0;
+
+static int* term_table = NULL; // open addressing, term id + 1, 0 = free
+static int term_table_size = 0;
+
+static int* sorted_terms = NULL; // term ids in name order, for prefix ranges
+static int sorted_count = 0;
+
+static int searched_count = 0;
+static unsigned int searched_generation = 0;
+
+static uint32_t hash_term(const char* term) {
+    uint32_t hash = 2166136261u;
+    while (*term) {
+        hash ^= (unsigned char)*term++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static const char* term_name(int term) {
+    return term_names + terms[term].name;
+}
+
+static int term_table_grow(void) {
+    int size = term_table_size ? term_table_size * 2 : 4096;
+    int* table = calloc(size, sizeof(int));
+    if (!table) {
+        return 0;
+    }
+    for (int t = 0; t < term_count; t++) {
+        uint32_t pos = hash_term(term_name(t)) & (uint32_t)(size - 1);
+        while (table[pos] != 0) {
+            pos = (pos + 1) & (uint32_t)(size - 1);
+        }
+        table[pos] = t + 1;
+    }
+    free(term_table);
+    term_table = table;
+    term_table_size = size;
+    return 1;
+}
+
+static int find_term(const char* name) {
+    if (term_table_size == 0) {
+        return -1;
+    }
+    uint32_t pos = hash_term(name) & (uint32_t)(term_table_size - 1);
+    while (term_table[pos] != 0) {
+        if (strcmp(term_name(term_table[pos] - 1), name) == 0) {
+            return term_table[pos] - 1;
+        }
+        pos = (pos + 1) & (uint32_t)(term_table_size - 1);
+    }
+    return -1;
+}
+
+static int intern_term(const char* name) {
+    int term = find_term(name);
+    if (term >= 0) {
+        return term;
+    }
+    if ((term_count + 1) * 2 > term_table_size && !term_table_grow()) {
+        return -1;
+    }
+
+    uint32_t length = (uint32_t)strlen(name) + 1;
+    if (term_names_size + length > term_names_capacity) {
+        uint32_t capacity = term_names_capacity ? term_names_capacity * 2 : 65536;
+        char* names = realloc(term_names, capacity);
+        if (!names) {
+            return -1;
+        }
+        term_names = names;
+        term_names_capacity = capacity;
+    }
+    if (term_count == term_capacity) {
+        int capacity = term_capacity ? term_capacity * 2 : 4096;
+        Term* grown = realloc(terms, capacity * sizeof(Term));
+        if (!grown) {
+            return -1;
+        }
+        terms = grown;
+        term_capacity = capacity;
+    }
+
+    term = term_count++;
+    memset(&terms[term], 0, sizeof(Term));
+    terms[term].name = term_names_size;
+    memcpy(term_names + term_names_size, name, length);
+    term_names_size += length;
+
+    uint32_t pos = hash_term(name) & (uint32_t)(term_table_size - 1);
+    while (term_table[pos] != 0) {
+        pos = (pos + 1) & (uint32_t)(term_table_size - 1);
+    }
+    term_table[pos] = term + 1;
+    return term;
+}
+
+// Postings are appended in slot order, so a repeat for the same slot is
+// always the last entry
+static void add_posting(int term, int slot, int weight) {
+    Term* t = &terms[term];
+    if (t->count > 0 && t->postings[t->count - 1].slot == slot) {
+        t->postings[t->count - 1].weight += weight;
+        return;
+    }
+    if (t->count == t->capacity) {
+        int capacity = t->capacity ? t->capacity * 2 : 4;
+        Posting* postings = realloc(t->postings, capacity * sizeof(Posting));
+        if (!postings) {
+            return;
+        }
+        t->postings = postings;
+        t->capacity = capacity;
+    }
+    t->postings[t->count].slot = slot;
+    t->postings[t->count].weight = weight;
+    t->count++;
+}
+
+// ============================================================================
+// INDEXING
+// ============================================================================
+
+// Splits text into lowercase identifier-like tokens. Returns a pointer past
+// the token, or NULL when the text is exhausted.
+static const char* next_token(const char* text, char token[MAX_TERM_LENGTH]) {
+    while (*text && !(isalnum((unsigned char)*text) || *text == '_')) {
+        text++;
+    }
+    if (!*text) {
+        return NULL;
+    }
+    int length = 0;
+    while (isalnum((unsigned char)*text) || *text == '_') {
+        if (length < MAX_TERM_LENGTH - 1) {
+            token[length++] = (char)tolower((unsigned char)*text);
+        }
+        text++;
+    }
+    token[length] = '\0';
+    return text;
+}
+
+static void index_text(int slot, const char* text, int weight) {
+    char token[MAX_TERM_LENGTH];
+    while ((text = next_token(text, token)) != NULL) {
+        if (strlen(token) >= MIN_TERM_LENGTH) {
+            int term = intern_term(token);
+            if (term >= 0) {
+                add_posting(term, slot, weight);
+            }
+        }
+    }
+}
+
+static void index_question_text(int slot) {
+    Question* q = question_at(slot);
+    for (int i = 0; i < MAX_KEYWORDS; i++) {
+        index_text(slot, text_get(q->keywords[i]), KEYWORD_WEIGHT);
+    }
+    index_text(slot, text_get(q->question), QUESTION_WEIGHT);
+    index_text(slot, text_get(q->code_snippet), CODE_WEIGHT);
+}
+
+static void clear_search_index(void) {
+    for (int t = 0; t < term_count; t++) {
+        free(terms[t].postings);
+    }
+    term_count = 0;
+    term_names_size = 0;
+    sorted_count = 0;
+    if (term_table) {
+        memset(term_table, 0, term_table_size * sizeof(int));
+    }
+    searched_count = 0;
+}
+
+static int compare_term_names(const void* a, const void* b) {
+    return strcmp(term_name(*(const int*)a), term_name(*(const int*)b));
+}
+
+// Indexes questions added since the last search; a reload starts over.
+// The first search after startup pays for the build, not initialization.
+static void sync_search_index(void) {
+    QuestionHotTable* hot = get_question_hot_table();
+    if (searched_generation != question_store_generation()) {
+        clear_search_index();
+        searched_generation = question_store_generation();
+    }
+    if (searched_count == hot->count) {
+        return;
+    }
+    for (; searched_count < hot->count; searched_count++) {
+        index_question_text(searched_count);
+    }
+
+    int* sorted = realloc(sorted_terms, (term_count ? term_count : 1) * sizeof(int));
+    if (!sorted) {
+        return;
+    }
+    sorted_terms = sorted;
+    for (int t = 0; t < term_count; t++) {
+        sorted_terms[t] = t;
+    }
+    qsort(sorted_terms, term_count, sizeof(int), compare_term_names);
+    sorted_count = term_count;
+}
+
+// First position in sorted_terms whose name is >= key
+static int lower_bound_term(const char* key) {
+    int low = 0;
+    int high = sorted_count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (strcmp(term_name(sorted_terms[mid]), key) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// ============================================================================
+// QUERY EVALUATION
+// ============================================================================
+
+#define MAX_QUERY_TERMS 64
+
+// A (query, term) stamp is query_stamp * MAX_QUERY_TERMS + term, so the
+// stamps are cleared and restarted before that could overflow
+#define QUERY_STAMP_LIMIT ((UINT_MAX - (MAX_QUERY_TERMS - 1)) / MAX_QUERY_TERMS)
+
+// Per-slot accumulators, reset lazily by stamping them with the query number
+static float* acc_score = NULL;
+static unsigned short* acc_terms = NULL;  // query terms matched so far
+static unsigned int* acc_stamp = NULL;     // query that last touched the slot
+static unsigned int* acc_term_stamp = NULL; // (query, term) that last touched it
+static int* touched = NULL;
+static int touched_count = 0;
+static int acc_capacity = 0;
+static unsigned int query_stamp = 0;
+
+static int reserve_accumulators(int count) {
+    if (count <= acc_capacity) {
+        return 1;
+    }
+    float* score = realloc(acc_score, count * sizeof(float));
+    if (score) acc_score = score;
+    unsigned short* matched = realloc(acc_terms, count * sizeof(unsigned short));
+    if (matched) acc_terms = matched;
+    unsigned int* stamp = realloc(acc_stamp, count * sizeof(unsigned int));
+    if (stamp) acc_stamp = stamp;
+    unsigned int* term_stamp = realloc(acc_term_stamp, count * sizeof(unsigned int));
+    if (term_stamp) acc_term_stamp = term_stamp;
+    int* list = realloc(touched, count * sizeof(int));
+    if (list) touched = list;
+    if (!score || !matched || !stamp || !term_stamp || !list) {
+        return 0;
+    }
+    memset(acc_stamp + acc_capacity, 0, (count - acc_capacity) * sizeof(unsigned int));
+    memset(acc_term_stamp + acc_capacity, 0, (count - acc_capacity) * sizeof(unsigned int));
+    acc_capacity = count;
+    return 1;
+}
+
+static void accumulate_term(int term, int query_term, float idf_total_docs) {
+    Term* t = &terms[term];
+    float idf = logf(1.0f + idf_total_docs / t->count);
+    unsigned int term_stamp = query_stamp * MAX_QUERY_TERMS + (unsigned int)query_term;
+
+    for (int i = 0; i < t->count; i++) {
+        int slot = t->postings[i].slot;
+        if (acc_stamp[slot] != query_stamp) {
+            acc_stamp[slot] = query_stamp;
+            acc_score[slot] = 0.0f;
+            acc_terms[slot] = 0;
+            touched[touched_count++] = slot;
+        }
+        // A prefix expands to several terms; count the query term once
+        if (acc_term_stamp[slot] != term_stamp) {
+            acc_term_stamp[slot] = term_stamp;
+            acc_terms[slot]++;
+        }
+        acc_score[slot] += t->postings[i].weight * idf;
+    }
+}
+
+static int hit_before(const SearchHit* a, const SearchHit* b) {
+    return a->score < b->score || (a->score == b->score && a->question_id > b->question_id);
+}
+
+// Keeps the best max_hits in a min-heap rooted at hits[0]
+static void offer_hit(SearchHit* hits, int* size, int max_hits, SearchHit hit) {
+    int i;
+    if (*size < max_hits) {
+        i = (*size)++;
+        while (i > 0 && hit_before(&hit, &hits[(i - 1) / 2])) {
+            hits[i] = hits[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        hits[i] = hit;
+        return;
+    }
+    if (!hit_before(&hits[0], &hit)) {
+        return;
+    }
+    i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= *size) {
+            break;
+        }
+        if (child + 1 < *size && hit_before(&hits[child + 1], &hits[child])) {
+            child++;
+        }
+        if (!hit_before(&hits[child], &hit)) {
+            break;
+        }
+        hits[i] = hits[child];
+        i = child;
+    }
+    hits[i] = hit;
+}
+
+static int compare_hits_ranked(const void* a, const void* b) {
+    const SearchHit* x = a;
+    const SearchHit* y = b;
+    if (x->score != y->score) {
+        return x->score > y->score ? -1 : 1;
+    }
+    return x->question_id - y->question_id;
+}
+
+// Scores every question matching any term of query into the accumulators
+// and lists them in touched. Returns the number of query terms, or -1.
+static int evaluate_query(const char* query) {
+    sync_search_index();
+    QuestionHotTable* hot = get_question_hot_table();
+    if (!reserve_accumulators(hot->count)) {
+        return -1;
+    }
+
+    if (query_stamp == QUERY_STAMP_LIMIT) {
+        memset(acc_stamp, 0, acc_capacity * sizeof(unsigned int));
+        memset(acc_term_stamp, 0, acc_capacity * sizeof(unsigned int));
+        query_stamp = 0;
+    }
+    query_stamp++;
+    touched_count = 0;
+
+    int query_terms = 0;
+    const char* cursor = query;
+    char token[MAX_TERM_LENGTH];
+    while ((cursor = next_token(cursor, token)) != NULL && query_terms < MAX_QUERY_TERMS) {
+        int prefix = *cursor == '*';
+        // Short words are never indexed, so they cannot be required to match
+        if (!prefix && strlen(token) < MIN_TERM_LENGTH) {
+            continue;
+        }
+        int term_index = query_terms++;
+
+        if (!prefix) {
+            int term = find_term(token);
+            if (term >= 0) {
+                accumulate_term(term, term_index, (float)hot->count);
+            }
+            continue;
+        }
+        size_t length = strlen(token);
+        for (int i = lower_bound_term(token); i < sorted_count; i++) {
+            int term = sorted_terms[i];
+            if (strncmp(term_name(term), token, length) != 0) {
+                break;
+            }
+            accumulate_term(term, term_index, (float)hot->count);
+        }
+    }
+    return query_terms;
+}
+
+// Runs a query of whitespace-separated terms; a trailing '*' makes a term a
+// prefix. SEARCH_ALL needs every term to match, SEARCH_ANY at least one.
+// Writes the best max_hits matches to hits, best first, and returns the
+// total number of matching questions.
+int search_questions(const char* query, SearchMode mode, SearchHit* hits, int max_hits) {
+    TRACE_SCOPE(TRACE_SEARCH);
+    int query_terms = evaluate_query(query);
+    if (query_terms < 0) {
+        return 0;
+    }
+
+    const QuestionHotTable* hot = get_question_hot_table();
+    int total = 0;
+    int heap_size = 0;
+    for (int i = 0; i < touched_count; i++) {
+        int slot = touched[i];
+        if (mode == SEARCH_ALL && acc_terms[slot] < query_terms) {
+            continue;
+        }
+        total++;
+        if (max_hits > 0) {
+            SearchHit hit = { hot->id[slot], acc_score[slot] };
+            offer_hit(hits, &heap_size, max_hits, hit);
+        }
+    }
+    qsort(hits, heap_size, sizeof(SearchHit), compare_hits_ranked);
+    return total;
+}
+
+// Ranked matches for every term in keyword. The caller frees the array;
+// search_questions streams into a caller buffer instead. The query is
+// evaluated once and the matching slots sorted in place, so no id lookup
+// is needed afterwards.
+static int compare_slots_ranked(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    if (acc_score[x] != acc_score[y]) {
+        return acc_score[x] > acc_score[y] ? -1 : 1;
+    }
+    const QuestionHotTable* hot = get_question_hot_table();
+    return hot->id[x] - hot->id[y];
+}
+
+Question** search_questions_by_keyword(const char* keyword, int* result_count) {
+    TRACE_SCOPE(TRACE_SEARCH);
+    *result_count = 0;
+    int query_terms = evaluate_query(keyword);
+    if (query_terms < 0) {
+        return NULL;
+    }
+
+    // touched is scratch once the query is scored; keep the full matches
+    int total = 0;
+    for (int i = 0; i < touched_count; i++) {
+        if (acc_terms[touched[i]] >= query_terms) {
+            touched[total++] = touched[i];
+        }
+    }
+    Question** results = total > 0 ? malloc(total * sizeof(Question*)) : NULL;
+    if (!results) {
+        return NULL;
+    }
+    qsort(touched, total, sizeof(int), compare_slots_ranked);
+    for (int i = 0; i < total; i++) {
+        results[i] = question_at(touched[i]);
+    }
+    *result_count = total;
+    return results;
+}
@@ -0,0 +1,215 @@
+// quiz_simd.c - Batch question scoring kernels for the C Programming Quiz System
+// Scores whole runs of hot-table rows against a student's topic scores, and
+// takes dot products of quantized tutor embeddings, with SSE2/AVX2 where
+// available, selected once at runtime
+
+#include "quiz_system.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define QUIZ_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+// Every kernel evaluates, in this order and without fused multiply-add,
+//   d = difficulty
+//   if asked > 0: d = d * 0.5 + (1 + (1 - correct / asked) * 4) * 0.5
+//   score = 1 - |d - (1 + topic_score * 4)| / 4
+// which is the same float expression calculate_question_difficulty_score
+// uses, so every path agrees bit-for-bit with the scalar code. If the scalar
+// code is built with floating-point contraction, results differ by at most
+// one rounding step (under 1e-6).
+
+typedef void (*ScoreKernel)(const unsigned char*, const unsigned char*, const int*, const int*,
+                            int, const float*, float*);
+
+static void score_scalar(const unsigned char* difficulty, const unsigned char* topic,
+                         const int* times_asked, const int* times_correct, int count,
+                         const float* topic_scores, float* out) {
+    for (int i = 0; i < count; i++) {
+        float d = difficulty[i];
+        if (times_asked[i] > 0) {
+            float accuracy = (float)times_correct[i] / (float)times_asked[i];
+            float observed = 1.0f + (1.0f - accuracy) * 4.0f;
+            d = d * 0.5f + observed * 0.5f;
+        }
+        float target = 1.0f + topic_scores[topic[i]] * 4.0f;
+        out[i] = 1.0f - fabsf(d - target) / 4.0f;
+    }
+}
+
+#ifdef QUIZ_X86_KERNELS
+
+__attribute__((target("sse2")))
+static void score_sse2(const unsigned char* difficulty, const unsigned char* topic,
+                       const int* times_asked, const int* times_correct, int count,
+                       const float* topic_scores, float* out) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        int packed;
+        memcpy(&packed, difficulty + i, sizeof(int));
+        __m128i bytes = _mm_cvtsi32_si128(packed);
+        __m128i words = _mm_unpacklo_epi8(bytes, zero);
+        __m128 d = _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero));
+
+        __m128i asked = _mm_loadu_si128((const __m128i*)(times_asked + i));
+        __m128i correct = _mm_loadu_si128((const __m128i*)(times_correct + i));
+        __m128i has_asked = _mm_cmpgt_epi32(asked, zero);
+        // Lanes never asked divide by 1 and are discarded by the blend
+        __m128i safe_asked = _mm_or_si128(_mm_and_si128(has_asked, asked),
+                                          _mm_andnot_si128(has_asked, _mm_set1_epi32(1)));
+        __m128 accuracy = _mm_div_ps(_mm_cvtepi32_ps(correct), _mm_cvtepi32_ps(safe_asked));
+        __m128 observed = _mm_add_ps(one, _mm_mul_ps(_mm_sub_ps(one, accuracy), four));
+        __m128 blended = _mm_add_ps(_mm_mul_ps(d, half), _mm_mul_ps(observed, half));
+        __m128 mask = _mm_castsi128_ps(has_asked);
+        d = _mm_or_ps(_mm_and_ps(mask, blended), _mm_andnot_ps(mask, d));
+
+        // SSE2 has no variable permute, so gather the four topic scores
+        __m128 scores = _mm_setr_ps(topic_scores[topic[i]], topic_scores[topic[i + 1]],
+                                    topic_scores[topic[i + 2]], topic_scores[topic[i + 3]]);
+        __m128 target = _mm_add_ps(one, _mm_mul_ps(scores, four));
+        __m128 distance = _mm_andnot_ps(sign, _mm_sub_ps(d, target));
+        _mm_storeu_ps(out + i, _mm_sub_ps(one, _mm_div_ps(distance, four)));
+    }
+
+    score_scalar(difficulty + i, topic + i, times_asked + i, times_correct + i,
+                 count - i, topic_scores, out + i);
+}
+
+__attribute__((target("avx2")))
+static void score_avx2(const unsigned char* difficulty, const unsigned char* topic,
+                       const int* times_asked, const int* times_correct, int count,
+                       const float* topic_scores, float* out) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 four = _mm256_set1_ps(4.0f);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i eight = _mm256_set1_epi32(8);
+
+    // Topics 0-7 and 8-11 in two registers, looked up with lane permutes
+    float high[8] = { 0 };
+    memcpy(high, topic_scores + 8, (NUM_C_TOPICS - 8) * sizeof(float));
+    const __m256 scores_low = _mm256_loadu_ps(topic_scores);
+    const __m256 scores_high = _mm256_loadu_ps(high);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 d = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(difficulty + i))));
+        __m256i topics = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(topic + i)));
+
+        __m256i asked = _mm256_loadu_si256((const __m256i*)(times_asked + i));
+        __m256i correct = _mm256_loadu_si256((const __m256i*)(times_correct + i));
+        __m256i has_asked = _mm256_cmpgt_epi32(asked, zero);
+        __m256i safe_asked = _mm256_blendv_epi8(_mm256_set1_epi32(1), asked, has_asked);
+        __m256 accuracy = _mm256_div_ps(_mm256_cvtepi32_ps(correct), _mm256_cvtepi32_ps(safe_asked));
+        __m256 observed = _mm256_add_ps(one, _mm256_mul_ps(_mm256_sub_ps(one, accuracy), four));
+        __m256 blended = _mm256_add_ps(_mm256_mul_ps(d, half), _mm256_mul_ps(observed, half));
+        d = _mm256_blendv_ps(d, blended, _mm256_castsi256_ps(has_asked));
+
+        __m256 low = _mm256_permutevar8x32_ps(scores_low, topics);
+        __m256 high_lane = _mm256_permutevar8x32_ps(scores_high, _mm256_sub_epi32(topics, eight));
+        __m256i use_high = _mm256_cmpgt_epi32(topics, _mm256_set1_epi32(7));
+        __m256 scores = _mm256_blendv_ps(low, high_lane, _mm256_castsi256_ps(use_high));
+
+        __m256 target = _mm256_add_ps(one, _mm256_mul_ps(scores, four));
+        __m256 distance = _mm256_andnot_ps(sign, _mm256_sub_ps(d, target));
+        _mm256_storeu_ps(out + i, _mm256_sub_ps(one, _mm256_div_ps(distance, four)));
+    }
+
+    score_sse2(difficulty + i, topic + i, times_asked + i, times_correct + i,
+               count - i, topic_scores, out + i);
+}
+
+#endif
+
+// Embedding dot products are exact integer sums, so every path agrees
+typedef void (*DotKernel)(const int8_t*, int, int, const int8_t*, int32_t*);
+
+static void dot_scalar(const int8_t* rows, int count, int dim, const int8_t* query, int32_t* out) {
+    for (int r = 0; r < count; r++) {
+        const int8_t* row = rows + (size_t)r * dim;
+        int32_t sum = 0;
+        for (int d = 0; d < dim; d++) {
+            sum += row[d] * query[d];
+        }
+        out[r] = sum;
+    }
+}
+
+#ifdef QUIZ_X86_KERNELS
+
+__attribute__((target("avx2")))
+static void dot_avx2(const int8_t* rows, int count, int dim, const int8_t* query, int32_t* out) {
+    int vector_dim = dim & ~15;
+    for (int r = 0; r < count; r++) {
+        const int8_t* row = rows + (size_t)r * dim;
+        __m256i sum = _mm256_setzero_si256();
+        for (int d = 0; d < vector_dim; d += 16) {
+            __m256i a = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(row + d)));
+            __m256i b = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(query + d)));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, b));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+        int32_t total = _mm_cvtsi128_si32(half);
+        for (int d = vector_dim; d < dim; d++) {
+            total += row[d] * query[d];
+        }
+        out[r] = total;
+    }
+}
+
+#endif
+
+static ScoreKernel score_kernel = NULL;
+static DotKernel dot_kernel = dot_scalar;
+static const char* score_kernel_name = "scalar";
+
+static void select_score_kernel(void) {
+    score_kernel = score_scalar;
+    score_kernel_name = "scalar";
+#ifdef QUIZ_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        dot_kernel = dot_avx2;
+        score_kernel = score_avx2;
+        score_kernel_name = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        score_kernel = score_sse2;
+        score_kernel_name = "sse2";
+    }
+#endif
+}
+
+// Difficulty-match scores for count consecutive rows, as
+// calculate_question_difficulty_score would compute them one at a time
+void score_questions_batch(const unsigned char* difficulty, const unsigned char* topic,
+                           const int* times_asked, const int* times_correct, int count,
+                           const float topic_scores[NUM_C_TOPICS], float* out_scores) {
+    if (!score_kernel) {
+        select_score_kernel();
+    }
+    score_kernel(difficulty, topic, times_asked, times_correct, count, topic_scores, out_scores);
+}
+
+const char* get_scoring_kernel_name(void) {
+    if (!score_kernel) {
+        select_score_kernel();
+    }
+    return score_kernel_name;
+}
+
+// Dot products of count consecutive int8 rows of `dim` values with a query
+void embedding_dot_batch(const int8_t* rows, int count, int dim, const int8_t* query, int32_t* out) {
+    if (!score_kernel) {
+        select_score_kernel();
+    }
+    dot_kernel(rows, count, dim, query, out);
+}
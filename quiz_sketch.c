@@ -0,0 +1,215 @@
+// quiz_sketch.c - Response-time distributions for the C Programming Quiz System
+// Fixed-size log-bucket histograms per question, per topic and per session
+// that answer p50/p90/p99 and merge by adding counts
+
+#include "quiz_system.h"
+
+// ============================================================================
+// SKETCHES
+// ============================================================================
+
+// Times are counted in tenths of a second. Values below 4 get a bucket
+// each; above that every power of two is split into four buckets, so a
+// quantile is reported within 12.5% of the true value. The 64 buckets reach
+// about 3.6 hours, and longer times land in the last bucket.
+#define SKETCH_LINEAR_BUCKETS 4
+#define SKETCH_MAX_UNITS ((1u << 17) - 1)
+
+static int sketch_bucket(float seconds) {
+    float scaled = seconds * 10.0f;
+    unsigned int units = scaled <= 0.0f ? 0 : scaled >= (float)SKETCH_MAX_UNITS ? SKETCH_MAX_UNITS : (unsigned int)scaled;
+    if (units < SKETCH_LINEAR_BUCKETS) {
+        return (int)units;
+    }
+    int exponent = 31 - __builtin_clz(units);
+    return 4 * (exponent - 1) + (int)((units >> (exponent - 2)) & 3);
+}
+
+// Midpoint of a bucket, in seconds
+static float sketch_bucket_value(int bucket) {
+    if (bucket < SKETCH_LINEAR_BUCKETS) {
+        return (bucket + 0.5f) / 10.0f;
+    }
+    int exponent = bucket / 4 + 1;
+    float width = (float)(1u << (exponent - 2));
+    float low = (4 + bucket % 4) * width;
+    return (low + width / 2.0f) / 10.0f;
+}
+
+// Lock-free: concurrent recorders only ever add to a counter
+void sketch_record(ResponseTimeSketch* sketch, float seconds) {
+    __atomic_fetch_add(&sketch->counts[sketch_bucket(seconds)], 1u, __ATOMIC_RELAXED);
+}
+
+void sketch_merge(ResponseTimeSketch* sketch, const ResponseTimeSketch* other) {
+    for (int i = 0; i < RESPONSE_SKETCH_BUCKETS; i++) {
+        __atomic_fetch_add(&sketch->counts[i], __atomic_load_n(&other->counts[i], __ATOMIC_RELAXED),
+                           __ATOMIC_RELAXED);
+    }
+}
+
+unsigned int sketch_count(const ResponseTimeSketch* sketch) {
+    unsigned int total = 0;
+    for (int i = 0; i < RESPONSE_SKETCH_BUCKETS; i++) {
+        total += __atomic_load_n(&sketch->counts[i], __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+// Time in seconds below which a fraction q of answers fall; 0 when empty
+float sketch_quantile(const ResponseTimeSketch* sketch, float q) {
+    unsigned int counts[RESPONSE_SKETCH_BUCKETS];
+    unsigned int total = 0;
+    for (int i = 0; i < RESPONSE_SKETCH_BUCKETS; i++) {
+        counts[i] = __atomic_load_n(&sketch->counts[i], __ATOMIC_RELAXED);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0.0f;
+    }
+
+    unsigned int rank = (unsigned int)ceilf(q * total);
+    if (rank < 1) {
+        rank = 1;
+    }
+    unsigned int seen = 0;
+    for (int i = 0; i < RESPONSE_SKETCH_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return sketch_bucket_value(i);
+        }
+    }
+    return sketch_bucket_value(RESPONSE_SKETCH_BUCKETS - 1);
+}
+
+void sketch_percentiles(const ResponseTimeSketch* sketch, ResponseTimePercentiles* percentiles) {
+    percentiles->count = sketch_count(sketch);
+    percentiles->p50 = sketch_quantile(sketch, 0.50f);
+    percentiles->p90 = sketch_quantile(sketch, 0.90f);
+    percentiles->p99 = sketch_quantile(sketch, 0.99f);
+}
+
+// ============================================================================
+// QUESTION AND TOPIC SKETCHES
+// ============================================================================
+
+// Question sketches live in a chunked array indexed by slot, so growing it
+// never moves a sketch another thread may be recording into. Engine workers
+// record straight into them: two workers only share a cache line when they
+// answer the same question in the same instant. Topic sketches are merged
+// from these on demand, which keeps a single add on the answer path.
+static ChunkedArray question_sketches = { sizeof(ResponseTimeSketch), 1024, 0, NULL, 0, 0 };
+
+// Makes sure slots [0, count) have sketches. The session engine calls this
+// before starting workers; other callers grow it on demand.
+int reserve_response_sketches(int count) {
+    while (question_sketches.count < count) {
+        ResponseTimeSketch* sketch = chunked_array_push(&question_sketches);
+        if (!sketch) {
+            return 0;
+        }
+        memset(sketch, 0, sizeof(ResponseTimeSketch));
+    }
+    return 1;
+}
+
+void record_response_time(int slot, float seconds) {
+    if (slot < 0 || (slot >= question_sketches.count && !reserve_response_sketches(slot + 1))) {
+        return;
+    }
+    sketch_record(chunked_array_at(&question_sketches, slot), seconds);
+}
+
+// NULL until a question at or past this slot has been answered
+const ResponseTimeSketch* get_question_response_sketch(int slot) {
+    return slot >= 0 && slot < question_sketches.count ? chunked_array_at(&question_sketches, slot) : NULL;
+}
+
+static void merge_topic_sketches(ResponseTimeSketch topics[NUM_C_TOPICS]) {
+    QuestionHotTable* hot = get_question_hot_table();
+    memset(topics, 0, NUM_C_TOPICS * sizeof(ResponseTimeSketch));
+    for (int slot = 0; slot < question_sketches.count && slot < hot->count; slot++) {
+        sketch_merge(&topics[hot->topic[slot]], chunked_array_at(&question_sketches, slot));
+    }
+}
+
+void get_topic_response_sketch(TopicIndex topic, ResponseTimeSketch* sketch) {
+    QuestionHotTable* hot = get_question_hot_table();
+    memset(sketch, 0, sizeof(ResponseTimeSketch));
+    for (int slot = 0; slot < question_sketches.count && slot < hot->count; slot++) {
+        if (hot->topic[slot] == topic) {
+            sketch_merge(sketch, chunked_array_at(&question_sketches, slot));
+        }
+    }
+}
+
+void reset_response_sketches(void) {
+    chunked_array_free(&question_sketches);
+}
+
+// Questions whose p90 is at least `factor` times their topic's median,
+// slowest first; returns how many ids were written
+int find_slow_questions(float factor, int min_answers, int* ids, int max_ids) {
+    QuestionHotTable* hot = get_question_hot_table();
+    ResponseTimeSketch topics[NUM_C_TOPICS];
+    float medians[NUM_C_TOPICS];
+    merge_topic_sketches(topics);
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        medians[t] = sketch_quantile(&topics[t], 0.50f);
+    }
+
+    float* p90s = malloc(((size_t)max_ids + 1) * sizeof(float));
+    int found = 0;
+    for (int slot = 0; p90s && slot < question_sketches.count && slot < hot->count; slot++) {
+        const ResponseTimeSketch* sketch = chunked_array_at(&question_sketches, slot);
+        if ((int)sketch_count(sketch) < min_answers) {
+            continue;
+        }
+        float p90 = sketch_quantile(sketch, 0.90f);
+        if (p90 < medians[hot->topic[slot]] * factor) {
+            continue;
+        }
+        // Insertion into the bounded, descending result list
+        int position = found < max_ids ? found++ : max_ids;
+        while (position > 0 && p90s[position - 1] < p90) {
+            if (position < max_ids) {
+                p90s[position] = p90s[position - 1];
+                ids[position] = ids[position - 1];
+            }
+            position--;
+        }
+        if (position < max_ids) {
+            p90s[position] = p90;
+            ids[position] = hot->id[slot];
+        }
+    }
+    free(p90s);
+    return found;
+}
+
+void display_response_time_report(void) {
+    ResponseTimeSketch topics[NUM_C_TOPICS];
+    merge_topic_sketches(topics);
+
+    printf("\n⏱️  Response Times (p50 / p90 / p99)\n");
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        ResponseTimePercentiles topic;
+        sketch_percentiles(&topics[t], &topic);
+        if (topic.count > 0) {
+            printf("   %-28s %6.1fs %6.1fs %6.1fs  (%u answers)\n", get_topic_name((TopicIndex)t),
+                   topic.p50, topic.p90, topic.p99, topic.count);
+        }
+    }
+
+    int slow[5];
+    int count = find_slow_questions(3.0f, 20, slow, 5);
+    if (count > 0) {
+        printf("   🐢 Questions with p90 over 3x their topic median:\n");
+        for (int i = 0; i < count; i++) {
+            ResponseTimePercentiles question;
+            sketch_percentiles(get_question_response_sketch(find_question_slot(slow[i])), &question);
+            printf("      #%d: p50 %.1fs, p90 %.1fs, p99 %.1fs\n", slow[i], question.p50, question.p90,
+                   question.p99);
+        }
+    }
+}
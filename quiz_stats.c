@@ -0,0 +1,506 @@
+// quiz_stats.c - Batch statistics for the C Programming Quiz System
+// One-pass mean/variance/covariance accumulators that merge exactly, SIMD
+// block kernels to feed them, a threaded split-and-merge mode, and the
+// cohort-wide regression behind predicted_exam_score
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "quiz_system.h"
+#include <pthread.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define QUIZ_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// ACCUMULATORS
+// ============================================================================
+
+// Welford's update for single values and Chan's formula for merging two
+// partial results. Both keep the sum of squared deviations from the running
+// mean rather than a raw sum of squares, so large offsets do not cancel.
+
+void running_stats_init(RunningStats* stats) {
+    memset(stats, 0, sizeof(RunningStats));
+}
+
+void running_stats_push(RunningStats* stats, double value) {
+    stats->count++;
+    double delta = value - stats->mean;
+    stats->mean += delta / stats->count;
+    stats->m2 += delta * (value - stats->mean);
+}
+
+void running_stats_merge(RunningStats* stats, const RunningStats* other) {
+    if (other->count == 0) {
+        return;
+    }
+    if (stats->count == 0) {
+        *stats = *other;
+        return;
+    }
+    double count = (double)stats->count + (double)other->count;
+    double delta = other->mean - stats->mean;
+    stats->mean += delta * other->count / count;
+    stats->m2 += other->m2 + delta * delta * stats->count * other->count / count;
+    stats->count += other->count;
+}
+
+// Population variance; 0 for fewer than two values
+double running_stats_variance(const RunningStats* stats) {
+    return stats->count > 1 ? stats->m2 / stats->count : 0.0;
+}
+
+void paired_stats_init(PairedStats* stats) {
+    memset(stats, 0, sizeof(PairedStats));
+}
+
+void paired_stats_push(PairedStats* stats, double x, double y) {
+    stats->count++;
+    double dx = x - stats->mean_x;
+    double dy = y - stats->mean_y;
+    stats->mean_x += dx / stats->count;
+    stats->mean_y += dy / stats->count;
+    stats->m2_x += dx * (x - stats->mean_x);
+    stats->m2_y += dy * (y - stats->mean_y);
+    stats->c_xy += dx * (y - stats->mean_y);
+}
+
+void paired_stats_merge(PairedStats* stats, const PairedStats* other) {
+    if (other->count == 0) {
+        return;
+    }
+    if (stats->count == 0) {
+        *stats = *other;
+        return;
+    }
+    double count = (double)stats->count + (double)other->count;
+    double weight = (double)stats->count * other->count / count;
+    double dx = other->mean_x - stats->mean_x;
+    double dy = other->mean_y - stats->mean_y;
+    stats->mean_x += dx * other->count / count;
+    stats->mean_y += dy * other->count / count;
+    stats->m2_x += other->m2_x + dx * dx * weight;
+    stats->m2_y += other->m2_y + dy * dy * weight;
+    stats->c_xy += other->c_xy + dx * dy * weight;
+    stats->count += other->count;
+}
+
+// Pearson correlation; 0 when either variable is constant
+double paired_stats_correlation(const PairedStats* stats) {
+    double denominator = sqrt(stats->m2_x * stats->m2_y);
+    return denominator > 0.0 ? stats->c_xy / denominator : 0.0;
+}
+
+// Least-squares fit y = intercept + slope * x
+void paired_stats_fit(const PairedStats* stats, double* slope, double* intercept) {
+    *slope = stats->m2_x > 0.0 ? stats->c_xy / stats->m2_x : 0.0;
+    *intercept = stats->mean_y - *slope * stats->mean_x;
+}
+
+// ============================================================================
+// BLOCK KERNELS
+// ============================================================================
+
+// Arrays are consumed in L1-sized blocks. Each block is summed, then its
+// deviations from the block mean are squared in a second sweep while the
+// block is still in cache, and the block result is merged with Chan's
+// formula. Memory is read once, and every sum stays short enough in double
+// precision that no compensation term is needed.
+#define STATS_BLOCK 1024
+
+typedef void (*MomentKernel)(const float*, int, double*, double*);
+typedef void (*CoMomentKernel)(const float*, const float*, int, double[5]);
+
+static void moments_scalar(const float* x, int n, double* mean, double* m2) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum += x[i];
+    }
+    *mean = sum / n;
+    double squares = 0.0;
+    for (int i = 0; i < n; i++) {
+        double d = x[i] - *mean;
+        squares += d * d;
+    }
+    *m2 = squares;
+}
+
+// out = { mean_x, mean_y, m2_x, m2_y, c_xy }
+static void comoments_scalar(const float* x, const float* y, int n, double out[5]) {
+    double sum_x = 0.0;
+    double sum_y = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum_x += x[i];
+        sum_y += y[i];
+    }
+    out[0] = sum_x / n;
+    out[1] = sum_y / n;
+    out[2] = out[3] = out[4] = 0.0;
+    for (int i = 0; i < n; i++) {
+        double dx = x[i] - out[0];
+        double dy = y[i] - out[1];
+        out[2] += dx * dx;
+        out[3] += dy * dy;
+        out[4] += dx * dy;
+    }
+}
+
+#ifdef QUIZ_X86_KERNELS
+
+__attribute__((target("avx2")))
+static double horizontal_sum(__m256d v) {
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+__attribute__((target("avx2")))
+static void moments_avx2(const float* x, int n, double* mean, double* m2) {
+    __m256d sum_low = _mm256_setzero_pd();
+    __m256d sum_high = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        sum_low = _mm256_add_pd(sum_low, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+        sum_high = _mm256_add_pd(sum_high, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+    }
+    double sum = horizontal_sum(_mm256_add_pd(sum_low, sum_high));
+    for (int j = i; j < n; j++) {
+        sum += x[j];
+    }
+    *mean = sum / n;
+
+    __m256d center = _mm256_set1_pd(*mean);
+    __m256d sq_low = _mm256_setzero_pd();
+    __m256d sq_high = _mm256_setzero_pd();
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(x + i);
+        __m256d d_low = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(v)), center);
+        __m256d d_high = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)), center);
+        sq_low = _mm256_add_pd(sq_low, _mm256_mul_pd(d_low, d_low));
+        sq_high = _mm256_add_pd(sq_high, _mm256_mul_pd(d_high, d_high));
+    }
+    double squares = horizontal_sum(_mm256_add_pd(sq_low, sq_high));
+    for (int j = i; j < n; j++) {
+        double d = x[j] - *mean;
+        squares += d * d;
+    }
+    *m2 = squares;
+}
+
+__attribute__((target("avx2")))
+static void comoments_avx2(const float* x, const float* y, int n, double out[5]) {
+    __m256d sum_x = _mm256_setzero_pd();
+    __m256d sum_y = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        sum_x = _mm256_add_pd(sum_x, _mm256_cvtps_pd(_mm_loadu_ps(x + i)));
+        sum_y = _mm256_add_pd(sum_y, _mm256_cvtps_pd(_mm_loadu_ps(y + i)));
+    }
+    double total_x = horizontal_sum(sum_x);
+    double total_y = horizontal_sum(sum_y);
+    for (int j = i; j < n; j++) {
+        total_x += x[j];
+        total_y += y[j];
+    }
+    out[0] = total_x / n;
+    out[1] = total_y / n;
+
+    __m256d center_x = _mm256_set1_pd(out[0]);
+    __m256d center_y = _mm256_set1_pd(out[1]);
+    __m256d xx = _mm256_setzero_pd();
+    __m256d yy = _mm256_setzero_pd();
+    __m256d xy = _mm256_setzero_pd();
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(x + i)), center_x);
+        __m256d dy = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(y + i)), center_y);
+        xx = _mm256_add_pd(xx, _mm256_mul_pd(dx, dx));
+        yy = _mm256_add_pd(yy, _mm256_mul_pd(dy, dy));
+        xy = _mm256_add_pd(xy, _mm256_mul_pd(dx, dy));
+    }
+    out[2] = horizontal_sum(xx);
+    out[3] = horizontal_sum(yy);
+    out[4] = horizontal_sum(xy);
+    for (int j = i; j < n; j++) {
+        double dx = x[j] - out[0];
+        double dy = y[j] - out[1];
+        out[2] += dx * dx;
+        out[3] += dy * dy;
+        out[4] += dx * dy;
+    }
+}
+
+#endif
+
+static MomentKernel moment_kernel = NULL;
+static CoMomentKernel comoment_kernel = NULL;
+
+static void select_stats_kernels(void) {
+    moment_kernel = moments_scalar;
+    comoment_kernel = comoments_scalar;
+#ifdef QUIZ_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        moment_kernel = moments_avx2;
+        comoment_kernel = comoments_avx2;
+    }
+#endif
+}
+
+// Folds count values into stats
+void stats_accumulate(RunningStats* stats, const float* values, int count) {
+    if (!moment_kernel) {
+        select_stats_kernels();
+    }
+    for (int start = 0; start < count; start += STATS_BLOCK) {
+        int n = count - start < STATS_BLOCK ? count - start : STATS_BLOCK;
+        RunningStats block = { (uint64_t)n, 0.0, 0.0 };
+        moment_kernel(values + start, n, &block.mean, &block.m2);
+        running_stats_merge(stats, &block);
+    }
+}
+
+// Folds count (x, y) pairs into stats
+void stats_accumulate_paired(PairedStats* stats, const float* x, const float* y, int count) {
+    if (!comoment_kernel) {
+        select_stats_kernels();
+    }
+    for (int start = 0; start < count; start += STATS_BLOCK) {
+        int n = count - start < STATS_BLOCK ? count - start : STATS_BLOCK;
+        double moments[5];
+        comoment_kernel(x + start, y + start, n, moments);
+        PairedStats block = { (uint64_t)n, moments[0], moments[1], moments[2], moments[3], moments[4] };
+        paired_stats_merge(stats, &block);
+    }
+}
+
+// ============================================================================
+// PARALLEL SPLIT AND MERGE
+// ============================================================================
+
+// Below this many values per thread, starting threads costs more than it saves
+#define STATS_MIN_PER_THREAD 65536
+#define STATS_MAX_THREADS 64
+
+typedef struct {
+    const float* x;
+    const float* y; // NULL for single-variable statistics
+    int count;
+    RunningStats single;
+    PairedStats paired;
+} StatsRange;
+
+static void* stats_range_main(void* arg) {
+    StatsRange* range = arg;
+    if (range->y) {
+        stats_accumulate_paired(&range->paired, range->x, range->y, range->count);
+    } else {
+        stats_accumulate(&range->single, range->x, range->count);
+    }
+    return NULL;
+}
+
+// Splits the input into contiguous ranges, one per thread, and merges the
+// partial results in range order
+static void stats_run_parallel(const float* x, const float* y, int count, int threads,
+                               RunningStats* single, PairedStats* paired) {
+    if (threads > count / STATS_MIN_PER_THREAD) {
+        threads = count / STATS_MIN_PER_THREAD;
+    }
+    if (threads > STATS_MAX_THREADS) {
+        threads = STATS_MAX_THREADS;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    StatsRange ranges[STATS_MAX_THREADS];
+    pthread_t handles[STATS_MAX_THREADS];
+    int started[STATS_MAX_THREADS] = { 0 };
+    int per_thread = count / threads;
+    for (int t = 0; t < threads; t++) {
+        int start = t * per_thread;
+        memset(&ranges[t], 0, sizeof(StatsRange));
+        ranges[t].x = x + start;
+        ranges[t].y = y ? y + start : NULL;
+        ranges[t].count = t == threads - 1 ? count - start : per_thread;
+        // The calling thread takes the first range itself
+        started[t] = t > 0 && pthread_create(&handles[t], NULL, stats_range_main, &ranges[t]) == 0;
+    }
+    for (int t = 0; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(handles[t], NULL);
+        } else {
+            stats_range_main(&ranges[t]);
+        }
+        if (y) {
+            paired_stats_merge(paired, &ranges[t].paired);
+        } else {
+            running_stats_merge(single, &ranges[t].single);
+        }
+    }
+}
+
+void stats_accumulate_parallel(RunningStats* stats, const float* values, int count, int threads) {
+    stats_run_parallel(values, NULL, count, threads, stats, NULL);
+}
+
+void stats_accumulate_paired_parallel(PairedStats* stats, const float* x, const float* y, int count, int threads) {
+    stats_run_parallel(x, y, count, threads, NULL, stats);
+}
+
+// ============================================================================
+// CLASSIC HELPERS
+// ============================================================================
+
+// Population standard deviation
+float calculate_standard_deviation(float values[], int count) {
+    RunningStats stats;
+    running_stats_init(&stats);
+    stats_accumulate(&stats, values, count);
+    return (float)sqrt(running_stats_variance(&stats));
+}
+
+float calculate_correlation(float x[], float y[], int count) {
+    PairedStats stats;
+    paired_stats_init(&stats);
+    stats_accumulate_paired(&stats, x, y, count);
+    return (float)paired_stats_correlation(&stats);
+}
+
+// ============================================================================
+// COHORT ANALYTICS
+// ============================================================================
+
+// Per topic, over students who attempted it: the spread of topic scores and
+// how topic accuracy tracks overall accuracy
+void analyze_cohort_topics(CohortTopicStats stats[NUM_C_TOPICS]) {
+    int students = get_total_students();
+    float* overall = malloc(((size_t)students + 1) * sizeof(float));
+    float* accuracy = malloc(((size_t)students + 1) * sizeof(float));
+    float* scores = malloc(((size_t)students + 1) * sizeof(float));
+
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        running_stats_init(&stats[t].topic_score);
+        paired_stats_init(&stats[t].accuracy_vs_overall);
+        if (!overall || !accuracy || !scores) {
+            continue;
+        }
+
+        // Gather the topic's column once, then run the block kernels on it
+        int n = 0;
+        for (int i = 0; i < students; i++) {
+            Student* student = get_student_at(i);
+            int attempted = student->topic_questions_attempted[t];
+            if (attempted == 0) {
+                continue;
+            }
+            scores[n] = student->topic_scores[t];
+            overall[n] = student->overall_accuracy;
+            accuracy[n] = (float)student->topic_questions_correct[t] / attempted;
+            n++;
+        }
+        stats_accumulate(&stats[t].topic_score, scores, n);
+        stats_accumulate_paired(&stats[t].accuracy_vs_overall, overall, accuracy, n);
+    }
+    free(overall);
+    free(accuracy);
+    free(scores);
+}
+
+// Over questions that have been asked: accuracy, average answer time and
+// how the two relate
+void analyze_question_bank(QuestionBankStats* stats, int threads) {
+    QuestionHotTable* hot = get_question_hot_table();
+    float* accuracy = malloc(((size_t)hot->count + 1) * sizeof(float));
+    float* time_taken = malloc(((size_t)hot->count + 1) * sizeof(float));
+
+    running_stats_init(&stats->accuracy);
+    running_stats_init(&stats->time_taken);
+    paired_stats_init(&stats->time_vs_accuracy);
+    if (!accuracy || !time_taken) {
+        free(accuracy);
+        free(time_taken);
+        return;
+    }
+
+    int n = 0;
+    for (int slot = 0; slot < hot->count; slot++) {
+        if (hot->times_asked[slot] > 0) {
+            accuracy[n] = (float)hot->times_correct[slot] / hot->times_asked[slot];
+            time_taken[n] = hot->avg_time_taken[slot];
+            n++;
+        }
+    }
+    stats_accumulate_parallel(&stats->accuracy, accuracy, n, threads);
+    stats_accumulate_parallel(&stats->time_taken, time_taken, n, threads);
+    stats_accumulate_paired_parallel(&stats->time_vs_accuracy, time_taken, accuracy, n, threads);
+    free(accuracy);
+    free(time_taken);
+}
+
+// ============================================================================
+// EXAM SCORE PREDICTION
+// ============================================================================
+
+// For each topic, a cohort-wide least-squares line predicts a student's
+// topic accuracy from their overall accuracy. A student's own topic record
+// is blended with that prediction in proportion to how much evidence it
+// holds, and the exam score is the mean predicted accuracy over all topics.
+#define PREDICTION_PRIOR_ATTEMPTS 10.0 // attempts at which own record and trend weigh equally
+
+typedef struct {
+    double slope[NUM_C_TOPICS];
+    double intercept[NUM_C_TOPICS];
+    int fitted;
+} ExamModel;
+
+static ExamModel exam_model;
+
+static void fit_exam_model(void) {
+    CohortTopicStats topics[NUM_C_TOPICS];
+    analyze_cohort_topics(topics);
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        if (topics[t].accuracy_vs_overall.count >= 2) {
+            paired_stats_fit(&topics[t].accuracy_vs_overall, &exam_model.slope[t], &exam_model.intercept[t]);
+        } else {
+            // Too little data: assume topic accuracy equals overall accuracy
+            exam_model.slope[t] = 1.0;
+            exam_model.intercept[t] = 0.0;
+        }
+    }
+    exam_model.fitted = 1;
+}
+
+static void predict_exam_score(Student* student) {
+    double total = 0.0;
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        double trend = exam_model.intercept[t] + exam_model.slope[t] * student->overall_accuracy;
+        int attempted = student->topic_questions_attempted[t];
+        double own = attempted > 0 ? (double)student->topic_questions_correct[t] / attempted : trend;
+        double weight = attempted / (attempted + PREDICTION_PRIOR_ATTEMPTS);
+        double predicted = weight * own + (1.0 - weight) * trend;
+        total += predicted < 0.0 ? 0.0 : predicted > 1.0 ? 1.0 : predicted;
+    }
+    student->predicted_exam_score = (float)(total / NUM_C_TOPICS * 100.0);
+}
+
+// Refits the model on the whole cohort and fills predicted_exam_score for
+// every registered student; returns how many were updated
+int predict_cohort_exam_scores(void) {
+    fit_exam_model();
+    int students = get_total_students();
+    for (int i = 0; i < students; i++) {
+        predict_exam_score(get_student_at(i));
+    }
+    return students;
+}
+
+// Fills one student's predicted_exam_score from the last cohort fit
+void perform_regression_analysis(Student* student) {
+    if (!exam_model.fitted) {
+        fit_exam_model();
+    }
+    predict_exam_score(student);
+}
@@ -0,0 +1,1391 @@
+// quiz_storage.c - Question storage for the C Programming Quiz System
+// Keeps compact question records, the hot per-question columns and the
+// interned text arena that holds every question string, and maps the
+// binary question file straight into those stores, reading its text
+// through a bounded cache
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "quiz_system.h"
+
+#include <pthread.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ============================================================================
+// TEXT ARENA
+// ============================================================================
+
+// Each entry is a 4-byte length followed by the bytes and a terminating NUL,
+// padded to 4 bytes. A TextRef is the offset of the length prefix. Offset 0
+// holds the empty string so zero-initialised records render as "".
+// When a question file is mapped, its string pool becomes a read-only base
+// segment and refs past its end address entries appended on the heap.
+#define TEXT_ENTRY_ALIGN 4
+#define TEXT_ARENA_INITIAL_SIZE 4096
+#define TEXT_INTERN_INITIAL_SLOTS 1024
+
+typedef struct {
+    const char* base; // mapped string pool, or NULL
+    uint32_t base_size;
+    char* data;       // heap entries, addressed from base_size onwards
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t* slots;  // open-addressing intern table of refs, 0 = free
+    uint32_t* hashes; // hash of the string stored in the matching slot
+    uint32_t slot_count;
+    uint32_t entry_count;
+} TextArena;
+
+static TextArena text_arena;
+
+static uint32_t hash_text(const char* str, uint32_t length) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t text_entry_size(uint32_t length) {
+    uint32_t size = (uint32_t)sizeof(uint32_t) + length + 1;
+    return (size + TEXT_ENTRY_ALIGN - 1) & ~(uint32_t)(TEXT_ENTRY_ALIGN - 1);
+}
+
+static int text_arena_reserve(uint32_t extra) {
+    if (text_arena.size + extra <= text_arena.capacity) {
+        return 1;
+    }
+    uint32_t capacity = text_arena.capacity ? text_arena.capacity : TEXT_ARENA_INITIAL_SIZE;
+    while (capacity < text_arena.size + extra) {
+        capacity *= 2;
+    }
+    char* data = realloc(text_arena.data, capacity);
+    if (!data) {
+        return 0;
+    }
+    text_arena.data = data;
+    text_arena.capacity = capacity;
+    return 1;
+}
+
+static int text_intern_grow(void) {
+    uint32_t slot_count = text_arena.slot_count ? text_arena.slot_count * 2 : TEXT_INTERN_INITIAL_SLOTS;
+    uint32_t* slots = calloc(slot_count, sizeof(uint32_t));
+    uint32_t* hashes = calloc(slot_count, sizeof(uint32_t));
+    if (!slots || !hashes) {
+        free(slots);
+        free(hashes);
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < text_arena.slot_count; i++) {
+        if (text_arena.slots[i] == 0) {
+            continue;
+        }
+        uint32_t pos = text_arena.hashes[i] & (slot_count - 1);
+        while (slots[pos] != 0) {
+            pos = (pos + 1) & (slot_count - 1);
+        }
+        slots[pos] = text_arena.slots[i];
+        hashes[pos] = text_arena.hashes[i];
+    }
+
+    free(text_arena.slots);
+    free(text_arena.hashes);
+    text_arena.slots = slots;
+    text_arena.hashes = hashes;
+    text_arena.slot_count = slot_count;
+    return 1;
+}
+
+static void text_arena_init(void) {
+    if (text_arena.data) {
+        return;
+    }
+    text_arena_reserve(TEXT_ARENA_INITIAL_SIZE);
+    if (text_arena.base_size == 0) {
+        memset(text_arena.data, 0, text_entry_size(0));
+        text_arena.size = text_entry_size(0);
+    }
+}
+
+static const char* text_cache_get(TextRef ref);
+
+static const char* text_entry(TextRef ref) {
+    if (ref < text_arena.base_size) {
+        return text_arena.base ? text_arena.base + ref : text_cache_get(ref);
+    }
+    ref -= text_arena.base_size;
+    return ref < text_arena.size ? text_arena.data + ref : NULL;
+}
+
+TextRef text_intern(const char* str) {
+    if (!str || str[0] == '\0') {
+        return TEXT_REF_EMPTY;
+    }
+    text_arena_init();
+
+    uint32_t length = (uint32_t)strlen(str);
+    uint32_t hash = hash_text(str, length);
+
+    if ((text_arena.entry_count + 1) * 2 > text_arena.slot_count && !text_intern_grow()) {
+        return TEXT_REF_EMPTY;
+    }
+
+    uint32_t mask = text_arena.slot_count - 1;
+    uint32_t pos = hash & mask;
+    while (text_arena.slots[pos] != 0) {
+        TextRef ref = text_arena.slots[pos];
+        if (text_arena.hashes[pos] == hash && text_length(ref) == length &&
+            memcmp(text_get(ref), str, length) == 0) {
+            return ref;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    uint32_t entry_size = text_entry_size(length);
+    if (!text_arena_reserve(entry_size)) {
+        return TEXT_REF_EMPTY;
+    }
+
+    TextRef ref = text_arena.base_size + text_arena.size;
+    char* entry = text_arena.data + text_arena.size;
+    memcpy(entry, &length, sizeof(uint32_t));
+    memcpy(entry + sizeof(uint32_t), str, length);
+    memset(entry + sizeof(uint32_t) + length, 0, entry_size - sizeof(uint32_t) - length);
+    text_arena.size += entry_size;
+
+    text_arena.slots[pos] = ref;
+    text_arena.hashes[pos] = hash;
+    text_arena.entry_count++;
+    return ref;
+}
+
+// The returned pointer is invalidated by the next text_intern call, or once
+// the calling thread has read TEXT_CACHE_PINNED more strings from a lazily
+// loaded file
+const char* text_get(TextRef ref) {
+    const char* entry = ref == TEXT_REF_EMPTY ? NULL : text_entry(ref);
+    return entry ? entry + sizeof(uint32_t) : "";
+}
+
+uint32_t text_length(TextRef ref) {
+    uint32_t length = 0;
+    const char* entry = ref == TEXT_REF_EMPTY ? NULL : text_entry(ref);
+    if (entry) {
+        memcpy(&length, entry, sizeof(uint32_t));
+    }
+    return length;
+}
+
+size_t text_arena_size(void) {
+    return (size_t)text_arena.base_size + text_arena.size;
+}
+
+// ============================================================================
+// LAZY TEXT CACHE
+// ============================================================================
+
+// With a budget set, loading maps only the records and columns of a question
+// file and leaves its string pool on disk. Entries are read with pread the
+// first time they are rendered and kept in an LRU cache of at most `budget`
+// bytes, so a bank of any size runs in a fixed memory envelope. Strings
+// each thread has read most recently through text_get are pinned, so its
+// pointers stay valid whatever other threads read meanwhile.
+#define TEXT_CACHE_DEFAULT_BUDGET ((size_t)4 << 20)
+#define TEXT_CACHE_PINNED 8         // latest entries read per thread, never evicted
+#define TEXT_CACHE_READ_SIZE 256    // first read, length prefix included
+#define TEXT_CACHE_INITIAL_BUCKETS 256
+#define TEXT_PREFETCH_BYTES 4096    // read-ahead hinted per string
+
+typedef struct {
+    TextRef ref;
+    uint32_t size; // length prefix, text and NUL
+    int newer;     // LRU neighbours, -1 at either end
+    int older;
+    int chain;     // next entry in the same bucket, or in the free list
+    int pins;      // places it holds in threads' pin rings
+    char* entry;
+} TextCacheEntry;
+
+static struct {
+    int fd; // string pool source, or -1 when text is in memory
+    uint64_t pool_offset;
+    size_t budget;
+    size_t bytes;
+    TextCacheEntry* entries;
+    int entry_count; // in use
+    int capacity;
+    int free_list;
+    int* buckets;
+    int bucket_count;
+    int newest;
+    int oldest;
+    unsigned int epoch; // bumped whenever the cache is emptied
+    long hits;
+    long misses;
+    long evictions;
+} text_cache = { -1, 0, TEXT_CACHE_DEFAULT_BUDGET, 0, NULL, 0, 0, -1, NULL, 0, -1, -1, 0, 0, 0, 0 };
+
+static pthread_mutex_t text_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// The strings one thread has read most recently through text_get
+typedef struct {
+    TextRef refs[TEXT_CACHE_PINNED]; // TEXT_REF_EMPTY for a free place
+    int next;
+    unsigned int epoch; // cache the refs were pinned in
+    int registered;     // released when the thread exits
+} TextPinRing;
+
+static _Thread_local TextPinRing text_pins;
+static pthread_once_t text_pin_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t text_pin_key;
+
+static void text_cache_trim(size_t incoming);
+
+// A smaller budget evicts unpinned entries down to it at once. Whether text
+// is cached at all (bytes > 0) or read from a whole mapped file (0) is
+// decided at the next load.
+void set_text_cache_budget(size_t bytes) {
+    pthread_mutex_lock(&text_cache_lock);
+    text_cache.budget = bytes;
+    if (text_cache.fd >= 0) {
+        text_cache_trim(0);
+    }
+    pthread_mutex_unlock(&text_cache_lock);
+}
+
+void get_text_cache_stats(TextCacheStats* stats) {
+    pthread_mutex_lock(&text_cache_lock);
+    stats->budget = text_cache.fd >= 0 ? text_cache.budget : 0;
+    stats->bytes = text_cache.bytes;
+    stats->entries = text_cache.entry_count;
+    stats->hits = text_cache.hits;
+    stats->misses = text_cache.misses;
+    stats->evictions = text_cache.evictions;
+    pthread_mutex_unlock(&text_cache_lock);
+}
+
+static uint32_t text_cache_bucket(TextRef ref) {
+    return (ref * 2654435761u) & (uint32_t)(text_cache.bucket_count - 1);
+}
+
+static void text_cache_unlink(int e) {
+    TextCacheEntry* entry = &text_cache.entries[e];
+    if (entry->newer >= 0) {
+        text_cache.entries[entry->newer].older = entry->older;
+    } else {
+        text_cache.newest = entry->older;
+    }
+    if (entry->older >= 0) {
+        text_cache.entries[entry->older].newer = entry->newer;
+    } else {
+        text_cache.oldest = entry->newer;
+    }
+}
+
+static void text_cache_push_newest(int e) {
+    TextCacheEntry* entry = &text_cache.entries[e];
+    entry->newer = -1;
+    entry->older = text_cache.newest;
+    if (text_cache.newest >= 0) {
+        text_cache.entries[text_cache.newest].newer = e;
+    } else {
+        text_cache.oldest = e;
+    }
+    text_cache.newest = e;
+}
+
+static int text_cache_find(TextRef ref) {
+    if (text_cache.bucket_count == 0) {
+        return -1;
+    }
+    for (int e = text_cache.buckets[text_cache_bucket(ref)]; e >= 0; e = text_cache.entries[e].chain) {
+        if (text_cache.entries[e].ref == ref) {
+            return e;
+        }
+    }
+    return -1;
+}
+
+static void text_cache_unpin(TextPinRing* ring) {
+    if (ring->epoch != text_cache.epoch) {
+        memset(ring->refs, 0, sizeof(ring->refs)); // pinned in a cache since released
+        ring->epoch = text_cache.epoch;
+        return;
+    }
+    for (int i = 0; i < TEXT_CACHE_PINNED; i++) {
+        int e = ring->refs[i] != TEXT_REF_EMPTY ? text_cache_find(ring->refs[i]) : -1;
+        if (e >= 0) {
+            text_cache.entries[e].pins--;
+        }
+        ring->refs[i] = TEXT_REF_EMPTY;
+    }
+}
+
+static void text_cache_retire_thread(void* ring) {
+    pthread_mutex_lock(&text_cache_lock);
+    text_cache_unpin(ring);
+    pthread_mutex_unlock(&text_cache_lock);
+}
+
+static void text_cache_create_pin_key(void) {
+    pthread_key_create(&text_pin_key, text_cache_retire_thread);
+}
+
+// Takes the calling thread's oldest place in its ring; that string may be
+// evicted again unless another place still holds it
+static void text_cache_pin(int e) {
+    TextPinRing* ring = &text_pins;
+    if (!ring->registered) {
+        pthread_once(&text_pin_key_once, text_cache_create_pin_key);
+        pthread_setspecific(text_pin_key, ring);
+        ring->registered = 1;
+    }
+    if (ring->epoch != text_cache.epoch) {
+        memset(ring->refs, 0, sizeof(ring->refs));
+        ring->epoch = text_cache.epoch;
+    }
+    TextRef old = ring->refs[ring->next];
+    int o = old != TEXT_REF_EMPTY ? text_cache_find(old) : -1;
+    if (o >= 0) {
+        text_cache.entries[o].pins--;
+    }
+    ring->refs[ring->next] = text_cache.entries[e].ref;
+    text_cache.entries[e].pins++;
+    ring->next = (ring->next + 1) % TEXT_CACHE_PINNED;
+}
+
+static void text_cache_evict(int e) {
+    TextCacheEntry* entry = &text_cache.entries[e];
+    int* link = &text_cache.buckets[text_cache_bucket(entry->ref)];
+    while (*link != e) {
+        link = &text_cache.entries[*link].chain;
+    }
+    *link = entry->chain;
+    text_cache_unlink(e);
+
+    text_cache.bytes -= entry->size;
+    free(entry->entry);
+    entry->entry = NULL;
+    entry->chain = text_cache.free_list;
+    text_cache.free_list = e;
+    text_cache.entry_count--;
+    text_cache.evictions++;
+}
+
+// Frees the oldest unpinned entries until `incoming` more bytes fit the
+// budget. Runs before an entry is inserted, so never evicts the one being
+// returned; a string larger than the budget is kept until the next read.
+static void text_cache_trim(size_t incoming) {
+    int e = text_cache.oldest;
+    while (e >= 0 && text_cache.bytes + incoming > text_cache.budget) {
+        int newer = text_cache.entries[e].newer;
+        if (text_cache.entries[e].pins == 0) {
+            text_cache_evict(e);
+        }
+        e = newer;
+    }
+}
+
+static int text_cache_grow(void) {
+    int capacity = text_cache.capacity ? text_cache.capacity * 2 : TEXT_CACHE_INITIAL_BUCKETS;
+    TextCacheEntry* entries = realloc(text_cache.entries, capacity * sizeof(TextCacheEntry));
+    if (!entries) {
+        return 0;
+    }
+    text_cache.entries = entries;
+    int* buckets = malloc(capacity * sizeof(int));
+    if (!buckets) {
+        return 0;
+    }
+    for (int b = 0; b < capacity; b++) {
+        buckets[b] = -1;
+    }
+    free(text_cache.buckets);
+    text_cache.buckets = buckets;
+    text_cache.bucket_count = capacity;
+
+    // One bucket per entry slot; rehash what is cached and free the rest
+    text_cache.free_list = -1;
+    for (int e = capacity - 1; e >= 0; e--) {
+        if (e < text_cache.capacity && entries[e].entry) {
+            uint32_t b = text_cache_bucket(entries[e].ref);
+            entries[e].chain = buckets[b];
+            buckets[b] = e;
+        } else {
+            entries[e].entry = NULL;
+            entries[e].chain = text_cache.free_list;
+            text_cache.free_list = e;
+        }
+    }
+    text_cache.capacity = capacity;
+    return 1;
+}
+
+// Returns the cached entry, reading it on a miss; with `pin` it joins the
+// calling thread's pin ring. Called with text_cache_lock held.
+static const char* text_cache_fetch(TextRef ref, int pin) {
+    if (text_cache.fd < 0) {
+        return NULL;
+    }
+
+    int e = text_cache_find(ref);
+    if (e >= 0) {
+        text_cache_unlink(e);
+        text_cache_push_newest(e);
+        text_cache.hits++;
+        if (pin) {
+            text_cache_pin(e);
+        }
+        return text_cache.entries[e].entry;
+    }
+
+#ifndef _WIN32
+    // Most strings fit in the first read; longer ones need a second
+    char head[TEXT_CACHE_READ_SIZE];
+    uint32_t available = text_arena.base_size - ref;
+    ssize_t got = pread(text_cache.fd, head, available < sizeof(head) ? available : sizeof(head),
+                        (off_t)(text_cache.pool_offset + ref));
+    uint32_t length;
+    if (got < (ssize_t)sizeof(uint32_t)) {
+        return NULL;
+    }
+    memcpy(&length, head, sizeof(uint32_t));
+    if (length >= available - sizeof(uint32_t)) {
+        return NULL; // runs past the pool: corrupt
+    }
+    uint32_t size = (uint32_t)sizeof(uint32_t) + length + 1;
+    char* entry = malloc(size);
+    if (!entry) {
+        return NULL;
+    }
+    uint32_t have = (uint32_t)got < size ? (uint32_t)got : size;
+    memcpy(entry, head, have);
+    if (have < size && pread(text_cache.fd, entry + have, size - have,
+                             (off_t)(text_cache.pool_offset + ref + have)) != (ssize_t)(size - have)) {
+        free(entry);
+        return NULL;
+    }
+    entry[size - 1] = '\0';
+    text_cache.misses++;
+
+    text_cache_trim(size);
+    if (text_cache.free_list < 0 && !text_cache_grow()) {
+        free(entry);
+        return NULL;
+    }
+    e = text_cache.free_list;
+    text_cache.free_list = text_cache.entries[e].chain;
+    TextCacheEntry* cached = &text_cache.entries[e];
+    cached->ref = ref;
+    cached->size = size;
+    cached->pins = 0;
+    cached->entry = entry;
+    uint32_t b = text_cache_bucket(ref);
+    cached->chain = text_cache.buckets[b];
+    text_cache.buckets[b] = e;
+    text_cache_push_newest(e);
+    text_cache.entry_count++;
+    text_cache.bytes += size;
+    if (pin) {
+        text_cache_pin(e);
+    }
+    return entry;
+#else
+    return NULL;
+#endif
+}
+
+static const char* text_cache_get(TextRef ref) {
+    pthread_mutex_lock(&text_cache_lock);
+    const char* entry = text_cache_fetch(ref, 1);
+    pthread_mutex_unlock(&text_cache_lock);
+    return entry;
+}
+
+// Copies a string into buffer, truncated to fit and always terminated, and
+// returns its full length. Safe on any thread while questions are rendered,
+// as long as none are being added.
+uint32_t text_copy(TextRef ref, char* buffer, size_t size) {
+    uint32_t length = 0;
+    if (size == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+    if (ref == TEXT_REF_EMPTY) {
+        return 0;
+    }
+    int cached = ref < text_arena.base_size && !text_arena.base;
+    if (cached) {
+        pthread_mutex_lock(&text_cache_lock);
+    }
+    const char* entry = cached ? text_cache_fetch(ref, 0) : text_entry(ref);
+    if (entry) {
+        memcpy(&length, entry, sizeof(uint32_t));
+        size_t copied = length < size - 1 ? length : size - 1;
+        memcpy(buffer, entry + sizeof(uint32_t), copied);
+        buffer[copied] = '\0';
+    }
+    if (cached) {
+        pthread_mutex_unlock(&text_cache_lock);
+    }
+    return length;
+}
+
+static void text_cache_release(void) {
+    for (int e = 0; e < text_cache.capacity; e++) {
+        free(text_cache.entries[e].entry);
+    }
+    free(text_cache.entries);
+    free(text_cache.buckets);
+#ifndef _WIN32
+    if (text_cache.fd >= 0) {
+        close(text_cache.fd);
+    }
+#endif
+    size_t budget = text_cache.budget;
+    unsigned int epoch = text_cache.epoch;
+    memset(&text_cache, 0, sizeof(text_cache));
+    text_cache.fd = -1;
+    text_cache.budget = budget;
+    text_cache.epoch = epoch + 1; // every thread's pins are now stale
+    text_cache.newest = -1;
+    text_cache.oldest = -1;
+    text_cache.free_list = -1;
+}
+
+// Points text reads below the pool size at an open question file
+static void text_cache_attach(int fd, uint64_t pool_offset) {
+    text_cache_release();
+    text_cache.fd = fd;
+    text_cache.pool_offset = pool_offset;
+}
+
+// Copies the on-disk pool into a new question file
+static int text_cache_copy_pool(FILE* fp, uint32_t* checksum) {
+#ifndef _WIN32
+    char buffer[65536];
+    uint64_t done = 0;
+    while (done < text_arena.base_size) {
+        uint64_t want = text_arena.base_size - done;
+        ssize_t got = pread(text_cache.fd, buffer, want < sizeof(buffer) ? (size_t)want : sizeof(buffer),
+                            (off_t)(text_cache.pool_offset + done));
+        if (got <= 0 || fwrite(buffer, 1, (size_t)got, fp) != (size_t)got) {
+            return 0;
+        }
+        *checksum = checksum_update(*checksum, buffer, (size_t)got);
+        done += (uint64_t)got;
+    }
+    return 1;
+#else
+    (void)fp;
+    (void)checksum;
+    return 0;
+#endif
+}
+
+// Hints the kernel to start reading a question's text, e.g. the next one
+// in an exam while the student answers the current one. Cached strings and
+// strings already in memory cost nothing.
+void prefetch_question_text(const Question* question) {
+#ifndef _WIN32
+    TextRef refs[] = { question->question, question->code_snippet, question->explanation, question->options[0],
+                       question->hints[0] };
+    for (size_t i = 0; i < sizeof(refs) / sizeof(refs[0]); i++) {
+        TextRef ref = refs[i];
+        if (ref == TEXT_REF_EMPTY || ref >= text_arena.base_size) {
+            continue;
+        }
+        if (text_arena.base) {
+            // Mapped pool: advise on the pages the string starts in
+            uintptr_t start = (uintptr_t)(text_arena.base + ref) & ~(uintptr_t)(TEXT_PREFETCH_BYTES - 1);
+            posix_madvise((void*)start, TEXT_PREFETCH_BYTES, POSIX_MADV_WILLNEED);
+        } else if (text_cache.fd >= 0) {
+            posix_fadvise(text_cache.fd, (off_t)(text_cache.pool_offset + ref), TEXT_PREFETCH_BYTES,
+                          POSIX_FADV_WILLNEED);
+        }
+    }
+#else
+    (void)question;
+#endif
+}
+
+// ============================================================================
+// CHUNKED ARRAYS
+// ============================================================================
+
+// Elements live in fixed-size chunks that are never moved, so pointers to
+// them stay valid while the array grows.
+
+void chunked_array_init(ChunkedArray* array, size_t element_size, int elements_per_chunk) {
+    memset(array, 0, sizeof(ChunkedArray));
+    array->element_size = element_size;
+    array->elements_per_chunk = elements_per_chunk;
+}
+
+// Returns a zeroed element at the end of the array, or NULL when out of memory
+void* chunked_array_push(ChunkedArray* array) {
+    int chunk = array->count / array->elements_per_chunk;
+    if (chunk == array->chunk_count) {
+        if (array->chunk_count == array->chunk_capacity) {
+            int capacity = array->chunk_capacity ? array->chunk_capacity * 2 : 16;
+            char** chunks = realloc(array->chunks, capacity * sizeof(char*));
+            if (!chunks) {
+                return NULL;
+            }
+            array->chunks = chunks;
+            array->chunk_capacity = capacity;
+        }
+        array->chunks[chunk] = calloc(array->elements_per_chunk, array->element_size);
+        if (!array->chunks[chunk]) {
+            return NULL;
+        }
+        array->chunk_count++;
+    }
+
+    void* element = chunked_array_at(array, array->count);
+    memset(element, 0, array->element_size);
+    array->count++;
+    return element;
+}
+
+void* chunked_array_at(const ChunkedArray* array, int index) {
+    int chunk = index / array->elements_per_chunk;
+    int offset = index % array->elements_per_chunk;
+    return array->chunks[chunk] + (size_t)offset * array->element_size;
+}
+
+void chunked_array_free(ChunkedArray* array) {
+    for (int i = 0; i < array->chunk_count; i++) {
+        free(array->chunks[i]);
+    }
+    free(array->chunks);
+    chunked_array_init(array, array->element_size, array->elements_per_chunk);
+}
+
+size_t chunked_array_bytes(const ChunkedArray* array) {
+    return (size_t)array->chunk_count * array->elements_per_chunk * array->element_size +
+           (size_t)array->chunk_capacity * sizeof(char*);
+}
+
+// ============================================================================
+// QUESTION RECORDS AND HOT TABLE
+// ============================================================================
+
+#define QUESTIONS_PER_CHUNK 1024
+#define STUDENTS_PER_CHUNK 256
+
+static ChunkedArray question_records = { sizeof(Question), QUESTIONS_PER_CHUNK, 0, NULL, 0, 0 };
+static QuestionHotTable question_hot;
+static int question_hot_capacity = 0;
+static int question_hot_owned = 1; // 0 while the columns point into a mapping
+
+// Records of an attached image occupy slots [0, image_count); later
+// questions are appended to question_records
+static Question* image_records = NULL;
+static int image_count = 0;
+
+// Bumped whenever existing slots are invalidated, so indexes know to rebuild
+static unsigned int store_generation = 1;
+
+// Set when questions are added after the last load or save, so the next save
+// must rewrite the whole file instead of just the stats columns
+static int question_structure_dirty = 0;
+
+QuestionHotTable* get_question_hot_table(void) {
+    return &question_hot;
+}
+
+Question* question_at(int slot) {
+    if (slot < 0 || slot >= question_hot.count) {
+        return NULL;
+    }
+    if (slot < image_count) {
+        return &image_records[slot];
+    }
+    return chunked_array_at(&question_records, slot - image_count);
+}
+
+TopicIndex question_topic(const Question* question) {
+    return (TopicIndex)question_hot.topic[question->slot];
+}
+
+int question_difficulty(const Question* question) {
+    return question_hot.difficulty[question->slot];
+}
+
+static int grow_column(void** column, size_t element_size, int capacity) {
+    void* grown;
+    if (question_hot_owned) {
+        grown = realloc(*column, (size_t)capacity * element_size);
+    } else {
+        // Mapped columns are copied to the heap on first growth
+        grown = malloc((size_t)capacity * element_size);
+        if (grown) {
+            memcpy(grown, *column, (size_t)question_hot.count * element_size);
+        }
+    }
+    if (!grown) {
+        return 0;
+    }
+    *column = grown;
+    return 1;
+}
+
+// Columns are indexed by slot rather than held by pointer, so they can move
+static int question_hot_reserve(int needed) {
+    if (needed <= question_hot_capacity) {
+        return 1;
+    }
+    int capacity = question_hot_capacity ? question_hot_capacity : QUESTIONS_PER_CHUNK;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    if (!grow_column((void**)&question_hot.id, sizeof(int), capacity) ||
+        !grow_column((void**)&question_hot.topic, sizeof(unsigned char), capacity) ||
+        !grow_column((void**)&question_hot.difficulty, sizeof(unsigned char), capacity) ||
+        !grow_column((void**)&question_hot.times_asked, sizeof(int), capacity) ||
+        !grow_column((void**)&question_hot.times_correct, sizeof(int), capacity) ||
+        !grow_column((void**)&question_hot.avg_time_taken, sizeof(float), capacity)) {
+        return 0;
+    }
+    question_hot_capacity = capacity;
+    question_hot_owned = 1;
+    return 1;
+}
+
+// Interns the draft's strings and appends a row; returns the slot or -1
+int question_store_append(const QuestionDraft* draft) {
+    if (!question_hot_reserve(question_hot.count + 1)) {
+        return -1;
+    }
+    Question* q = chunked_array_push(&question_records);
+    if (!q) {
+        return -1;
+    }
+
+    int slot = question_hot.count;
+    q->id = draft->id;
+    q->slot = slot;
+    q->correct_answer = draft->correct_answer;
+    q->type = draft->type;
+    q->question = text_intern(draft->question);
+    for (int i = 0; i < MAX_OPTIONS; i++) {
+        q->options[i] = text_intern(draft->options[i]);
+    }
+    q->explanation = text_intern(draft->explanation);
+    q->code_snippet = text_intern(draft->code_snippet);
+    for (int i = 0; i < MAX_HINTS; i++) {
+        q->hints[i] = text_intern(draft->hints[i]);
+    }
+    for (int i = 0; i < MAX_KEYWORDS; i++) {
+        q->keywords[i] = text_intern(draft->keywords[i]);
+    }
+    q->author = text_intern(draft->author);
+    q->date_created = draft->date_created ? draft->date_created : time(NULL);
+
+    question_hot.id[slot] = draft->id;
+    question_hot.topic[slot] = (unsigned char)draft->topic;
+    question_hot.difficulty[slot] = (unsigned char)draft->difficulty;
+    question_hot.times_asked[slot] = 0;
+    question_hot.times_correct[slot] = 0;
+    question_hot.avg_time_taken[slot] = 0.0f;
+    question_hot.count++;
+    question_structure_dirty = 1;
+
+    return slot;
+}
+
+static void release_question_image(void);
+
+unsigned int question_store_generation(void) {
+    return store_generation;
+}
+
+void question_store_reset(void) {
+    store_generation++;
+    chunked_array_free(&question_records);
+    if (question_hot_owned) {
+        free(question_hot.id);
+        free(question_hot.topic);
+        free(question_hot.difficulty);
+        free(question_hot.times_asked);
+        free(question_hot.times_correct);
+        free(question_hot.avg_time_taken);
+    }
+    memset(&question_hot, 0, sizeof(QuestionHotTable));
+    question_hot_capacity = 0;
+    question_hot_owned = 1;
+    release_question_image();
+
+    free(text_arena.data);
+    free(text_arena.slots);
+    free(text_arena.hashes);
+    memset(&text_arena, 0, sizeof(TextArena));
+    rebuild_question_indexes();
+}
+
+// ============================================================================
+// MAPPED QUESTION FILES
+// ============================================================================
+
+// Layout of data/questions.dat (native byte order, all sections 8-aligned):
+//   header | Question records[count] | id, topic, difficulty columns |
+//   times_asked, times_correct, avg_time_taken columns | string pool
+// Records reference the pool by TextRef, so the file is usable in place:
+// loading maps it and points the stores at it, and text pages are only
+// faulted in when a question is rendered. The stats columns sit together at
+// the end so a save with no new questions rewrites just that region.
+#define QUESTION_FILE_MAGIC "CQUIZBNK"
+#define QUESTION_FILE_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t question_count;
+    uint32_t record_size;
+    uint64_t records_offset;
+    uint64_t columns_offset;
+    uint64_t stats_offset;
+    uint64_t pool_offset;
+    uint64_t pool_size;
+    uint32_t metadata_checksum; // records plus id/topic/difficulty columns
+    uint32_t pool_checksum;     // checked by verify_question_file only
+    uint32_t header_checksum;
+    uint32_t reserved;
+} QuestionFileHeader;
+
+static void* mapped_file = NULL;
+static size_t mapped_file_size = 0;
+static void* bank_stats = NULL; // stats columns of an attached compiled-in bank
+static char attached_path[MAX_STRING] = "";
+static uint64_t attached_stats_offset = 0;
+
+static uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+// FNV-1a, seeded with 2166136261u; shared by every on-disk format
+uint32_t checksum_update(uint32_t hash, const void* data, size_t length) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t header_checksum(const QuestionFileHeader* header) {
+    QuestionFileHeader copy = *header;
+    copy.header_checksum = 0;
+    return checksum_update(2166136261u, &copy, sizeof(copy));
+}
+
+static int validate_question_header(const QuestionFileHeader* header, size_t file_size) {
+    if (file_size < sizeof(QuestionFileHeader) ||
+        memcmp(header->magic, QUESTION_FILE_MAGIC, sizeof(header->magic)) != 0) {
+        return 0;
+    }
+    if (header->version != QUESTION_FILE_VERSION ||
+        header->header_size != sizeof(QuestionFileHeader) ||
+        header->record_size != sizeof(Question) ||
+        header->header_checksum != header_checksum(header)) {
+        return 0;
+    }
+
+    uint64_t n = header->question_count;
+    return header->records_offset + n * sizeof(Question) <= header->columns_offset &&
+           header->columns_offset + n * 6 <= header->stats_offset &&
+           header->stats_offset + n * 12 <= header->pool_offset &&
+           header->pool_offset + header->pool_size <= file_size &&
+           header->pool_size <= UINT32_MAX;
+}
+
+static uint32_t metadata_checksum(const QuestionFileHeader* header, const char* file) {
+    uint64_t n = header->question_count;
+    uint32_t hash = checksum_update(2166136261u, file + header->records_offset, n * sizeof(Question));
+    return checksum_update(hash, file + header->columns_offset, n * 6);
+}
+
+// Points the stores at an in-memory image of a question file. The image must
+// stay alive and writable until question_store_reset.
+static int attach_question_image(char* file, const QuestionFileHeader* header) {
+    int n = (int)header->question_count;
+
+    question_store_reset();
+    image_records = (Question*)(file + header->records_offset);
+    image_count = n;
+
+    question_hot.count = n;
+    question_hot.id = (int*)(file + header->columns_offset);
+    question_hot.topic = (unsigned char*)(file + header->columns_offset + (uint64_t)n * 4);
+    question_hot.difficulty = (unsigned char*)(file + header->columns_offset + (uint64_t)n * 5);
+    question_hot.times_asked = (int*)(file + header->stats_offset);
+    question_hot.times_correct = (int*)(file + header->stats_offset + (uint64_t)n * 4);
+    question_hot.avg_time_taken = (float*)(file + header->stats_offset + (uint64_t)n * 8);
+    question_hot_capacity = n;
+    question_hot_owned = 0;
+
+    text_arena.base = file + header->pool_offset;
+    text_arena.base_size = (uint32_t)header->pool_size;
+    question_structure_dirty = 0;
+    rebuild_question_indexes();
+    return n;
+}
+
+static void unmap_question_file(void* file, size_t size);
+
+static void release_question_image(void) {
+    if (mapped_file) {
+        unmap_question_file(mapped_file, mapped_file_size);
+    }
+    free(bank_stats);
+    bank_stats = NULL;
+    mapped_file = NULL;
+    mapped_file_size = 0;
+    image_records = NULL;
+    image_count = 0;
+    attached_path[0] = '\0';
+    text_arena.base = NULL;
+    text_arena.base_size = 0;
+    text_cache_release();
+}
+
+// Points the stores at a bank compiled into the program. Records, identity
+// columns and text are used where they are; nothing writes to them after a
+// question is stored. Only the stats columns, which start at zero and are
+// updated by every answer, are allocated.
+int attach_question_bank(const QuestionBankImage* bank) {
+    int n = bank->count;
+    void* stats = calloc(n > 0 ? (size_t)n : 1, sizeof(int) * 2 + sizeof(float));
+    if (!stats) {
+        return 0;
+    }
+
+    question_store_reset();
+    bank_stats = stats;
+    image_records = (Question*)bank->records;
+    image_count = n;
+
+    question_hot.count = n;
+    question_hot.id = (int*)bank->ids;
+    question_hot.topic = (unsigned char*)bank->topics;
+    question_hot.difficulty = (unsigned char*)bank->difficulties;
+    question_hot.times_asked = stats;
+    question_hot.times_correct = (int*)stats + n;
+    question_hot.avg_time_taken = (float*)((int*)stats + 2 * (size_t)n);
+    question_hot_capacity = n;
+    question_hot_owned = 0;
+
+    text_arena.base = bank->pool;
+    text_arena.base_size = bank->pool_size;
+
+    // Not yet in any file, so the first save writes the whole bank
+    question_structure_dirty = 1;
+    rebuild_question_indexes();
+    return n;
+}
+
+// Reads the whole file into memory where mmap is unavailable
+static void* map_question_file(const char* filename, size_t* size) {
+#ifndef _WIN32
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    void* file = NULL;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        // Private, writable pages: stat updates copy-on-write, never the file
+        file = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (file == MAP_FAILED) {
+            file = NULL;
+        } else {
+            *size = (size_t)st.st_size;
+        }
+    }
+    close(fd);
+    return file;
+#else
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    void* file = NULL;
+    if (fseek(fp, 0, SEEK_END) == 0) {
+        long length = ftell(fp);
+        rewind(fp);
+        if (length > 0 && (file = malloc((size_t)length)) != NULL) {
+            if (fread(file, 1, (size_t)length, fp) != (size_t)length) {
+                free(file);
+                file = NULL;
+            } else {
+                *size = (size_t)length;
+            }
+        }
+    }
+    fclose(fp);
+    return file;
+#endif
+}
+
+#ifndef _WIN32
+// Maps just the records and columns and leaves `fd` open for the text
+// cache. A file with an unusable header is mapped whole, so loading
+// rejects it as usual.
+static void* map_question_metadata(const char* filename, size_t* file_size, size_t* mapped_size, int* fd) {
+    *fd = open(filename, O_RDONLY);
+    if (*fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    QuestionFileHeader header;
+    size_t length = 0;
+    if (fstat(*fd, &st) == 0 && st.st_size > 0) {
+        length = (size_t)st.st_size;
+        *file_size = length;
+        if (pread(*fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+            validate_question_header(&header, length)) {
+            length = (size_t)header.pool_offset;
+        }
+    }
+    void* file = length > 0 ? mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, *fd, 0) : MAP_FAILED;
+    if (file == MAP_FAILED) {
+        close(*fd);
+        *fd = -1;
+        return NULL;
+    }
+    *mapped_size = length;
+    return file;
+}
+#endif
+
+static void unmap_question_file(void* file, size_t size) {
+#ifndef _WIN32
+    munmap(file, size);
+#else
+    (void)size;
+    free(file);
+#endif
+}
+
+// Returns the number of questions loaded, 0 if the file is missing or invalid.
+// With a text cache budget the string pool stays on disk.
+int load_questions_from_file(const char* filename) {
+    TRACE_SCOPE(TRACE_LOAD_QUESTIONS);
+    size_t size = 0;
+    size_t mapped_size = 0;
+    int fd = -1;
+    char* file = NULL;
+#ifndef _WIN32
+    if (text_cache.budget > 0) {
+        file = map_question_metadata(filename, &size, &mapped_size, &fd);
+    } else
+#endif
+    {
+        file = map_question_file(filename, &size);
+        mapped_size = size;
+    }
+    if (!file) {
+        return 0;
+    }
+
+    QuestionFileHeader header;
+    memcpy(&header, file, mapped_size < sizeof(header) ? mapped_size : sizeof(header));
+    if (!validate_question_header(&header, size) ||
+        header.metadata_checksum != metadata_checksum(&header, file)) {
+        printf("⚠️  Ignoring %s: unrecognised format or corrupt metadata\n", filename);
+        unmap_question_file(file, mapped_size);
+#ifndef _WIN32
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+        return 0;
+    }
+
+    int count = attach_question_image(file, &header);
+    if (fd >= 0) {
+        text_arena.base = NULL;
+        text_cache_attach(fd, header.pool_offset);
+    }
+    mapped_file = file;
+    mapped_file_size = mapped_size;
+    snprintf(attached_path, sizeof(attached_path), "%s", filename);
+    attached_stats_offset = header.stats_offset;
+    return count;
+}
+
+static int write_padding(FILE* fp, uint64_t target) {
+    static const char zeros[8] = { 0 };
+    long position = ftell(fp);
+    if (position < 0 || (uint64_t)position > target) {
+        return 0;
+    }
+    return fwrite(zeros, 1, (size_t)(target - (uint64_t)position), fp) == target - (uint64_t)position;
+}
+
+static int write_question_file(FILE* fp, QuestionFileHeader* header) {
+    int n = question_hot.count;
+
+    memset(header, 0, sizeof(QuestionFileHeader));
+    memcpy(header->magic, QUESTION_FILE_MAGIC, sizeof(header->magic));
+    header->version = QUESTION_FILE_VERSION;
+    header->header_size = sizeof(QuestionFileHeader);
+    header->question_count = (uint32_t)n;
+    header->record_size = sizeof(Question);
+    header->records_offset = align8(sizeof(QuestionFileHeader));
+    header->columns_offset = align8(header->records_offset + (uint64_t)n * sizeof(Question));
+    header->stats_offset = align8(header->columns_offset + (uint64_t)n * 6);
+    header->pool_offset = align8(header->stats_offset + (uint64_t)n * 12);
+    header->pool_size = text_arena_size();
+
+    int ok = fwrite(header, sizeof(QuestionFileHeader), 1, fp) == 1 &&
+             write_padding(fp, header->records_offset);
+
+    uint32_t meta = 2166136261u;
+    for (int slot = 0; ok && slot < n; slot++) {
+        Question* q = question_at(slot);
+        meta = checksum_update(meta, q, sizeof(Question));
+        ok = fwrite(q, sizeof(Question), 1, fp) == 1;
+    }
+
+    ok = ok && write_padding(fp, header->columns_offset) &&
+         fwrite(question_hot.id, sizeof(int), n, fp) == (size_t)n &&
+         fwrite(question_hot.topic, 1, n, fp) == (size_t)n &&
+         fwrite(question_hot.difficulty, 1, n, fp) == (size_t)n;
+    meta = checksum_update(meta, question_hot.id, (size_t)n * sizeof(int));
+    meta = checksum_update(meta, question_hot.topic, n);
+    meta = checksum_update(meta, question_hot.difficulty, n);
+
+    ok = ok && write_padding(fp, header->stats_offset) &&
+         fwrite(question_hot.times_asked, sizeof(int), n, fp) == (size_t)n &&
+         fwrite(question_hot.times_correct, sizeof(int), n, fp) == (size_t)n &&
+         fwrite(question_hot.avg_time_taken, sizeof(float), n, fp) == (size_t)n &&
+         write_padding(fp, header->pool_offset);
+
+    uint32_t pool = 2166136261u;
+    if (ok && text_arena.base_size > 0 && !text_arena.base) {
+        ok = text_cache_copy_pool(fp, &pool);
+    } else if (ok && text_arena.base_size > 0) {
+        pool = checksum_update(pool, text_arena.base, text_arena.base_size);
+        ok = fwrite(text_arena.base, 1, text_arena.base_size, fp) == text_arena.base_size;
+    }
+    if (ok && text_arena.size > 0) {
+        pool = checksum_update(pool, text_arena.data, text_arena.size);
+        ok = fwrite(text_arena.data, 1, text_arena.size, fp) == text_arena.size;
+    }
+
+    header->metadata_checksum = meta;
+    header->pool_checksum = pool;
+    header->header_checksum = header_checksum(header);
+    return ok && fseek(fp, 0, SEEK_SET) == 0 &&
+           fwrite(header, sizeof(QuestionFileHeader), 1, fp) == 1;
+}
+
+// Only the stats columns change between loads unless questions were added
+static int write_question_stats(const char* filename) {
+    FILE* fp = fopen(filename, "r+b");
+    if (!fp) {
+        return 0;
+    }
+    int n = question_hot.count;
+    int ok = fseek(fp, (long)attached_stats_offset, SEEK_SET) == 0 &&
+             fwrite(question_hot.times_asked, sizeof(int), n, fp) == (size_t)n &&
+             fwrite(question_hot.times_correct, sizeof(int), n, fp) == (size_t)n &&
+             fwrite(question_hot.avg_time_taken, sizeof(float), n, fp) == (size_t)n;
+    return fclose(fp) == 0 && ok;
+}
+
+int save_questions_to_file(const char* filename) {
+    TRACE_SCOPE(TRACE_SAVE_QUESTIONS);
+    // A backup reading the file gets a fresh copy renamed over it instead
+    if (!question_structure_dirty && strcmp(filename, attached_path) == 0 &&
+        begin_in_place_write(filename)) {
+        int ok = write_question_stats(filename);
+        end_in_place_write();
+        return ok;
+    }
+
+    // Write a sibling file and rename it over the old one, so a crash never
+    // leaves a torn file and any existing mapping keeps its old contents
+    char temp_path[MAX_STRING + 8];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", filename);
+    FILE* fp = fopen(temp_path, "wb");
+    if (!fp) {
+        return 0;
+    }
+
+    QuestionFileHeader header;
+    int ok = write_question_file(fp, &header) && fflush(fp) == 0;
+#ifndef _WIN32
+    ok = ok && fsync(fileno(fp)) == 0;
+#endif
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(temp_path, filename) != 0) {
+        remove(temp_path);
+        return 0;
+    }
+
+    snprintf(attached_path, sizeof(attached_path), "%s", filename);
+    attached_stats_offset = header.stats_offset;
+    question_structure_dirty = 0;
+    return 1;
+}
+
+// Full integrity check, including the string pool that loading leaves unread
+int verify_question_file(const char* filename) {
+    size_t size = 0;
+    char* file = map_question_file(filename, &size);
+    if (!file) {
+        return 0;
+    }
+
+    QuestionFileHeader header;
+    memcpy(&header, file, size < sizeof(header) ? size : sizeof(header));
+    int ok = validate_question_header(&header, size) &&
+             header.metadata_checksum == metadata_checksum(&header, file) &&
+             header.pool_checksum == checksum_update(2166136261u, file + header.pool_offset,
+                                                     header.pool_size);
+    unmap_question_file(file, size);
+    return ok;
+}
+
+// ============================================================================
+// STUDENT REGISTRY
+// ============================================================================
+
+// Sign-in, batch grading, replay and the progress log all register and look
+// up students, some from worker threads. Every registry call takes
+// student_registry_lock, so a lookup never sees the id map or the chunk
+// table mid-growth. Students never move, so pointers stay valid unlocked.
+static ChunkedArray registered_students = { sizeof(Student), STUDENTS_PER_CHUNK, 0, NULL, 0, 0 };
+static IdMap student_ids; // student_id -> registry index
+static pthread_mutex_t student_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static Student* student_at_locked(int index) {
+    if (index < 0 || index >= registered_students.count) {
+        return NULL;
+    }
+    return chunked_array_at(&registered_students, index);
+}
+
+// Copies the profile into the registry; the returned pointer stays valid.
+// Returns NULL if the id is already registered.
+Student* register_student(const Student* profile) {
+    pthread_mutex_lock(&student_registry_lock);
+    Student* student = NULL;
+    if (id_map_get(&student_ids, profile->student_id) < 0) {
+        int index = registered_students.count;
+        student = chunked_array_push(&registered_students);
+        if (student && !id_map_put(&student_ids, profile->student_id, index)) {
+            // Unmappable id or no memory: take the element back
+            registered_students.count--;
+            student = NULL;
+        }
+        if (student) {
+            *student = *profile;
+            // Ranked before any other thread can look the student up
+            update_leaderboard(student, LEADERBOARD_OVERALL);
+        }
+    }
+    pthread_mutex_unlock(&student_registry_lock);
+    return student;
+}
+
+Student* get_student_at(int index) {
+    pthread_mutex_lock(&student_registry_lock);
+    Student* student = student_at_locked(index);
+    pthread_mutex_unlock(&student_registry_lock);
+    return student;
+}
+
+Student* find_student_by_id(int student_id) {
+    pthread_mutex_lock(&student_registry_lock);
+    Student* student = student_at_locked(id_map_get(&student_ids, student_id));
+    pthread_mutex_unlock(&student_registry_lock);
+    return student;
+}
+
+int get_total_students(void) {
+    pthread_mutex_lock(&student_registry_lock);
+    int count = registered_students.count;
+    pthread_mutex_unlock(&student_registry_lock);
+    return count;
+}
+
+// ============================================================================
+// MEMORY FOOTPRINT
+// ============================================================================
+
+static size_t read_resident_bytes(void) {
+    size_t resident = 0;
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm) {
+        unsigned long total_pages, resident_pages;
+        if (fscanf(statm, "%lu %lu", &total_pages, &resident_pages) == 2) {
+            resident = (size_t)resident_pages * 4096;
+        }
+        fclose(statm);
+    }
+    return resident;
+}
+
+void get_memory_footprint(MemoryFootprint* footprint) {
+    size_t hot_row = sizeof(int) * 3 + sizeof(unsigned char) * 2 + sizeof(float);
+
+    footprint->question_record_bytes = chunked_array_bytes(&question_records);
+    footprint->hot_table_bytes = (size_t)question_hot_capacity * hot_row;
+    footprint->text_arena_bytes = text_arena.capacity +
+                                  (size_t)text_arena.slot_count * sizeof(uint32_t) * 2;
+    footprint->student_bytes = chunked_array_bytes(&registered_students);
+    footprint->mapped_file_bytes = mapped_file_size;
+    footprint->text_cache_bytes = text_cache.bytes + (size_t)text_cache.capacity * (sizeof(TextCacheEntry) + sizeof(int));
+    footprint->resident_bytes = read_resident_bytes();
+}
+
+void display_memory_footprint(void) {
+    MemoryFootprint footprint;
+    get_memory_footprint(&footprint);
+
+    size_t bank_bytes = footprint.question_record_bytes + footprint.hot_table_bytes +
+                        footprint.text_arena_bytes + footprint.text_cache_bytes;
+    int questions = question_hot.count;
+
+    printf("\n🧠 Memory Footprint\n");
+    printf("   Question records: %zu KB\n", footprint.question_record_bytes / 1024);
+    printf("   Hot table:        %zu KB\n", footprint.hot_table_bytes / 1024);
+    printf("   Text arena:       %zu KB\n", footprint.text_arena_bytes / 1024);
+    printf("   Students:         %zu KB (%d registered)\n",
+           footprint.student_bytes / 1024, registered_students.count);
+    if (footprint.mapped_file_bytes > 0) {
+        printf("   Mapped file:      %zu KB (paged in on demand)\n", footprint.mapped_file_bytes / 1024);
+    }
+    TextCacheStats cache;
+    get_text_cache_stats(&cache);
+    if (cache.budget > 0) {
+        printf("   Text cache:       %zu of %zu KB, %d strings (%.0f%% hits)\n", footprint.text_cache_bytes / 1024,
+               cache.budget / 1024, cache.entries,
+               calculate_accuracy((int)cache.hits, (int)(cache.hits + cache.misses)) * 100.0f);
+    }
+    if (questions > 0) {
+        printf("   Bank per 1k questions: %zu KB\n", bank_bytes * 1000 / questions / 1024);
+    }
+    if (footprint.resident_bytes > 0) {
+        printf("   Process resident: %zu KB", footprint.resident_bytes / 1024);
+        if (questions > 0) {
+            printf(" (%zu KB per 1k questions)",
+                   footprint.resident_bytes * 1000 / questions / 1024);
+        }
+        printf("\n");
+    }
+}
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <time.h>
 #include <math.h>
 
@@ -14,21 +15,27 @@
 // CONSTANTS AND CONFIGURATION
 // ============================================================================
 
-#define MAX_QUESTIONS 1000
-#define MAX_STUDENTS 100
 #define MAX_STRING 512
+#define MAX_NAME_LENGTH 64
 #define MAX_CODE_LENGTH 2048
 #define MAX_HINTS 3
 #define MAX_KEYWORDS 10
 #define NUM_C_TOPICS 12
 #define MAX_DIFFICULTY 5
 #define MAX_OPTIONS 4
+#define TOPIC_SCORE_RETENTION 0.8f // share of a topic score kept on each answer
+#define WEAK_TOPIC_SCORE 0.5f       // topic mastery below this is a weak topic
+#define STRONG_TOPIC_SCORE 0.75f    // and at or above this a strong one
 
 // File paths
 #define QUESTIONS_FILE "data/questions.dat"
 #define STUDENTS_FILE "data/students.dat"
 #define PROGRESS_FILE "data/progress.dat"
+#define PROGRESS_LOG_FILE "data/progress.log"
 #define ANALYTICS_FILE "data/analytics.dat"
+#define REVIEWS_FILE "data/reviews.dat"
+#define TUTOR_MODEL_FILE "data/tutor.dat"
+#define SANDBOX_CACHE_DIR "data/sandbox"
 
 // ============================================================================
 // ENUMERATIONS
@@ -70,29 +77,142 @@ typedef enum {
 // DATA STRUCTURES
 // ============================================================================
 
-// Question structure
+// Handle to an interned, length-prefixed string in the question text arena.
+// TEXT_REF_EMPTY always resolves to "".
+typedef uint32_t TextRef;
+#define TEXT_REF_EMPTY 0
+
+// Question record: identity plus handles into the text arena. The fields that
+// scans read (topic, difficulty, usage stats) live in the QuestionHotTable row
+// given by `slot`, so walking the bank never touches question prose.
+typedef struct {
+    int id;
+    int slot; // row in the hot table
+    int correct_answer;
+    QuestionType type;
+    TextRef question;
+    TextRef options[MAX_OPTIONS];
+    TextRef explanation;
+    TextRef code_snippet;
+    TextRef hints[MAX_HINTS];
+    TextRef keywords[MAX_KEYWORDS];
+    TextRef author;
+    time_t date_created;
+} Question;
+
+// Hot per-question data as a structure of arrays, indexed by Question.slot
+typedef struct {
+    int count;
+    int* id;
+    unsigned char* topic;
+    unsigned char* difficulty; // 1-5 scale
+    int* times_asked;
+    int* times_correct;
+    float* avg_time_taken;
+} QuestionHotTable;
+
+// A question bank compiled into the program (quiz_default_bank.c): records,
+// the identity columns of the hot table and a text arena pool, all const.
+// Stats start at zero and are kept on the heap.
+typedef struct {
+    const Question* records;
+    const int* ids;
+    const unsigned char* topics;
+    const unsigned char* difficulties;
+    int count;
+    const char* pool;
+    uint32_t pool_size;
+} QuestionBankImage;
+
+extern const QuestionBankImage default_question_bank;
+
+// Growable array whose elements never move once pushed
+typedef struct {
+    size_t element_size;
+    int elements_per_chunk;
+    int count;
+    char** chunks;
+    int chunk_count;
+    int chunk_capacity;
+} ChunkedArray;
+
+// Open-addressing hash map from int ids to int slots
+typedef struct {
+    int* keys;
+    int* values;
+    int capacity;
+    int count;
+} IdMap;
+
+// Order-statistic tree ranking int ids by score, highest first. A
+// zero-initialised tree is empty.
+typedef struct {
+    double* score;
+    int* id;
+    int* left;
+    int* right;
+    int* size; // nodes in the subtree
+    uint32_t* priority;
+    int count;
+    int capacity;
+    int root;  // -1 when empty
+    IdMap nodes; // id -> node
+} RankTree;
+
+// How search_questions combines query terms
+typedef enum {
+    SEARCH_ALL, // every term must match
+    SEARCH_ANY  // any term may match
+} SearchMode;
+
+typedef struct {
+    int question_id;
+    float score;
+} SearchHit;
+
+// Bytes held by each store, plus the process resident set size (0 if unknown)
+typedef struct {
+    size_t question_record_bytes;
+    size_t hot_table_bytes;
+    size_t text_arena_bytes;
+    size_t student_bytes;
+    size_t mapped_file_bytes;
+    size_t text_cache_bytes; // question text read from disk and cached
+    size_t resident_bytes;
+} MemoryFootprint;
+
+// Question text read on demand from the file's string pool (quiz_storage.c)
+typedef struct {
+    size_t budget;   // 0 when the whole file is mapped
+    size_t bytes;    // cached now
+    int entries;
+    long hits;
+    long misses;     // each one a read from the file
+    long evictions;
+} TextCacheStats;
+
+// Authoring form of a question, used to add questions to the bank.
+// NULL strings are stored as "". An id < 0 assigns the next free id.
 typedef struct {
     int id;
-    char question[MAX_STRING];
-    char options[MAX_OPTIONS][MAX_STRING];
+    const char* question;
+    const char* options[MAX_OPTIONS];
     int correct_answer;
-    char explanation[MAX_STRING];
-    char code_snippet[MAX_CODE_LENGTH];
+    const char* explanation;
+    const char* code_snippet;
     int difficulty; // 1-5 scale
     TopicIndex topic;
     QuestionType type;
-    int times_asked;
-    int times_correct;
-    char hints[MAX_HINTS][MAX_STRING];
-    float avg_time_taken;
-    char keywords[MAX_KEYWORDS][50];
+    const char* hints[MAX_HINTS];
+    const char* keywords[MAX_KEYWORDS];
+    const char* author;
     time_t date_created;
-    char author[100];
-} Question;
+} QuestionDraft;
 
-// Student performance data
+// Student performance data. Weak and strong topics are derived from
+// topic_scores on demand (describe_topics) rather than stored.
 typedef struct {
-    char name[MAX_STRING];
+    char name[MAX_NAME_LENGTH];
     int student_id;
     float topic_scores[NUM_C_TOPICS];
     int topic_questions_attempted[NUM_C_TOPICS];
@@ -108,9 +228,7 @@ typedef struct {
     SkillLevel current_level;
     float predicted_exam_score;
     int interview_ready_score; // 0-100
-    char weak_topics[NUM_C_TOPICS][100];
-    char strong_topics[NUM_C_TOPICS][100];
-    int achievements[20]; // Achievement flags
+    uint32_t achievements; // bit (1u << AchievementType) per achievement earned
     float learning_velocity; // Questions per hour
 } Student;
 
@@ -124,6 +242,72 @@ typedef struct {
     char learning_objective[MAX_STRING];
 } AIRecommendation;
 
+// Response-time distribution: log-scale bucket counts (quiz_sketch.c)
+#define RESPONSE_SKETCH_BUCKETS 64
+typedef struct {
+    uint32_t counts[RESPONSE_SKETCH_BUCKETS];
+} ResponseTimeSketch;
+
+typedef struct {
+    unsigned int count;
+    float p50;
+    float p90;
+    float p99;
+} ResponseTimePercentiles;
+
+// Spaced-repetition state for one (student, question) pair (quiz_review.c)
+#define REVIEW_EPOCH ((time_t)1704067200) // 2024-01-01; due times are minutes since
+typedef struct {
+    uint32_t due;      // minutes since REVIEW_EPOCH
+    uint16_t interval; // hours from the last review to due; 0 after a miss
+    uint8_t ease;      // SM-2 ease factor, stored as (ease - 1.3) * 100
+    uint8_t reps;      // correct reviews in a row
+} ReviewState;
+
+// Instrumented hot paths (quiz_trace.c)
+typedef enum {
+    TRACE_RECOMMENDATION,
+    TRACE_RECOMMEND_LOCK_WAIT,
+    TRACE_UPDATE_STATS,
+    TRACE_ENGINE_ANSWER,
+    TRACE_DISPLAY_QUESTION,
+    TRACE_FILTER,
+    TRACE_SEARCH,
+    TRACE_LOAD_QUESTIONS,
+    TRACE_SAVE_QUESTIONS,
+    TRACE_PROGRESS_LOG,
+    TRACE_PROGRESS_CHECKPOINT,
+    TRACE_PROGRESS_RECOVERY,
+    TRACE_COHORT_EXPORT,
+    TRACE_EXAM_SAMPLE,
+    TRACE_TUTOR_BATCH,
+    NUM_TRACE_POINTS
+} TracePoint;
+
+// Merged latency for one trace point; percentiles are approximate
+typedef struct {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    double p50_ns;
+    double p99_ns;
+} TraceStats;
+
+// TRACE_SCOPE(point) times the rest of the enclosing block. Building
+// without QUIZ_TRACE removes every timer.
+#ifdef QUIZ_TRACE
+typedef struct {
+    TracePoint point;
+    uint64_t start_ns;
+} TraceScope;
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(point) \
+    TraceScope TRACE_CONCAT(trace_scope_, __LINE__) __attribute__((cleanup(trace_scope_end))) = { (point), trace_now() }
+#else
+#define TRACE_SCOPE(point) ((void)0)
+#endif
+
 // Session data
 typedef struct {
     time_t start_time;
@@ -135,17 +319,100 @@ typedef struct {
     SkillLevel session_level;
     int hints_used;
     float avg_response_time;
+    ResponseTimeSketch response_times;
 } QuizSession;
 
+// Per-question counters merged across session engine workers
+typedef struct {
+    int times_asked;
+    int times_correct;
+    float avg_time_taken;
+} QuestionStats;
+
+// Counters for the student progress log since it was opened
+typedef struct {
+    uint64_t records_appended;
+    uint64_t records_replayed;
+    uint64_t group_commits;   // one write plus fdatasync each
+    uint64_t bytes_written;
+    uint64_t checkpoints;
+} ProgressLogStats;
+
+// One-pass mean and variance (Welford); partial results merge exactly
+typedef struct {
+    uint64_t count;
+    double mean;
+    double m2; // sum of squared deviations from the mean
+} RunningStats;
+
+// One-pass means, variances and covariance of (x, y) pairs
+typedef struct {
+    uint64_t count;
+    double mean_x;
+    double mean_y;
+    double m2_x;
+    double m2_y;
+    double c_xy; // sum of products of deviations
+} PairedStats;
+
+typedef struct {
+    RunningStats topic_score;        // students who attempted the topic
+    PairedStats accuracy_vs_overall; // x: overall accuracy, y: topic accuracy
+} CohortTopicStats;
+
+typedef struct {
+    RunningStats accuracy;        // questions asked at least once
+    RunningStats time_taken;
+    PairedStats time_vs_accuracy; // x: average time, y: accuracy
+} QuestionBankStats;
+
+// SHA-256 of a byte string: backups name chunks by it and the sandbox
+// keys builds and results by it, where a collision would serve the wrong file
+#define SHA256_DIGEST_SIZE 32
+
+typedef struct {
+    unsigned char bytes[SHA256_DIGEST_SIZE];
+} Sha256Digest;
+
+// Counters for the last completed backup, plus totals across backups
+typedef struct {
+    int backups_completed;
+    int backups_failed;
+    int files_unchanged;
+    int chunks_written;
+    int chunks_reused;
+    uint64_t bytes_scanned;
+    uint64_t bytes_written;
+    uint64_t total_bytes_written;
+    double duration_ms;
+} BackupStats;
+
+// Days with activity as a shift register: bit 0 is last_day, bit k the
+// day k days earlier. Days older than the window fall off the end.
+#define ACTIVITY_DAYS 512
+typedef struct {
+    int last_day; // days since the epoch, -1 if never active
+    uint64_t bits[ACTIVITY_DAYS / 64];
+} ActivityBitmap;
+
+// Answers in one hour or day of a usage time series
+#define ANALYTICS_HOURS 168
+#define ANALYTICS_SERIES_DAYS 365
+typedef struct {
+    time_t start;
+    unsigned int attempts;
+    unsigned int correct;
+} UsageBucket;
+
 // Analytics data
 typedef struct {
     int total_users;
     int total_sessions;
     float avg_accuracy;
-    int most_difficult_questions[10];
+    int most_difficult_questions[10]; // question ids, -1 when unfilled
     int easiest_questions[10];
     TopicIndex most_practiced_topics[NUM_C_TOPICS];
-    char daily_usage[365]; // Bit array for daily usage
+    ActivityBitmap daily_usage; // days with at least one answer
 } SystemAnalytics;
 
 // ============================================================================
@@ -169,15 +436,207 @@ int get_total_questions(void);
 void initialize_student(Student* student);
 int load_student_progress(Student* student);
 int save_student_progress(Student* student);
+Student* register_student(const Student* profile);
+Student* get_student_at(int index);
+Student* find_student_by_id(int student_id);
+int get_total_students(void);
 void update_student_stats(Student* student, Question* question, int is_correct, float time_taken);
+void update_student_stats_at(Student* student, Question* question, int is_correct, float time_taken,
+                             time_t answered_at);
+void apply_answer_to_student(Student* student, TopicIndex topic, int is_correct);
+void record_question_attempt(int slot, int is_correct, float time_taken);
+void reset_student_progress(Student* student);
+
+// Student progress log (quiz_wal.c)
+int open_student_progress(const char* snapshot_path, const char* log_path, const char* reviews_path,
+                          const char* activity_path);
+uint64_t log_student_answer(Student* student, const Question* question, int is_correct, float time_taken);
+int wait_for_student_progress(uint64_t lsn);
+int flush_student_progress(void);
+int checkpoint_student_progress(void);
+int student_progress_checkpoint_due(void);
+void close_student_progress(void);
+void get_progress_log_stats(ProgressLogStats* stats);
+
+// Compact student records, as kept in progress snapshots: a length prefix,
+// varint counters, the name and raw float scores. Typically under 200 bytes.
+#define STUDENT_RECORD_MAX_BYTES 320
+size_t encode_student_record(const Student* student, uint8_t* out);
+size_t decode_student_record(const uint8_t* in, size_t length, Student* student);
 
 // Question management
 int load_questions_from_file(const char* filename);
 int save_questions_to_file(const char* filename);
+int verify_question_file(const char* filename);
 Question* get_question_by_id(int id);
 Question* get_random_question(void);
 Question* get_question_by_topic(TopicIndex topic);
-int add_question(Question* new_question);
+int add_question(const QuestionDraft* draft);
+void create_default_question_bank(void);
+
+// Question storage (quiz_storage.c)
+void chunked_array_init(ChunkedArray* array, size_t element_size, int elements_per_chunk);
+void* chunked_array_push(ChunkedArray* array);
+void* chunked_array_at(const ChunkedArray* array, int index);
+void chunked_array_free(ChunkedArray* array);
+size_t chunked_array_bytes(const ChunkedArray* array);
+TextRef text_intern(const char* str);
+const char* text_get(TextRef ref);
+uint32_t text_length(TextRef ref);
+uint32_t text_copy(TextRef ref, char* buffer, size_t size);
+size_t text_arena_size(void);
+void set_text_cache_budget(size_t bytes);
+void get_text_cache_stats(TextCacheStats* stats);
+void prefetch_question_text(const Question* question);
+uint32_t checksum_update(uint32_t hash, const void* data, size_t length);
+QuestionHotTable* get_question_hot_table(void);
+Question* question_at(int slot);
+int question_store_append(const QuestionDraft* draft);
+void question_store_reset(void);
+int attach_question_bank(const QuestionBankImage* bank);
+unsigned int question_store_generation(void);
+TopicIndex question_topic(const Question* question);
+int question_difficulty(const Question* question);
+void get_memory_footprint(MemoryFootprint* footprint);
+void display_memory_footprint(void);
+
+// Question indexes (quiz_index.c)
+void id_map_init(IdMap* map);
+int id_map_put(IdMap* map, int key, int value);
+int id_map_get(const IdMap* map, int key);
+void id_map_free(IdMap* map);
+int find_question_slot(int id);
+int next_question_id(void);
+void index_new_question(int slot);
+void rebuild_question_indexes(void);
+const int* get_question_bucket(TopicIndex topic, int difficulty, int* count);
+int count_questions_in_topic(TopicIndex topic);
+
+// ============================================================================
+// CONCURRENT SESSION ENGINE
+// ============================================================================
+
+typedef struct SessionEngine SessionEngine;
+
+SessionEngine* session_engine_create(int worker_count);
+int session_engine_open(SessionEngine* engine, Student* student);
+void session_engine_set_adaptive(SessionEngine* engine, int adaptive);
+int session_engine_submit(SessionEngine* engine, int session_id, int question_id, int answer, float time_taken);
+int session_engine_submit_at(SessionEngine* engine, int session_id, int question_id, int answer, float time_taken,
+                             time_t answered_at);
+int session_engine_next_question(SessionEngine* engine, int session_id);
+int session_engine_session_summary(SessionEngine* engine, int session_id, QuizSession* summary);
+void session_engine_question_stats(SessionEngine* engine, int slot, QuestionStats* stats);
+void session_engine_sync(SessionEngine* engine);
+int session_engine_add_question(SessionEngine* engine, const QuestionDraft* draft);
+void session_engine_destroy(SessionEngine* engine);
+
+// ============================================================================
+// BATCH GRADING
+// ============================================================================
+
+// One submitted answer. answer is the 0-based option; answered_at of 0
+// means the time it is graded.
+typedef struct {
+    int student_id;
+    int question_id;
+    int answer;
+    float response_time;
+    time_t answered_at;
+} GradedAnswer;
+
+typedef struct {
+    int worker_count;     // 0 or 1 grades in order on the calling thread
+    int register_unknown; // give unseen student ids a new profile instead of rejecting them
+} BatchGradeOptions;
+
+typedef struct {
+    long applied;
+    long correct;
+    long rejected;          // unknown student or question, or no such option
+    int student_count;
+    int* student_ids;       // in order of first answer
+    QuizSession* sessions;  // one per student, same order
+    double seconds;
+} BatchGradeResult;
+
+int grade_answer_batch(const GradedAnswer* answers, int count, const BatchGradeOptions* options,
+                       BatchGradeResult* result);
+void free_batch_grade_result(BatchGradeResult* result);
+int load_graded_answers(const char* filename, GradedAnswer** answers);
+int read_progress_log_answers(const char* log_path, GradedAnswer** answers);
+int save_batch_grade_report(const char* filename, const BatchGradeResult* result);
+
+// ============================================================================
+// CODE EXECUTION SANDBOX
+// ============================================================================
+
+typedef enum {
+    SANDBOX_OK,            // ran to completion; see exit_code
+    SANDBOX_COMPILE_ERROR,
+    SANDBOX_RUNTIME_ERROR, // killed by a signal
+    SANDBOX_TIMEOUT,       // CPU or wall-clock limit
+    SANDBOX_OUTPUT_LIMIT,
+    SANDBOX_SETUP_ERROR    // could not start the compiler or the program
+} SandboxStatus;
+
+typedef struct {
+    int cpu_seconds;
+    int wall_ms;
+    size_t memory_bytes; // address space
+    size_t output_bytes; // stdout and stderr together
+} SandboxLimits;
+
+typedef struct {
+    SandboxStatus status;
+    int exit_code;
+    int signal;
+    char* output;        // NUL-terminated stdout and stderr
+    size_t output_length;
+    char* diagnostics;   // compiler messages, on SANDBOX_COMPILE_ERROR
+    int compile_cached;  // the binary was already built
+    int output_cached;   // the whole result was already known
+    double run_ms;
+} SandboxResult;
+
+typedef struct {
+    const char* source;
+    const char* input;   // stdin; NULL for none
+    SandboxResult result;
+} SandboxJob;
+
+typedef struct {
+    long compiles;
+    long compile_cache_hits;
+    long runs;
+    long output_cache_hits;
+} SandboxStats;
+
+// Outcome of running one code question's snippet against its options
+typedef enum {
+    CODE_CHECK_VERIFIED,   // the output matches the correct option
+    CODE_CHECK_MISMATCH,   // the output matches a different option
+    CODE_CHECK_UNVERIFIED, // no option matches, or not a complete program
+    CODE_CHECK_FAILED      // the sandbox could not run it
+} CodeCheck;
+
+typedef struct {
+    int question_id;
+    CodeCheck check;
+    SandboxStatus status;
+    int matched_option;    // -1 if none
+    char output[200];      // start of the program's output
+} CodeQuestionCheck;
+
+int sandbox_init(const char* cache_dir, const SandboxLimits* limits);
+int sandbox_run(const char* source, const char* input, SandboxResult* result);
+int sandbox_run_batch(SandboxJob* jobs, int count, int worker_count);
+int sandbox_grade_submission(const char* source, const char* input, const char* expected_output,
+                             SandboxResult* result);
+void sandbox_result_free(SandboxResult* result);
+void get_sandbox_stats(SandboxStats* stats);
+void sandbox_shutdown(void);
+int validate_code_questions(int worker_count, CodeQuestionCheck* checks, int max_checks);
 
 // ============================================================================
 // QUIZ MODES AND FEATURES
@@ -196,9 +655,13 @@ AIRecommendation get_ai_recommendation(Student* student);
 void generate_ai_learning_path(Student* student);
 void provide_intelligent_hint(Question* question, int wrong_answer, int hint_level);
 float predict_performance(Student* student, TopicIndex topic);
+void recommendation_record_answer(Student* student, Question* question, int is_correct, float time_taken);
+void refresh_question_recommendation(int slot);
+void invalidate_recommendations(Student* student);
 
 // Assessment and analytics
 void display_performance_dashboard(Student* student);
+void display_latency_breakdown(void);
 void generate_study_plan(Student* student);
 void check_certification_eligibility(Student* student);
 void export_progress_report(Student* student);
@@ -222,6 +685,7 @@ void wait_for_enter(void);
 float calculate_accuracy(int correct, int total);
 float calculate_topic_mastery(Student* student, TopicIndex topic);
 SkillLevel determine_skill_level(Student* student);
+int describe_topics(const Student* student, int strong, char* buffer, size_t size);
 const char* get_topic_name(TopicIndex topic);
 const char* format_time_duration(int seconds);
 
@@ -229,6 +693,15 @@ const char* format_time_duration(int seconds);
 int file_exists(const char* filename);
 int create_directory(const char* path);
 void backup_data_files(void);
+void backup_if_due(void);
+void cancel_backup(void);
+int wait_for_backup(void);
+void get_backup_stats(BackupStats* stats);
+void display_backup_stats(void);
+int restore_backup(const char* manifest_path, const char* dest_dir);
+Sha256Digest sha256_digest(const void* data, size_t length);
+int begin_in_place_write(const char* path);
+void end_in_place_write(void);
 
 // Display utilities
 void display_question(Question* question);
@@ -237,7 +710,7 @@ void display_topic_progress(Student* student);
 void display_achievements(Student* student);
 
 // Validation functions
-int validate_question(Question* question);
+int validate_question(const QuestionDraft* question);
 int validate_student_data(Student* student);
 
 // ============================================================================
@@ -247,17 +720,40 @@ int validate_student_data(Student* student);
 // AI algorithms
 float calculate_question_difficulty_score(Question* question, Student* student);
 float calculate_topic_priority(Student* student, TopicIndex topic);
+float effective_question_difficulty(const QuestionHotTable* hot, int slot);
+void score_questions_batch(const unsigned char* difficulty, const unsigned char* topic,
+                           const int* times_asked, const int* times_correct, int count,
+                           const float topic_scores[NUM_C_TOPICS], float* out_scores);
+const char* get_scoring_kernel_name(void);
+void embedding_dot_batch(const int8_t* rows, int count, int dim, const int8_t* query, int32_t* out);
 int compare_students(const void* a, const void* b);
 void sort_questions_by_difficulty(Question questions[], int count);
 
-// Statistical functions
+// Statistical functions (quiz_stats.c)
 float calculate_standard_deviation(float values[], int count);
 float calculate_correlation(float x[], float y[], int count);
 void perform_regression_analysis(Student* student);
+int predict_cohort_exam_scores(void);
+void running_stats_init(RunningStats* stats);
+void running_stats_push(RunningStats* stats, double value);
+void running_stats_merge(RunningStats* stats, const RunningStats* other);
+double running_stats_variance(const RunningStats* stats);
+void paired_stats_init(PairedStats* stats);
+void paired_stats_push(PairedStats* stats, double x, double y);
+void paired_stats_merge(PairedStats* stats, const PairedStats* other);
+double paired_stats_correlation(const PairedStats* stats);
+void paired_stats_fit(const PairedStats* stats, double* slope, double* intercept);
+void stats_accumulate(RunningStats* stats, const float* values, int count);
+void stats_accumulate_paired(PairedStats* stats, const float* x, const float* y, int count);
+void stats_accumulate_parallel(RunningStats* stats, const float* values, int count, int threads);
+void stats_accumulate_paired_parallel(PairedStats* stats, const float* x, const float* y, int count, int threads);
+void analyze_cohort_topics(CohortTopicStats stats[NUM_C_TOPICS]);
+void analyze_question_bank(QuestionBankStats* stats, int threads);
 
 // Search algorithms
 Question* binary_search_question(int id);
 Question** search_questions_by_keyword(const char* keyword, int* result_count);
+int search_questions(const char* query, SearchMode mode, SearchHit* hits, int max_hits);
 Question** filter_questions_by_criteria(TopicIndex topic, int difficulty, int* result_count);
 
 // ============================================================================
@@ -277,6 +773,61 @@ void run_company_specific_prep(Student* student, const char* company);
 void generate_coding_challenges(Student* student, int difficulty);
 void simulate_technical_interview(Student* student);
 void provide_interview_tips(TopicIndex weak_topic);
+int get_interview_profiles(const InterviewProfile** profiles);
+const InterviewProfile* find_interview_profile(const char* company);
+int get_profile_topics(const InterviewProfile* profile, TopicIndex* topics);
+
+// ============================================================================
+// EXAM ASSEMBLY
+// ============================================================================
+
+#define EXAM_MAX_QUESTIONS 200
+
+// Questions an exam takes from each topic and difficulty (index
+// difficulty - 1), and the expected answering time it should fit in
+// seconds (0 for no limit)
+typedef struct {
+    int counts[NUM_C_TOPICS][MAX_DIFFICULTY];
+    float time_budget_seconds;
+} ExamBlueprint;
+
+typedef struct ExamPlan ExamPlan;
+
+int exam_blueprint_for_level(ExamBlueprint* blueprint, SkillLevel level, int num_questions,
+                             const TopicIndex* topics, int topic_count);
+ExamPlan* exam_plan_build(const ExamBlueprint* blueprint);
+int exam_plan_size(const ExamPlan* plan);
+int exam_plan_sample(const ExamPlan* plan, uint64_t* state, int* question_ids, float* expected_seconds);
+void exam_plan_free(ExamPlan* plan);
+
+// ============================================================================
+// AI TUTOR
+// ============================================================================
+
+#define TUTOR_EMBEDDING_DIM 128
+#define TUTOR_REPLY_LENGTH 1024
+
+typedef struct TutorSession TutorSession;
+
+typedef struct {
+    int rows;   // questions embedded
+    int mapped; // 1 if the embeddings came from TUTOR_MODEL_FILE
+    long requests;
+    long batches;
+    int largest_batch;
+    long prefix_hits; // replies that reused prepared question text
+    long prefix_misses;
+} TutorStats;
+
+int tutor_start(void);
+void tutor_stop(void);
+TutorSession* tutor_session_open(int student_id);
+void tutor_session_close(TutorSession* session);
+void tutor_session_focus(TutorSession* session, int question_id);
+int tutor_reply(TutorSession* session, const char* message, char* reply, size_t size);
+int tutor_hint(int question_id, int wrong_answer, char* reply, size_t size);
+int tutor_topic_starters(TopicIndex topic, int difficulty, int* question_ids, int max_ids);
+void get_tutor_stats(TutorStats* stats);
 
 // ============================================================================
 // GAMIFICATION FEATURES
@@ -295,10 +846,34 @@ typedef enum {
     ACHIEVEMENT_C_EXPERT
 } AchievementType;
 
-void check_achievements(Student* student, QuizSession* session);
+#define NUM_ACHIEVEMENTS (ACHIEVEMENT_C_EXPERT + 1)
+
+// Leaderboards rank experience points or one topic's score
+#define LEADERBOARD_OVERALL -1
+#define LEADERBOARD_DISPLAY_SIZE 10
+
+typedef struct {
+    int student_id;
+    int rank; // 1-based
+    float score;
+} LeaderboardEntry;
+
+int has_achievement(const Student* student, AchievementType achievement);
+uint32_t check_achievements(Student* student, QuizSession* session);
 void display_achievement_earned(AchievementType achievement);
 void display_leaderboard(void);
+void display_topic_leaderboard(int topic);
 int calculate_experience_points(Student* student);
+void update_leaderboard(Student* student, int topic);
+int get_leaderboard_rank(int student_id, int topic);
+int get_leaderboard_top(int topic, LeaderboardEntry* entries, int max_entries);
+int get_leaderboard_size(int topic);
+void rank_tree_init(RankTree* tree);
+void rank_tree_free(RankTree* tree);
+void rank_tree_set(RankTree* tree, int id, double score);
+int rank_tree_rank(const RankTree* tree, int id);
+int rank_tree_top(const RankTree* tree, int* ids, float* scores, int max);
+int rank_tree_size(const RankTree* tree);
 
 // ============================================================================
 // REPORTING AND ANALYTICS
@@ -315,8 +890,83 @@ typedef struct {
     char recommendations[5][200];
 } ProgressReport;
 
+typedef enum {
+    REPORT_FORMAT_CSV,
+    REPORT_FORMAT_COLUMNAR // row groups of fixed-width columns, see quiz_report.c
+} ReportFormat;
+
+typedef struct {
+    ReportFormat format;
+    int worker_count; // threads formatting rows; 1 formats on the caller
+} CohortExportOptions;
+
+typedef struct {
+    int students;
+    size_t bytes;
+    double seconds;
+} CohortExportStats;
+
+// System analytics (quiz_analytics.c)
+void reset_system_analytics(void);
+void record_activity(Student* student, TopicIndex topic, int is_correct, time_t when);
+int save_student_activity(const char* filename, uint64_t checkpoint_lsn);
+int load_student_activity(const char* filename);
+uint64_t get_activity_checkpoint_lsn(void);
+void refresh_question_analytics(int slot);
+void record_session_started(void);
+void get_system_analytics(SystemAnalytics* analytics);
+int count_active_students(time_t today, int window);
+int get_practice_streak(int student_id, time_t today);
+int get_active_days(int student_id, time_t today, int window);
+int get_usage_series(int hourly, time_t now, UsageBucket* buckets, int count);
+void display_system_analytics(void);
+void activity_mark(ActivityBitmap* bitmap, time_t when);
+int activity_count(const ActivityBitmap* bitmap, time_t today, int window);
+int activity_streak(const ActivityBitmap* bitmap, time_t today);
+
+// Response-time percentiles (quiz_sketch.c)
+void sketch_record(ResponseTimeSketch* sketch, float seconds);
+void sketch_merge(ResponseTimeSketch* sketch, const ResponseTimeSketch* other);
+unsigned int sketch_count(const ResponseTimeSketch* sketch);
+float sketch_quantile(const ResponseTimeSketch* sketch, float q);
+void sketch_percentiles(const ResponseTimeSketch* sketch, ResponseTimePercentiles* percentiles);
+int reserve_response_sketches(int count);
+void record_response_time(int slot, float seconds);
+const ResponseTimeSketch* get_question_response_sketch(int slot);
+void get_topic_response_sketch(TopicIndex topic, ResponseTimeSketch* sketch);
+void reset_response_sketches(void);
+int find_slow_questions(float factor, int min_answers, int* ids, int max_ids);
+void display_response_time_report(void);
+
+// Spaced repetition (quiz_review.c)
+void review_record_answer(int student_id, int slot, int is_correct, float time_taken, time_t when);
+int review_next_due(int student_id, time_t now);
+int review_due_questions(int student_id, time_t now, int* slots, int max);
+int get_review_state(int student_id, int slot, ReviewState* state);
+int get_review_deck_size(int student_id);
+time_t review_due_time(const ReviewState* state);
+void reset_review_decks(void);
+int save_review_decks(const char* filename, uint64_t checkpoint_lsn);
+int load_review_decks(const char* filename);
+uint64_t get_review_checkpoint_lsn(void);
+
+// Latency counters and trace export (quiz_trace.c)
+uint64_t trace_now(void);
+#ifdef QUIZ_TRACE
+void trace_scope_end(TraceScope* scope);
+#endif
+void trace_record(TracePoint point, uint64_t start_ns, uint64_t end_ns);
+const char* get_trace_point_name(TracePoint point);
+void get_trace_stats(TracePoint point, TraceStats* stats);
+void reset_trace_counters(void);
+int trace_start_recording(int events_per_thread);
+void trace_stop_recording(void);
+int export_chrome_trace(const char* filename);
+
+// Progress reports and cohort export (quiz_report.c)
 void generate_detailed_report(Student* student, ProgressReport* report);
-void export_csv_report(Student* student, const char* filename);
+int export_csv_report(Student* student, const char* filename);
+int export_cohort_report(const char* filename, const CohortExportOptions* options, CohortExportStats* stats);
 void send_email_report(Student* student); // Placeholder for email functionality
 
 #endif // QUIZ_SYSTEM_H
@@ -0,0 +1,409 @@
+// quiz_trace.c - Hot-path latency counters for the C Programming Quiz System
+// Scoped timers feed per-thread counters that are merged on demand, and an
+// optional timeline is exported in Chrome trace format for Perfetto
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "quiz_system.h"
+
+#include <pthread.h>
+
+static const char* trace_point_names[NUM_TRACE_POINTS] = {
+    "get_ai_recommendation",
+    "recommend_lock wait",
+    "update_student_stats",
+    "engine answer",
+    "display_question",
+    "filter_questions_by_criteria",
+    "search_questions",
+    "load_questions_from_file",
+    "save_questions_to_file",
+    "progress log append",
+    "progress checkpoint",
+    "progress recovery",
+    "export_cohort_report",
+    "exam_plan_sample",
+    "tutor batch"
+};
+
+uint64_t trace_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+const char* get_trace_point_name(TracePoint point) {
+    if (point < 0 || point >= NUM_TRACE_POINTS) {
+        return "unknown";
+    }
+    return trace_point_names[point];
+}
+
+#ifdef QUIZ_TRACE
+
+// ============================================================================
+// PER-THREAD COUNTERS
+// ============================================================================
+
+// Latencies use the same log-bucket layout as the response-time sketches,
+// in nanoseconds: four buckets per power of two up to about nine minutes
+#define TRACE_LINEAR_BUCKETS 4
+#define TRACE_MAX_EXPONENT 39
+#define TRACE_LATENCY_BUCKETS (4 * TRACE_MAX_EXPONENT)
+
+typedef struct {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t buckets[TRACE_LATENCY_BUCKETS];
+} TraceCounter;
+
+typedef struct {
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    TracePoint point;
+} TraceEvent;
+
+// Only the owning thread writes a record, so updates are plain loads and
+// stores; readers merge with relaxed loads and see each counter whole. A
+// record outlives its thread and is handed to the next new thread, so the
+// list stays as long as the peak number of threads.
+typedef struct TraceThread {
+    int id;
+    int retired;
+    TraceCounter counters[NUM_TRACE_POINTS];
+    TraceEvent* events;          // ring of the newest events while recording
+    uint64_t event_count;        // events written this recording
+    unsigned int event_epoch;    // recording the events belong to
+    struct TraceThread* next;
+} TraceThread;
+
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t trace_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t trace_key;
+static TraceThread* trace_threads = NULL;
+static int trace_thread_count = 0;
+static _Thread_local TraceThread* current_trace_thread = NULL;
+
+static int trace_recording = 0;
+static unsigned int trace_epoch = 0;
+static int trace_event_capacity = 0; // fixed by the first recording
+static uint64_t trace_recording_start = 0;
+
+static void retire_trace_thread(void* record) {
+    pthread_mutex_lock(&trace_lock);
+    ((TraceThread*)record)->retired = 1;
+    pthread_mutex_unlock(&trace_lock);
+}
+
+static void create_trace_key(void) {
+    pthread_key_create(&trace_key, retire_trace_thread);
+}
+
+static TraceThread* trace_thread(void) {
+    if (current_trace_thread) {
+        return current_trace_thread;
+    }
+    pthread_once(&trace_key_once, create_trace_key);
+
+    pthread_mutex_lock(&trace_lock);
+    TraceThread* record = trace_threads;
+    while (record && !record->retired) {
+        record = record->next;
+    }
+    if (record) {
+        record->retired = 0;
+    } else if ((record = calloc(1, sizeof(TraceThread)))) {
+        record->id = ++trace_thread_count;
+        record->next = trace_threads;
+        trace_threads = record;
+    }
+    if (record && !record->events && trace_event_capacity > 0) {
+        record->events = malloc((size_t)trace_event_capacity * sizeof(TraceEvent));
+    }
+    pthread_mutex_unlock(&trace_lock);
+
+    if (record) {
+        pthread_setspecific(trace_key, record);
+        current_trace_thread = record;
+    }
+    return record;
+}
+
+static int latency_bucket(uint64_t ns) {
+    if (ns < TRACE_LINEAR_BUCKETS) {
+        return (int)ns;
+    }
+    int exponent = 63 - __builtin_clzll(ns);
+    if (exponent >= TRACE_MAX_EXPONENT) {
+        return TRACE_LATENCY_BUCKETS - 1;
+    }
+    return 4 * (exponent - 1) + (int)((ns >> (exponent - 2)) & 3);
+}
+
+static double latency_bucket_value(int bucket) {
+    if (bucket < TRACE_LINEAR_BUCKETS) {
+        return bucket + 0.5;
+    }
+    int exponent = bucket / 4 + 1;
+    double width = (double)(1ull << (exponent - 2));
+    return (4 + bucket % 4) * width + width / 2.0;
+}
+
+static void counter_add(uint64_t* value, uint64_t amount) {
+    __atomic_store_n(value, __atomic_load_n(value, __ATOMIC_RELAXED) + amount, __ATOMIC_RELAXED);
+}
+
+void trace_record(TracePoint point, uint64_t start_ns, uint64_t end_ns) {
+    TraceThread* record = trace_thread();
+    if (!record) {
+        return;
+    }
+    uint64_t duration = end_ns > start_ns ? end_ns - start_ns : 0;
+    TraceCounter* counter = &record->counters[point];
+    counter_add(&counter->calls, 1);
+    counter_add(&counter->total_ns, duration);
+    counter_add(&counter->buckets[latency_bucket(duration)], 1);
+    if (duration > counter->max_ns) {
+        __atomic_store_n(&counter->max_ns, duration, __ATOMIC_RELAXED);
+    }
+
+    if (!__atomic_load_n(&trace_recording, __ATOMIC_ACQUIRE) || !record->events) {
+        return;
+    }
+    unsigned int epoch = __atomic_load_n(&trace_epoch, __ATOMIC_RELAXED);
+    if (record->event_epoch != epoch) {
+        record->event_epoch = epoch;
+        __atomic_store_n(&record->event_count, 0, __ATOMIC_RELAXED);
+    }
+    TraceEvent* event = &record->events[record->event_count % trace_event_capacity];
+    event->start_ns = start_ns;
+    event->duration_ns = duration;
+    event->point = point;
+    __atomic_store_n(&record->event_count, record->event_count + 1, __ATOMIC_RELEASE);
+}
+
+void trace_scope_end(TraceScope* scope) {
+    trace_record(scope->point, scope->start_ns, trace_now());
+}
+
+// ============================================================================
+// MERGED VIEW
+// ============================================================================
+
+void get_trace_stats(TracePoint point, TraceStats* stats) {
+    uint64_t buckets[TRACE_LATENCY_BUCKETS] = { 0 };
+    memset(stats, 0, sizeof(TraceStats));
+
+    pthread_mutex_lock(&trace_lock);
+    for (TraceThread* record = trace_threads; record; record = record->next) {
+        TraceCounter* counter = &record->counters[point];
+        stats->calls += __atomic_load_n(&counter->calls, __ATOMIC_RELAXED);
+        stats->total_ns += __atomic_load_n(&counter->total_ns, __ATOMIC_RELAXED);
+        uint64_t max_ns = __atomic_load_n(&counter->max_ns, __ATOMIC_RELAXED);
+        if (max_ns > stats->max_ns) {
+            stats->max_ns = max_ns;
+        }
+        for (int i = 0; i < TRACE_LATENCY_BUCKETS; i++) {
+            buckets[i] += __atomic_load_n(&counter->buckets[i], __ATOMIC_RELAXED);
+        }
+    }
+    pthread_mutex_unlock(&trace_lock);
+
+    // Bucket counts and the call count are read separately, so use the
+    // buckets' own total for ranks
+    uint64_t total = 0;
+    for (int i = 0; i < TRACE_LATENCY_BUCKETS; i++) {
+        total += buckets[i];
+    }
+    double* targets[2] = { &stats->p50_ns, &stats->p99_ns };
+    double quantiles[2] = { 0.50, 0.99 };
+    for (int q = 0; q < 2 && total > 0; q++) {
+        uint64_t rank = (uint64_t)ceil(quantiles[q] * total);
+        uint64_t seen = 0;
+        for (int i = 0; i < TRACE_LATENCY_BUCKETS; i++) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                // A bucket midpoint can overshoot the slowest call
+                *targets[q] = fmin(latency_bucket_value(i), (double)stats->max_ns);
+                break;
+            }
+        }
+    }
+}
+
+// Counts being added while this runs may survive the reset
+void reset_trace_counters(void) {
+    pthread_mutex_lock(&trace_lock);
+    for (TraceThread* record = trace_threads; record; record = record->next) {
+        for (int p = 0; p < NUM_TRACE_POINTS; p++) {
+            TraceCounter* counter = &record->counters[p];
+            __atomic_store_n(&counter->calls, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&counter->total_ns, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&counter->max_ns, 0, __ATOMIC_RELAXED);
+            for (int i = 0; i < TRACE_LATENCY_BUCKETS; i++) {
+                __atomic_store_n(&counter->buckets[i], 0, __ATOMIC_RELAXED);
+            }
+        }
+    }
+    pthread_mutex_unlock(&trace_lock);
+}
+
+// ============================================================================
+// TIMELINE RECORDING
+// ============================================================================
+
+// Each thread keeps its newest events_per_thread spans. Buffers are sized
+// by the first call and reused afterwards, so a thread still finishing a
+// span as recording stops never writes into freed memory.
+int trace_start_recording(int events_per_thread) {
+    pthread_mutex_lock(&trace_lock);
+    if (trace_event_capacity == 0) {
+        if (events_per_thread <= 0) {
+            pthread_mutex_unlock(&trace_lock);
+            return 0;
+        }
+        trace_event_capacity = events_per_thread;
+    }
+    // Threads that appear later get their buffer when they register
+    for (TraceThread* record = trace_threads; record; record = record->next) {
+        if (!record->events) {
+            record->events = malloc((size_t)trace_event_capacity * sizeof(TraceEvent));
+        }
+    }
+    trace_recording_start = trace_now();
+    __atomic_add_fetch(&trace_epoch, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&trace_recording, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&trace_lock);
+    return 1;
+}
+
+void trace_stop_recording(void) {
+    __atomic_store_n(&trace_recording, 0, __ATOMIC_RELEASE);
+}
+
+// Writes the recorded spans as Chrome trace JSON, which chrome://tracing
+// and ui.perfetto.dev open directly. Stop recording first for a consistent
+// snapshot. Returns the number of events written, or -1 on error.
+int export_chrome_trace(const char* filename) {
+    FILE* fp = fopen(filename, "w");
+    if (!fp) {
+        return -1;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    fprintf(fp, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"C Quiz System\"}}");
+
+    int written = 0;
+    unsigned int epoch = __atomic_load_n(&trace_epoch, __ATOMIC_RELAXED);
+    pthread_mutex_lock(&trace_lock);
+    for (TraceThread* record = trace_threads; record; record = record->next) {
+        fprintf(fp, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+                    "\"args\": {\"name\": \"thread %d\"}}", record->id, record->id);
+        if (!record->events || record->event_epoch != epoch) {
+            continue;
+        }
+        uint64_t count = __atomic_load_n(&record->event_count, __ATOMIC_ACQUIRE);
+        uint64_t first = count > (uint64_t)trace_event_capacity ? count - trace_event_capacity : 0;
+        for (uint64_t i = first; i < count; i++) {
+            const TraceEvent* event = &record->events[i % trace_event_capacity];
+            double start_us = event->start_ns >= trace_recording_start
+                                  ? (event->start_ns - trace_recording_start) / 1000.0
+                                  : 0.0;
+            fprintf(fp, ",\n{\"name\": \"%s\", \"cat\": \"quiz\", \"ph\": \"X\", \"ts\": %.3f, "
+                        "\"dur\": %.3f, \"pid\": 1, \"tid\": %d}",
+                    trace_point_names[event->point], start_us, event->duration_ns / 1000.0, record->id);
+            written++;
+        }
+    }
+    pthread_mutex_unlock(&trace_lock);
+
+    fprintf(fp, "\n]}\n");
+    if (fclose(fp) != 0) {
+        return -1;
+    }
+    return written;
+}
+
+#else
+
+// Built without QUIZ_TRACE: nothing is timed and there is nothing to export
+
+void trace_record(TracePoint point, uint64_t start_ns, uint64_t end_ns) {
+    (void)point;
+    (void)start_ns;
+    (void)end_ns;
+}
+
+void get_trace_stats(TracePoint point, TraceStats* stats) {
+    (void)point;
+    memset(stats, 0, sizeof(TraceStats));
+}
+
+void reset_trace_counters(void) {
+}
+
+int trace_start_recording(int events_per_thread) {
+    (void)events_per_thread;
+    return 0;
+}
+
+void trace_stop_recording(void) {
+}
+
+int export_chrome_trace(const char* filename) {
+    (void)filename;
+    return -1;
+}
+
+#endif
+
+// ============================================================================
+// LATENCY BREAKDOWN
+// ============================================================================
+
+#ifdef QUIZ_TRACE
+static const char* format_latency(double ns, char* buffer, size_t size) {
+    if (ns < 1e3) {
+        snprintf(buffer, size, "%.0fns", ns);
+    } else if (ns < 1e6) {
+        snprintf(buffer, size, "%.1fus", ns / 1e3);
+    } else if (ns < 1e9) {
+        snprintf(buffer, size, "%.1fms", ns / 1e6);
+    } else {
+        snprintf(buffer, size, "%.2fs", ns / 1e9);
+    }
+    return buffer;
+}
+#endif
+
+// Spans nest (update_student_stats includes the progress log append), so
+// totals are not meant to add up
+void display_latency_breakdown(void) {
+#ifndef QUIZ_TRACE
+    printf("\n⏱️  Latency counters are not compiled in (build with QUIZ_TRACE)\n");
+#else
+    printf("\n⏱️  Latency Breakdown\n");
+    printf("   %-30s %10s %9s %9s %9s %9s %10s\n", "Operation", "Calls", "Mean", "p50", "p99", "Max", "Total");
+
+    int shown = 0;
+    for (int p = 0; p < NUM_TRACE_POINTS; p++) {
+        TraceStats stats;
+        get_trace_stats((TracePoint)p, &stats);
+        if (stats.calls == 0) {
+            continue;
+        }
+        char mean[16], p50[16], p99[16], max[16], total[16];
+        printf("   %-30s %10llu %9s %9s %9s %9s %10s\n", trace_point_names[p], (unsigned long long)stats.calls,
+               format_latency((double)stats.total_ns / stats.calls, mean, sizeof(mean)),
+               format_latency(stats.p50_ns, p50, sizeof(p50)),
+               format_latency(stats.p99_ns, p99, sizeof(p99)),
+               format_latency((double)stats.max_ns, max, sizeof(max)),
+               format_latency((double)stats.total_ns, total, sizeof(total)));
+        shown++;
+    }
+    if (shown == 0) {
+        printf("   No instrumented calls yet\n");
+    }
+#endif
+}
@@ -0,0 +1,948 @@
+// quiz_tutor.c - Local AI tutor for the C Programming Quiz System
+// Answers students from the question bank itself. Every question is embedded
+// once into a small quantized vector of hashed word features (no trained
+// weights, no network), saved to data/tutor.dat and mapped on later runs.
+// Requests from all sessions queue to one inference thread, which scores a
+// whole batch in a single pass over the vectors.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "quiz_system.h"
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdarg.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define TUTOR_MODEL_MAGIC "CQTUTOR1"
+#define TUTOR_MODEL_VERSION 2
+#define TUTOR_MAX_BATCH 32
+#define TUTOR_TOP_K 4
+#define TUTOR_BLOCK_ROWS 128       // rows scored against every query while cached
+#define TUTOR_PREFIX_SLOTS 512     // prepared question text, direct-mapped by id
+#define TUTOR_SNIPPET 320
+#define TUTOR_WORD_LENGTH 32
+#define TUTOR_MIN_SIMILARITY 0.2f  // below this a match is hashing noise
+#define TUTOR_CONTEXT_DECAY 0.35f  // weight earlier turns keep in a session
+#define TUTOR_PATH_TOPICS 4
+
+// ============================================================================
+// EMBEDDINGS
+// ============================================================================
+
+static const char* stop_words[] = {
+    "a", "an", "and", "are", "as", "be", "by", "can", "do", "does", "for", "how", "i", "in", "is", "it",
+    "me", "my", "of", "on", "or", "the", "this", "that", "to", "what", "when", "which", "why", "with", "you"
+};
+
+static int is_stop_word(const char* word) {
+    for (size_t i = 0; i < sizeof(stop_words) / sizeof(stop_words[0]); i++) {
+        if (strcmp(word, stop_words[i]) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Lowercased identifier-like words; a trailing plural 's' is dropped so
+// "pointers" and "pointer" share a feature
+static const char* next_word(const char* text, char word[TUTOR_WORD_LENGTH]) {
+    while (*text && !isalnum((unsigned char)*text) && *text != '_') {
+        text++;
+    }
+    int length = 0;
+    while (*text && (isalnum((unsigned char)*text) || *text == '_')) {
+        if (length < TUTOR_WORD_LENGTH - 1) {
+            word[length++] = (char)tolower((unsigned char)*text);
+        }
+        text++;
+    }
+    if (length > 3 && word[length - 1] == 's' && word[length - 2] != 's') {
+        length--;
+    }
+    word[length] = '\0';
+    return length > 0 ? text : NULL;
+}
+
+static uint32_t mix_hash(uint32_t hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    return hash ^ (hash >> 16);
+}
+
+// Signed feature hashing: each feature lands on one dimension with a sign
+// chosen by the hash, so unrelated features cancel out on average
+static void add_feature(float* vector, uint32_t hash, float weight) {
+    hash = mix_hash(hash);
+    vector[hash % TUTOR_EMBEDDING_DIM] += hash & 0x80000000u ? -weight : weight;
+}
+
+// Words and adjacent word pairs, so "null pointer" is closer to itself than
+// to "pointer" next to "null" somewhere else
+static void embed_text(float* vector, const char* text, float weight) {
+    char word[TUTOR_WORD_LENGTH];
+    uint32_t previous = 0;
+    while ((text = next_word(text, word)) != NULL) {
+        if (word[1] == '\0' || is_stop_word(word)) {
+            previous = 0;
+            continue;
+        }
+        uint32_t hash = checksum_update(2166136261u, word, strlen(word));
+        add_feature(vector, hash, weight);
+        if (previous) {
+            add_feature(vector, previous * 16777619u ^ hash, weight * 0.5f);
+        }
+        previous = hash;
+    }
+}
+
+// Normalises and rounds to int8 with one scale per vector, so
+// cosine(a, b) ~= dot(a, b) * scale_a * scale_b. Returns 0 for a zero vector.
+static float quantize(const float* vector, int8_t* out) {
+    float norm = 0.0f;
+    float peak = 0.0f;
+    for (int d = 0; d < TUTOR_EMBEDDING_DIM; d++) {
+        norm += vector[d] * vector[d];
+        peak = fabsf(vector[d]) > peak ? fabsf(vector[d]) : peak;
+    }
+    if (peak == 0.0f) {
+        memset(out, 0, TUTOR_EMBEDDING_DIM);
+        return 0.0f;
+    }
+    norm = sqrtf(norm);
+    for (int d = 0; d < TUTOR_EMBEDDING_DIM; d++) {
+        out[d] = (int8_t)lrintf(vector[d] / peak * 127.0f);
+    }
+    return peak / norm / 127.0f;
+}
+
+// ============================================================================
+// MODEL
+// ============================================================================
+
+// Layout of data/tutor.dat (native byte order):
+//   header | scales[rows] | vectors[rows][TUTOR_EMBEDDING_DIM] at vectors_offset
+// Row r embeds the question in slot r. bank_checksum covers the ids,
+// topics and difficulties and the text embedded, so a changed bank or an
+// edited question is re-embedded.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t dim;
+    uint32_t rows;
+    uint32_t bank_checksum;
+    uint64_t vectors_offset;
+} TutorModelHeader;
+
+typedef struct {
+    int rows;
+    unsigned int generation;
+    uint32_t bank_checksum;
+    int* ids; // copies of the hot columns, so the inference thread never
+    unsigned char* topics; // reads a column that the main thread may grow
+    unsigned char* difficulties;
+    IdMap rows_by_id;
+    const float* scales;
+    const int8_t* vectors;
+    void* mapping; // data/tutor.dat when it was current
+    size_t mapping_size;
+    void* built;   // scales and vectors embedded this run
+    float centroids[NUM_C_TOPICS][TUTOR_EMBEDDING_DIM];
+    int mapped;
+} TutorModel;
+
+static TutorModel model;
+
+static uint64_t vectors_offset(int rows) {
+    return (sizeof(TutorModelHeader) + (uint64_t)rows * sizeof(float) + 63) & ~(uint64_t)63;
+}
+
+static void embed_question(int slot, float* vector) {
+    Question* question = question_at(slot);
+    memset(vector, 0, TUTOR_EMBEDDING_DIM * sizeof(float));
+    embed_text(vector, text_get(question->question), 1.0f);
+    for (int k = 0; k < MAX_KEYWORDS; k++) {
+        embed_text(vector, text_get(question->keywords[k]), 1.5f);
+    }
+    embed_text(vector, text_get(question->explanation), 0.8f);
+    embed_text(vector, text_get(question->code_snippet), 0.4f);
+    embed_text(vector, get_topic_name(question_topic(question)), 0.5f);
+}
+
+// Folds in exactly the text embed_question reads
+static uint32_t checksum_question_text(uint32_t checksum, int slot) {
+    Question* question = question_at(slot);
+    const char* text = text_get(question->question);
+    checksum = checksum_update(checksum, text, strlen(text) + 1);
+    for (int k = 0; k < MAX_KEYWORDS; k++) {
+        text = text_get(question->keywords[k]);
+        checksum = checksum_update(checksum, text, strlen(text) + 1);
+    }
+    text = text_get(question->explanation);
+    checksum = checksum_update(checksum, text, strlen(text) + 1);
+    text = text_get(question->code_snippet);
+    return checksum_update(checksum, text, strlen(text) + 1);
+}
+
+static int build_model(void) {
+    size_t offset = vectors_offset(model.rows) - sizeof(TutorModelHeader);
+    char* block = malloc(offset + (size_t)model.rows * TUTOR_EMBEDDING_DIM);
+    if (!block) {
+        return 0;
+    }
+    float* scales = (float*)block;
+    int8_t* vectors = (int8_t*)(block + offset);
+    float vector[TUTOR_EMBEDDING_DIM];
+    for (int r = 0; r < model.rows; r++) {
+        embed_question(r, vector);
+        scales[r] = quantize(vector, vectors + (size_t)r * TUTOR_EMBEDDING_DIM);
+    }
+    model.built = block;
+    model.scales = scales;
+    model.vectors = vectors;
+    return 1;
+}
+
+static int map_model(const char* filename) {
+#ifndef _WIN32
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    TutorModelHeader header;
+    struct stat st;
+    size_t size = vectors_offset(model.rows) + (size_t)model.rows * TUTOR_EMBEDDING_DIM;
+    void* file = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size == size &&
+        pread(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+        memcmp(header.magic, TUTOR_MODEL_MAGIC, sizeof(header.magic)) == 0 &&
+        header.version == TUTOR_MODEL_VERSION && header.dim == TUTOR_EMBEDDING_DIM &&
+        header.rows == (uint32_t)model.rows && header.bank_checksum == model.bank_checksum &&
+        header.vectors_offset == vectors_offset(model.rows)) {
+        file = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (file == MAP_FAILED) {
+        return 0;
+    }
+    model.mapping = file;
+    model.mapping_size = size;
+    model.scales = (const float*)((char*)file + sizeof(TutorModelHeader));
+    model.vectors = (const int8_t*)((char*)file + header.vectors_offset);
+    model.mapped = 1;
+    return 1;
+#else
+    (void)filename;
+    return 0;
+#endif
+}
+
+// Written beside the target and renamed over it, like the question file
+static int save_model(const char* filename) {
+    char temp_path[MAX_STRING + 8];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", filename);
+    FILE* fp = fopen(temp_path, "wb");
+    if (!fp) {
+        return 0;
+    }
+    TutorModelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TUTOR_MODEL_MAGIC, sizeof(header.magic));
+    header.version = TUTOR_MODEL_VERSION;
+    header.dim = TUTOR_EMBEDDING_DIM;
+    header.rows = (uint32_t)model.rows;
+    header.bank_checksum = model.bank_checksum;
+    header.vectors_offset = vectors_offset(model.rows);
+
+    static const char zeros[64] = { 0 };
+    size_t padding = header.vectors_offset - sizeof(header) - (size_t)model.rows * sizeof(float);
+    size_t vector_bytes = (size_t)model.rows * TUTOR_EMBEDDING_DIM;
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+             fwrite(model.scales, sizeof(float), model.rows, fp) == (size_t)model.rows &&
+             fwrite(zeros, 1, padding, fp) == padding &&
+             fwrite(model.vectors, 1, vector_bytes, fp) == vector_bytes;
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(temp_path, filename) != 0) {
+        remove(temp_path);
+        return 0;
+    }
+    return 1;
+}
+
+static void compute_centroids(void) {
+    memset(model.centroids, 0, sizeof(model.centroids));
+    for (int r = 0; r < model.rows; r++) {
+        const int8_t* row = model.vectors + (size_t)r * TUTOR_EMBEDDING_DIM;
+        float* centroid = model.centroids[model.topics[r]];
+        for (int d = 0; d < TUTOR_EMBEDDING_DIM; d++) {
+            centroid[d] += row[d] * model.scales[r];
+        }
+    }
+}
+
+static void free_model(void) {
+#ifndef _WIN32
+    if (model.mapping) {
+        munmap(model.mapping, model.mapping_size);
+    }
+#endif
+    free(model.built);
+    free(model.ids);
+    free(model.topics);
+    free(model.difficulties);
+    id_map_free(&model.rows_by_id);
+    memset(&model, 0, sizeof(model));
+}
+
+// Copies the identity columns and maps the saved vectors, embedding the
+// bank again only when it has changed
+static int load_model(void) {
+    QuestionHotTable* hot = get_question_hot_table();
+    int rows = hot->count;
+    model.rows = rows;
+    model.generation = question_store_generation();
+    model.ids = malloc(rows * sizeof(int));
+    model.topics = malloc(rows);
+    model.difficulties = malloc(rows);
+    id_map_init(&model.rows_by_id);
+    if (!model.ids || !model.topics || !model.difficulties) {
+        return 0;
+    }
+    memcpy(model.ids, hot->id, rows * sizeof(int));
+    memcpy(model.topics, hot->topic, rows);
+    memcpy(model.difficulties, hot->difficulty, rows);
+    for (int r = 0; r < rows; r++) {
+        if (!id_map_put(&model.rows_by_id, model.ids[r], r)) {
+            return 0;
+        }
+    }
+    uint32_t checksum = checksum_update(2166136261u, model.ids, rows * sizeof(int));
+    checksum = checksum_update(checksum, model.topics, rows);
+    checksum = checksum_update(checksum, model.difficulties, rows);
+    for (int r = 0; r < rows; r++) {
+        checksum = checksum_question_text(checksum, r);
+    }
+    model.bank_checksum = checksum;
+
+    if (!map_model(TUTOR_MODEL_FILE)) {
+        if (!build_model()) {
+            return 0;
+        }
+        save_model(TUTOR_MODEL_FILE);
+    }
+    compute_centroids();
+    return 1;
+}
+
+// ============================================================================
+// PREFIX CACHE
+// ============================================================================
+
+// The text a reply quotes from a question, copied out once per question id
+// and reused by every session that lands on it. Only the inference thread
+// touches the cache.
+typedef struct {
+    int id; // -1 when empty
+    char stem[TUTOR_SNIPPET];
+    char answer[TUTOR_SNIPPET];
+    char explanation[TUTOR_SNIPPET * 2];
+    char hints[MAX_HINTS][TUTOR_SNIPPET];
+} TutorPrefix;
+
+static TutorPrefix* prefix_cache = NULL;
+static long batch_prefix_hits = 0;
+static long batch_prefix_misses = 0;
+
+static const TutorPrefix* prefix_for(int row) {
+    int id = model.ids[row];
+    TutorPrefix* prefix = &prefix_cache[(unsigned int)id % TUTOR_PREFIX_SLOTS];
+    if (prefix->id == id) {
+        batch_prefix_hits++;
+        return prefix;
+    }
+    batch_prefix_misses++;
+
+    Question* question = question_at(row);
+    prefix->id = id;
+    text_copy(question->question, prefix->stem, sizeof(prefix->stem));
+    text_copy(question->options[question->correct_answer], prefix->answer, sizeof(prefix->answer));
+    text_copy(question->explanation, prefix->explanation, sizeof(prefix->explanation));
+    for (int h = 0; h < MAX_HINTS; h++) {
+        text_copy(question->hints[h], prefix->hints[h], sizeof(prefix->hints[h]));
+    }
+    return prefix;
+}
+
+// ============================================================================
+// SESSIONS AND REQUESTS
+// ============================================================================
+
+// Conversation state kept between turns, so each new message is embedded
+// on its own and folded into what came before
+struct TutorSession {
+    int student_id;
+    int focus_id;   // question under discussion, -1 for none
+    int hint_level; // hints given for it
+    int turns;
+    float context[TUTOR_EMBEDDING_DIM];
+};
+
+typedef enum {
+    TUTOR_REQUEST_CHAT,
+    TUTOR_REQUEST_HINT,
+    TUTOR_REQUEST_STARTERS
+} TutorRequestKind;
+
+typedef enum {
+    INTENT_ASK,
+    INTENT_HINT,
+    INTENT_EXPLAIN,
+    INTENT_ANOTHER
+} TutorIntent;
+
+typedef struct TutorRequest {
+    TutorRequestKind kind;
+    TutorSession* session;
+    const char* message;
+    int question_id;
+    int wrong_answer;
+    TopicIndex topic;
+    int difficulty;
+    char* reply;
+    size_t reply_size;
+    int* question_ids;
+    int max_ids;
+    int result;
+    int done;
+    struct TutorRequest* next;
+} TutorRequest;
+
+typedef struct {
+    int row;
+    float score;
+} TutorHit;
+
+// One nearest-neighbour search within a batch
+typedef struct {
+    int8_t vector[TUTOR_EMBEDDING_DIM];
+    float scale;
+    int k; // 0 to skip
+    int exclude_row;
+    int topic;      // -1 for any
+    int difficulty; // 0 for any
+    TutorHit hits[TUTOR_TOP_K];
+    int hit_count;
+    int8_t message_vector[TUTOR_EMBEDDING_DIM]; // the latest message alone,
+    float message_scale;                        // 0 when not needed
+    float message_best; // its best match, so context alone cannot carry a reply
+} TutorQuery;
+
+static pthread_mutex_t tutor_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tutor_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t tutor_done = PTHREAD_COND_INITIALIZER;
+static pthread_t tutor_thread;
+static TutorRequest* queue_head = NULL;
+static TutorRequest* queue_tail = NULL;
+static int tutor_running = 0;
+static int tutor_stopping = 0;
+static TutorStats tutor_stats;
+
+TutorSession* tutor_session_open(int student_id) {
+    TutorSession* session = calloc(1, sizeof(TutorSession));
+    if (session) {
+        session->student_id = student_id;
+        session->focus_id = -1;
+    }
+    return session;
+}
+
+void tutor_session_close(TutorSession* session) {
+    free(session);
+}
+
+// Points follow-up questions ("hint", "why") at a question
+void tutor_session_focus(TutorSession* session, int question_id) {
+    if (session->focus_id != question_id) {
+        session->focus_id = question_id;
+        session->hint_level = 0;
+    }
+}
+
+// ============================================================================
+// INFERENCE
+// ============================================================================
+
+static void offer_hit(TutorQuery* query, int row, float score) {
+    if (query->hit_count == query->k && score <= query->hits[query->k - 1].score) {
+        return;
+    }
+    int i = query->hit_count < query->k ? query->hit_count++ : query->k - 1;
+    while (i > 0 && query->hits[i - 1].score < score) {
+        query->hits[i] = query->hits[i - 1];
+        i--;
+    }
+    query->hits[i].row = row;
+    query->hits[i].score = score;
+}
+
+// Every block of rows is scored against the whole batch while it is in
+// cache, so the vectors stream from memory once per batch, not per request
+static void score_queries(TutorQuery* queries, int count) {
+    int32_t dots[TUTOR_BLOCK_ROWS];
+    for (int start = 0; start < model.rows; start += TUTOR_BLOCK_ROWS) {
+        int rows = model.rows - start < TUTOR_BLOCK_ROWS ? model.rows - start : TUTOR_BLOCK_ROWS;
+        const int8_t* block = model.vectors + (size_t)start * TUTOR_EMBEDDING_DIM;
+        for (int q = 0; q < count; q++) {
+            TutorQuery* query = &queries[q];
+            if (query->k == 0) {
+                continue;
+            }
+            if (query->message_scale > 0.0f) {
+                embedding_dot_batch(block, rows, TUTOR_EMBEDDING_DIM, query->message_vector, dots);
+                for (int i = 0; i < rows; i++) {
+                    float score = (float)dots[i] * query->message_scale * model.scales[start + i];
+                    query->message_best = score > query->message_best ? score : query->message_best;
+                }
+            }
+            embedding_dot_batch(block, rows, TUTOR_EMBEDDING_DIM, query->vector, dots);
+            for (int i = 0; i < rows; i++) {
+                int row = start + i;
+                if (row == query->exclude_row || (query->topic >= 0 && model.topics[row] != query->topic) ||
+                    (query->difficulty > 0 && model.difficulties[row] != query->difficulty)) {
+                    continue;
+                }
+                offer_hit(query, row, (float)dots[i] * query->scale * model.scales[row]);
+            }
+        }
+    }
+}
+
+static void query_from_row(TutorQuery* query, int row) {
+    memcpy(query->vector, model.vectors + (size_t)row * TUTOR_EMBEDDING_DIM, TUTOR_EMBEDDING_DIM);
+    query->scale = model.scales[row];
+}
+
+static int row_for_id(int question_id) {
+    return question_id >= 0 ? id_map_get(&model.rows_by_id, question_id) : -1;
+}
+
+static TutorIntent detect_intent(const char* message) {
+    char word[TUTOR_WORD_LENGTH];
+    while ((message = next_word(message, word)) != NULL) {
+        if (strcmp(word, "hint") == 0 || strcmp(word, "stuck") == 0 || strcmp(word, "clue") == 0) {
+            return INTENT_HINT;
+        }
+        if (strcmp(word, "why") == 0 || strcmp(word, "explain") == 0 || strcmp(word, "answer") == 0 ||
+            strcmp(word, "solution") == 0) {
+            return INTENT_EXPLAIN;
+        }
+        if (strcmp(word, "another") == 0 || strcmp(word, "similar") == 0 || strcmp(word, "next") == 0 ||
+            strcmp(word, "more") == 0) {
+            return INTENT_ANOTHER;
+        }
+    }
+    return INTENT_ASK;
+}
+
+static void append_reply(TutorRequest* request, size_t* used, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+static void append_reply(TutorRequest* request, size_t* used, const char* format, ...) {
+    if (*used >= request->reply_size) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(request->reply + *used, request->reply_size - *used, format, args);
+    va_end(args);
+    if (written > 0) {
+        *used += (size_t)written;
+    }
+}
+
+// Sets up the search a request needs, if any. Questions are folded into the
+// session context first; "hint", "why" and "another" are about the question
+// in focus and leave the context alone.
+static void prepare_query(TutorRequest* request, TutorQuery* query) {
+    memset(query, 0, sizeof(TutorQuery));
+    query->exclude_row = -1;
+    query->topic = -1;
+
+    if (request->kind == TUTOR_REQUEST_HINT) {
+        int row = row_for_id(request->question_id);
+        if (row >= 0) {
+            query_from_row(query, row);
+            query->k = 1;
+            query->exclude_row = row;
+            query->topic = model.topics[row];
+        }
+        return;
+    }
+    if (request->kind == TUTOR_REQUEST_STARTERS) {
+        query->scale = quantize(model.centroids[request->topic], query->vector);
+        query->k = request->max_ids < TUTOR_TOP_K ? request->max_ids : TUTOR_TOP_K;
+        query->topic = request->topic;
+        query->difficulty = request->difficulty;
+        return;
+    }
+
+    TutorSession* session = request->session;
+    int focus = row_for_id(session->focus_id);
+    TutorIntent intent = detect_intent(request->message);
+    session->turns++;
+    if (focus >= 0 && intent == INTENT_EXPLAIN) {
+        return;
+    }
+    if (focus >= 0 && intent == INTENT_HINT) {
+        if (session->hint_level < MAX_HINTS && prefix_for(focus)->hints[session->hint_level][0] != '\0') {
+            return; // the question's own hint
+        }
+        query_from_row(query, focus);
+        query->k = 1;
+        query->exclude_row = focus;
+        query->topic = model.topics[focus];
+        return;
+    }
+    if (focus >= 0 && intent == INTENT_ANOTHER) {
+        query_from_row(query, focus);
+        query->k = TUTOR_TOP_K;
+        query->exclude_row = focus;
+        return;
+    }
+
+    float message[TUTOR_EMBEDDING_DIM] = { 0 };
+    embed_text(message, request->message, 1.0f);
+    float norm = 0.0f;
+    for (int d = 0; d < TUTOR_EMBEDDING_DIM; d++) {
+        norm += message[d] * message[d];
+    }
+    if (norm == 0.0f) {
+        return; // nothing in the message to match on
+    }
+    query->message_scale = quantize(message, query->message_vector);
+    norm = sqrtf(norm);
+    for (int d = 0; d < TUTOR_EMBEDDING_DIM; d++) {
+        session->context[d] = session->context[d] * TUTOR_CONTEXT_DECAY + message[d] / norm;
+    }
+    query->scale = quantize(session->context, query->vector);
+    query->k = TUTOR_TOP_K;
+}
+
+// Explanations in the bank do not always end in a full stop
+static void append_sentence(TutorRequest* request, size_t* used, const char* text) {
+    size_t length = strlen(text);
+    if (length == 0) {
+        return;
+    }
+    append_reply(request, used, strchr(".!?", text[length - 1]) ? "%s " : "%s. ", text);
+}
+
+static void reply_hint(TutorRequest* request, const TutorQuery* query) {
+    size_t used = 0;
+    int row = row_for_id(request->question_id);
+    if (row >= 0 && request->wrong_answer >= 0 && request->wrong_answer < MAX_OPTIONS &&
+        request->wrong_answer != question_at(row)->correct_answer) {
+        append_reply(request, &used, "Option %d is not it. ", request->wrong_answer + 1);
+    }
+    if (query->hit_count > 0 && query->hits[0].score >= TUTOR_MIN_SIMILARITY) {
+        const TutorPrefix* related = prefix_for(query->hits[0].row);
+        append_reply(request, &used, "A related idea: %s",
+                     related->explanation[0] ? related->explanation : related->stem);
+    } else if (row >= 0) {
+        append_reply(request, &used, "Think about what %s covers.", get_topic_name(model.topics[row]));
+    }
+    request->result = (int)used;
+}
+
+static void reply_chat(TutorRequest* request, const TutorQuery* query) {
+    TutorSession* session = request->session;
+    size_t used = 0;
+    int focus = row_for_id(session->focus_id);
+    TutorIntent intent = detect_intent(request->message);
+
+    if (focus >= 0 && intent == INTENT_EXPLAIN) {
+        const TutorPrefix* prefix = prefix_for(focus);
+        append_reply(request, &used, "The answer to #%d is \"%s\". %s", model.ids[focus], prefix->answer,
+                     prefix->explanation);
+    } else if (focus >= 0 && intent == INTENT_HINT) {
+        const TutorPrefix* prefix = prefix_for(focus);
+        if (session->hint_level < MAX_HINTS && prefix->hints[session->hint_level][0] != '\0') {
+            append_reply(request, &used, "Hint %d for #%d: %s", session->hint_level + 1, model.ids[focus],
+                         prefix->hints[session->hint_level]);
+            session->hint_level++;
+        } else if (query->hit_count > 0 && query->hits[0].score >= TUTOR_MIN_SIMILARITY) {
+            const TutorPrefix* related = prefix_for(query->hits[0].row);
+            append_reply(request, &used, "No more hints for #%d, but this may help: %s", model.ids[focus],
+                         related->explanation[0] ? related->explanation : related->stem);
+        } else {
+            append_reply(request, &used, "No more hints for #%d. Think about what %s covers.", model.ids[focus],
+                         get_topic_name(model.topics[focus]));
+        }
+    } else if (query->hit_count == 0 || query->hits[0].score < TUTOR_MIN_SIMILARITY ||
+               (query->message_scale > 0.0f && query->message_best < TUTOR_MIN_SIMILARITY)) {
+        append_reply(request, &used,
+                     "I couldn't match that to anything in the question bank. Try naming a concept, "
+                     "like pointer arithmetic or malloc.");
+    } else {
+        int best = query->hits[0].row;
+        const TutorPrefix* prefix = prefix_for(best);
+        append_reply(request, &used, "That's part of %s. ", get_topic_name(model.topics[best]));
+        append_sentence(request, &used, prefix->explanation);
+        append_reply(request, &used, "Try question #%d: %s", model.ids[best], prefix->stem);
+        int related = 0;
+        for (int h = 1; h < query->hit_count; h++) {
+            if (query->hits[h].score >= TUTOR_MIN_SIMILARITY) {
+                append_reply(request, &used, "%s#%d", related++ ? ", " : " Related: ", model.ids[query->hits[h].row]);
+            }
+        }
+        tutor_session_focus(session, model.ids[best]);
+    }
+    request->result = (int)used;
+}
+
+static void serve_batch(TutorRequest** batch, int count) {
+    TRACE_SCOPE(TRACE_TUTOR_BATCH);
+    TutorQuery queries[TUTOR_MAX_BATCH];
+    for (int i = 0; i < count; i++) {
+        prepare_query(batch[i], &queries[i]);
+    }
+    score_queries(queries, count);
+    for (int i = 0; i < count; i++) {
+        TutorRequest* request = batch[i];
+        if (request->kind == TUTOR_REQUEST_CHAT) {
+            reply_chat(request, &queries[i]);
+        } else if (request->kind == TUTOR_REQUEST_HINT) {
+            reply_hint(request, &queries[i]);
+        } else {
+            for (int h = 0; h < queries[i].hit_count; h++) {
+                request->question_ids[h] = model.ids[queries[i].hits[h].row];
+            }
+            request->result = queries[i].hit_count;
+        }
+    }
+}
+
+// Takes whatever has queued up, up to a full batch, so a quiet system
+// answers at once and a busy one amortises each pass over more requests
+static void* tutor_worker(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&tutor_lock);
+    for (;;) {
+        while (!queue_head && !tutor_stopping) {
+            pthread_cond_wait(&tutor_work, &tutor_lock);
+        }
+        if (!queue_head) {
+            break;
+        }
+        TutorRequest* batch[TUTOR_MAX_BATCH];
+        int count = 0;
+        while (queue_head && count < TUTOR_MAX_BATCH) {
+            batch[count++] = queue_head;
+            queue_head = queue_head->next;
+        }
+        if (!queue_head) {
+            queue_tail = NULL;
+        }
+        pthread_mutex_unlock(&tutor_lock);
+
+        serve_batch(batch, count);
+
+        pthread_mutex_lock(&tutor_lock);
+        tutor_stats.requests += count;
+        tutor_stats.batches++;
+        tutor_stats.largest_batch = count > tutor_stats.largest_batch ? count : tutor_stats.largest_batch;
+        tutor_stats.prefix_hits += batch_prefix_hits;
+        tutor_stats.prefix_misses += batch_prefix_misses;
+        batch_prefix_hits = 0;
+        batch_prefix_misses = 0;
+        for (int i = 0; i < count; i++) {
+            batch[i]->done = 1;
+        }
+        pthread_cond_broadcast(&tutor_done);
+    }
+    pthread_mutex_unlock(&tutor_lock);
+    return NULL;
+}
+
+// Queues a request and waits for its batch; returns its result or -1
+static int submit_request(TutorRequest* request) {
+    request->done = 0;
+    request->result = -1;
+    request->next = NULL;
+    pthread_mutex_lock(&tutor_lock);
+    if (!tutor_running) {
+        pthread_mutex_unlock(&tutor_lock);
+        return -1;
+    }
+    if (queue_tail) {
+        queue_tail->next = request;
+    } else {
+        queue_head = request;
+    }
+    queue_tail = request;
+    pthread_cond_signal(&tutor_work);
+    while (!request->done) {
+        pthread_cond_wait(&tutor_done, &tutor_lock);
+    }
+    pthread_mutex_unlock(&tutor_lock);
+    return request->result;
+}
+
+// ============================================================================
+// PUBLIC INTERFACE
+// ============================================================================
+
+// Loads the model for the current bank and starts the inference thread;
+// a no-op while both are current. Call from the thread that manages the
+// question bank. Returns the number of questions embedded, or -1.
+int tutor_start(void) {
+    QuestionHotTable* hot = get_question_hot_table();
+    if (tutor_running && model.generation == question_store_generation() && model.rows == hot->count) {
+        return model.rows;
+    }
+    tutor_stop();
+    if (hot->count == 0) {
+        return -1;
+    }
+    prefix_cache = malloc(TUTOR_PREFIX_SLOTS * sizeof(TutorPrefix));
+    if (!prefix_cache || !load_model()) {
+        tutor_stop();
+        return -1;
+    }
+    for (int i = 0; i < TUTOR_PREFIX_SLOTS; i++) {
+        prefix_cache[i].id = -1;
+    }
+
+    tutor_stopping = 0;
+    memset(&tutor_stats, 0, sizeof(tutor_stats));
+    tutor_stats.rows = model.rows;
+    tutor_stats.mapped = model.mapped;
+    if (pthread_create(&tutor_thread, NULL, tutor_worker, NULL) != 0) {
+        tutor_stop();
+        return -1;
+    }
+    tutor_running = 1;
+    return model.rows;
+}
+
+// Waits for queued requests, then releases the model
+void tutor_stop(void) {
+    pthread_mutex_lock(&tutor_lock);
+    int running = tutor_running;
+    tutor_running = 0;
+    tutor_stopping = 1;
+    pthread_cond_signal(&tutor_work);
+    pthread_mutex_unlock(&tutor_lock);
+    if (running) {
+        pthread_join(tutor_thread, NULL);
+    }
+    free_model();
+    free(prefix_cache);
+    prefix_cache = NULL;
+}
+
+// Answers one chat message. A session takes one message at a time; any
+// number of sessions may ask at once and are batched together. Returns the
+// reply length, or -1 if the tutor is not running.
+int tutor_reply(TutorSession* session, const char* message, char* reply, size_t size) {
+    TutorRequest request;
+    memset(&request, 0, sizeof(request));
+    request.kind = TUTOR_REQUEST_CHAT;
+    request.session = session;
+    request.message = message;
+    request.reply = reply;
+    request.reply_size = size;
+    if (size > 0) {
+        reply[0] = '\0';
+    }
+    return submit_request(&request);
+}
+
+// A hint beyond a question's own: rules out the wrong answer given, if any,
+// and points to the closest other question in the same topic
+int tutor_hint(int question_id, int wrong_answer, char* reply, size_t size) {
+    TutorRequest request;
+    memset(&request, 0, sizeof(request));
+    request.kind = TUTOR_REQUEST_HINT;
+    request.question_id = question_id;
+    request.wrong_answer = wrong_answer;
+    request.reply = reply;
+    request.reply_size = size;
+    if (size > 0) {
+        reply[0] = '\0';
+    }
+    return submit_request(&request);
+}
+
+// The questions most typical of a topic at a difficulty (0 for any), best
+// first. Returns how many were found.
+int tutor_topic_starters(TopicIndex topic, int difficulty, int* question_ids, int max_ids) {
+    TutorRequest request;
+    memset(&request, 0, sizeof(request));
+    request.kind = TUTOR_REQUEST_STARTERS;
+    request.topic = topic;
+    request.difficulty = difficulty;
+    request.question_ids = question_ids;
+    request.max_ids = max_ids;
+    return submit_request(&request);
+}
+
+void get_tutor_stats(TutorStats* stats) {
+    pthread_mutex_lock(&tutor_lock);
+    *stats = tutor_stats;
+    pthread_mutex_unlock(&tutor_lock);
+}
+
+// ============================================================================
+// LEARNING PATHS
+// ============================================================================
+
+// Weakest topics first, each with the questions most typical of it at the
+// student's current mastery
+void generate_ai_learning_path(Student* student) {
+    if (tutor_start() < 0) {
+        printf("❌ The tutor needs a question bank\n");
+        return;
+    }
+    TopicIndex order[NUM_C_TOPICS];
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        int i = t;
+        while (i > 0 && student->topic_scores[order[i - 1]] > student->topic_scores[t]) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = (TopicIndex)t;
+    }
+
+    printf("\n🗺️  Learning path for %s\n", student->name);
+    int step = 0;
+    for (int i = 0; i < NUM_C_TOPICS && step < TUTOR_PATH_TOPICS; i++) {
+        TopicIndex topic = order[i];
+        float mastery = student->topic_scores[topic];
+        int difficulty = 1 + (int)lrintf(mastery * (MAX_DIFFICULTY - 1));
+        int ids[2];
+        int found = tutor_topic_starters(topic, difficulty, ids, 2);
+        if (found <= 0) {
+            found = tutor_topic_starters(topic, 0, ids, 2);
+        }
+        if (found <= 0) {
+            continue;
+        }
+        printf("  %d. %s (mastery %.0f%%)\n", ++step, get_topic_name(topic), mastery * 100.0f);
+        for (int k = 0; k < found; k++) {
+            Question* question = get_question_by_id(ids[k]);
+            printf("     • #%d %s\n", ids[k], question ? text_get(question->question) : "");
+        }
+    }
+    if (step == 0) {
+        printf("   No questions to recommend yet\n");
+    }
+}
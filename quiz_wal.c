@@ -0,0 +1,932 @@
+// quiz_wal.c - Student progress persistence for the C Programming Quiz System
+// Every answer is appended to data/progress.log as a 32-byte delta record and
+// fsync'd in groups; data/progress.dat holds a periodic snapshot of the
+// student registry, and startup replays the log on top of it
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "quiz_system.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// ============================================================================
+// RECORD FORMATS
+// ============================================================================
+
+// Log records are fixed-size and carry their own checksum, so a torn tail
+// left by a crash is detected and cut off. LSNs increase by one per record.
+// A snapshot stores the last LSN it covers and replay skips up to it, which
+// makes a crash between writing the snapshot and truncating the log harmless.
+#define PROGRESS_SNAPSHOT_MAGIC "CQUIZPRG"
+#define PROGRESS_SNAPSHOT_VERSION 2 // 1: raw Student structs, still readable
+#define PROGRESS_LOG_BUFFER_RECORDS 4096
+#define PROGRESS_LOG_GROUP_RECORDS 256       // commit at once when this many are pending
+#define PROGRESS_LOG_COMMIT_WINDOW_MS 5      // longest a record waits to share a commit
+#define PROGRESS_LOG_COMPACT_BYTES (1 << 20) // about 32k answers to replay at most
+
+typedef enum {
+    PROGRESS_REGISTER = 1, // new student; the name follows in NAME records
+    PROGRESS_NAME,
+    PROGRESS_ANSWER
+} ProgressRecordKind;
+
+typedef struct {
+    uint64_t lsn;
+    int32_t student_id;
+    uint8_t kind;
+    uint8_t topic;      // ANSWER
+    uint8_t is_correct; // ANSWER
+    uint8_t length;     // NAME: bytes of text used
+    union {
+        struct {
+            int32_t question_id;
+            float time_taken;
+            uint32_t timestamp;
+        } answer;
+        struct {
+            uint32_t registered;
+            uint32_t reserved[2];
+        } registration;
+        char text[12];
+    } data;
+    uint32_t checksum;
+} ProgressRecord;
+
+_Static_assert(sizeof(ProgressRecord) == 32, "progress log records must stay 32 bytes");
+
+// Layout of data/progress.dat: header | student records[student_count].
+// Version 2 records are encode_student_record's variable-length form.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size; // v1: sizeof(Student) then; v2: bytes of all records
+    uint32_t student_count;
+    uint32_t records_checksum;
+    uint64_t checkpoint_lsn; // last log record folded into this snapshot
+    uint32_t header_checksum;
+    uint32_t reserved;
+} ProgressSnapshotHeader;
+
+// Student as version 1 snapshots stored it, for upgrading old files
+typedef struct {
+    char name[MAX_STRING];
+    int student_id;
+    float topic_scores[NUM_C_TOPICS];
+    int topic_questions_attempted[NUM_C_TOPICS];
+    int topic_questions_correct[NUM_C_TOPICS];
+    int total_questions_attempted;
+    int total_questions_correct;
+    float overall_accuracy;
+    int learning_streak;
+    int max_streak;
+    time_t last_practice;
+    time_t registration_date;
+    int total_study_time;
+    SkillLevel current_level;
+    float predicted_exam_score;
+    int interview_ready_score;
+    char weak_topics[NUM_C_TOPICS][100];
+    char strong_topics[NUM_C_TOPICS][100];
+    int achievements[20];
+    float learning_velocity;
+} StudentRecordV1;
+
+static uint32_t record_checksum(const ProgressRecord* record) {
+    return checksum_update(2166136261u, record, offsetof(ProgressRecord, checksum));
+}
+
+static uint32_t snapshot_header_checksum(const ProgressSnapshotHeader* header) {
+    ProgressSnapshotHeader copy = *header;
+    copy.header_checksum = 0;
+    return checksum_update(2166136261u, &copy, sizeof(copy));
+}
+
+// ============================================================================
+// LOG STATE
+// ============================================================================
+
+// Appenders copy records into `pending` under the lock and return at once.
+// The committer thread swaps the buffers, writes and syncs the batch
+// outside the lock, then publishes durable_lsn, so one fdatasync covers
+// every answer that arrived during the commit window.
+typedef struct {
+    FILE* fp;
+    char snapshot_path[MAX_STRING];
+    char log_path[MAX_STRING];
+    char reviews_path[MAX_STRING]; // empty if review schedules are not kept
+    char activity_path[MAX_STRING]; // empty if practice activity is not kept
+    pthread_t committer;
+    pthread_mutex_t lock;
+    pthread_cond_t work;      // records pending, flush requested or stopping
+    pthread_cond_t committed; // durable_lsn advanced or buffer space freed
+    ProgressRecord* pending;
+    ProgressRecord* writing;  // owned by the committer during a write
+    int pending_count;
+    int committing;
+    int flush_requested;
+    int stopping;
+    int failed;               // a write or sync failed; the log is read-only
+    uint64_t next_lsn;
+    uint64_t durable_lsn;
+    uint64_t log_bytes;
+    ProgressLogStats stats;
+} ProgressLog;
+
+static ProgressLog progress_log = { .lock = PTHREAD_MUTEX_INITIALIZER };
+static int progress_log_open = 0;
+static int covered_students = 0; // registry prefix already in the snapshot or log
+
+static int write_log_records(const ProgressRecord* records, int count) {
+    int ok = fwrite(records, sizeof(ProgressRecord), count, progress_log.fp) == (size_t)count &&
+             fflush(progress_log.fp) == 0;
+#ifndef _WIN32
+    ok = ok && fdatasync(fileno(progress_log.fp)) == 0;
+#endif
+    return ok;
+}
+
+static void* progress_committer_main(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&progress_log.lock);
+    for (;;) {
+        while (progress_log.pending_count == 0 && !progress_log.stopping) {
+            progress_log.flush_requested = 0;
+            pthread_cond_wait(&progress_log.work, &progress_log.lock);
+        }
+        if (progress_log.pending_count == 0) {
+            break;
+        }
+
+        // Let concurrent answers join this group unless someone is waiting
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += PROGRESS_LOG_COMMIT_WINDOW_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (progress_log.pending_count < PROGRESS_LOG_GROUP_RECORDS && !progress_log.flush_requested &&
+               !progress_log.stopping &&
+               pthread_cond_timedwait(&progress_log.work, &progress_log.lock, &deadline) != ETIMEDOUT) {
+        }
+        progress_log.flush_requested = 0;
+
+        ProgressRecord* batch = progress_log.pending;
+        int count = progress_log.pending_count;
+        uint64_t last_lsn = progress_log.next_lsn - 1;
+        progress_log.pending = progress_log.writing;
+        progress_log.writing = batch;
+        progress_log.pending_count = 0;
+        progress_log.committing = 1;
+        pthread_cond_broadcast(&progress_log.committed);
+        pthread_mutex_unlock(&progress_log.lock);
+
+        int ok = !progress_log.failed && write_log_records(batch, count);
+
+        pthread_mutex_lock(&progress_log.lock);
+        progress_log.committing = 0;
+        if (ok) {
+            progress_log.durable_lsn = last_lsn;
+            progress_log.log_bytes += (uint64_t)count * sizeof(ProgressRecord);
+            progress_log.stats.bytes_written += (uint64_t)count * sizeof(ProgressRecord);
+            progress_log.stats.group_commits++;
+        } else {
+            progress_log.failed = 1;
+        }
+        pthread_cond_broadcast(&progress_log.committed);
+    }
+    pthread_mutex_unlock(&progress_log.lock);
+    return NULL;
+}
+
+// Blocks until `count` records fit, so a registration is never split
+static void reserve_records_locked(int count) {
+    while (progress_log.pending_count + count > PROGRESS_LOG_BUFFER_RECORDS && !progress_log.failed) {
+        pthread_cond_wait(&progress_log.committed, &progress_log.lock);
+    }
+}
+
+static uint64_t append_record_locked(ProgressRecord* record) {
+    if (progress_log.failed || progress_log.pending_count == PROGRESS_LOG_BUFFER_RECORDS) {
+        return 0;
+    }
+    record->lsn = progress_log.next_lsn++;
+    record->checksum = record_checksum(record);
+    progress_log.pending[progress_log.pending_count++] = *record;
+    progress_log.stats.records_appended++;
+    if (progress_log.pending_count == 1 || progress_log.pending_count == PROGRESS_LOG_GROUP_RECORDS) {
+        pthread_cond_signal(&progress_log.work);
+    }
+    return record->lsn;
+}
+
+static void log_registration_locked(const Student* student) {
+    size_t name_length = strnlen(student->name, sizeof(student->name) - 1);
+    reserve_records_locked(1 + (int)((name_length + 11) / 12));
+
+    ProgressRecord record;
+    memset(&record, 0, sizeof(record));
+    record.student_id = student->student_id;
+    record.kind = PROGRESS_REGISTER;
+    record.data.registration.registered = (uint32_t)student->registration_date;
+    append_record_locked(&record);
+
+    for (size_t offset = 0; offset < name_length; offset += 12) {
+        memset(&record, 0, sizeof(record));
+        record.student_id = student->student_id;
+        record.kind = PROGRESS_NAME;
+        record.length = (uint8_t)(name_length - offset < 12 ? name_length - offset : 12);
+        memcpy(record.data.text, student->name + offset, record.length);
+        append_record_locked(&record);
+    }
+}
+
+// Returns the registry copy of the student, registering it if this is the
+// first time it is seen. Registrations the log has not recorded yet,
+// including ones made with register_student directly, are logged first so
+// replay never meets an answer for an unknown student.
+static Student* track_student_locked(const Student* student) {
+    Student* tracked = find_student_by_id(student->student_id);
+    if (!tracked) {
+        tracked = register_student(student);
+    }
+    if (!tracked) {
+        // Registered by another thread since the lookup
+        tracked = find_student_by_id(student->student_id);
+    }
+    for (; covered_students < get_total_students(); covered_students++) {
+        log_registration_locked(get_student_at(covered_students));
+    }
+    return tracked;
+}
+
+// ============================================================================
+// STUDENT RECORDS
+// ============================================================================
+
+// LEB128 varints; signed values are zigzag-encoded first
+static uint8_t* put_varint(uint8_t* out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+    return out;
+}
+
+static uint8_t* put_signed(uint8_t* out, int64_t value) {
+    return put_varint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static uint8_t* put_float(uint8_t* out, float value) {
+    memcpy(out, &value, sizeof(float));
+    return out + sizeof(float);
+}
+
+// NULL once the input runs out or a varint is malformed
+static const uint8_t* get_varint(const uint8_t* in, const uint8_t* end, uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; in && shift < 64; shift += 7) {
+        if (in >= end) {
+            return NULL;
+        }
+        *value |= (uint64_t)(*in & 0x7f) << shift;
+        if (!(*in++ & 0x80)) {
+            return in;
+        }
+    }
+    return NULL;
+}
+
+static const uint8_t* get_u32(const uint8_t* in, const uint8_t* end, uint32_t* value) {
+    uint64_t wide;
+    in = get_varint(in, end, &wide);
+    *value = (uint32_t)wide;
+    return in && wide <= UINT32_MAX ? in : NULL;
+}
+
+static const uint8_t* get_signed(const uint8_t* in, const uint8_t* end, int64_t* value) {
+    uint64_t wide;
+    in = get_varint(in, end, &wide);
+    *value = (int64_t)(wide >> 1) ^ -(int64_t)(wide & 1);
+    return in;
+}
+
+static const uint8_t* get_float(const uint8_t* in, const uint8_t* end, float* value) {
+    if (!in || end - in < (ptrdiff_t)sizeof(float)) {
+        return NULL;
+    }
+    memcpy(value, in, sizeof(float));
+    return in + sizeof(float);
+}
+
+// Record: varint body length | body. The body holds the id, name and dates,
+// then the counters as varints and the scores as raw floats, so a
+// round trip is exact. Fields added later go at the end of the body; older
+// readers skip them. Returns the bytes written, at most
+// STUDENT_RECORD_MAX_BYTES.
+size_t encode_student_record(const Student* student, uint8_t* out) {
+    uint8_t body[STUDENT_RECORD_MAX_BYTES];
+    uint8_t* p = put_signed(body, student->student_id);
+    size_t name_length = strnlen(student->name, sizeof(student->name) - 1);
+    p = put_varint(p, name_length);
+    memcpy(p, student->name, name_length);
+    p += name_length;
+    p = put_signed(p, (int64_t)student->registration_date);
+    p = put_signed(p, (int64_t)student->last_practice - (int64_t)student->registration_date);
+
+    const int counters[] = {
+        student->total_questions_attempted, student->total_questions_correct, student->learning_streak,
+        student->max_streak, student->total_study_time, (int)student->current_level,
+        student->interview_ready_score, (int)student->achievements
+    };
+    for (size_t i = 0; i < sizeof(counters) / sizeof(counters[0]); i++) {
+        p = put_varint(p, (uint32_t)counters[i]);
+    }
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        p = put_varint(p, (uint32_t)student->topic_questions_attempted[t]);
+        p = put_varint(p, (uint32_t)student->topic_questions_correct[t]);
+    }
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        p = put_float(p, student->topic_scores[t]);
+    }
+    p = put_float(p, student->overall_accuracy);
+    p = put_float(p, student->predicted_exam_score);
+    p = put_float(p, student->learning_velocity);
+
+    size_t body_length = (size_t)(p - body);
+    uint8_t* start = out;
+    out = put_varint(out, body_length);
+    memcpy(out, body, body_length);
+    return (size_t)(out + body_length - start);
+}
+
+// Fills `student` from the record at the start of `in`; returns the bytes
+// consumed, or 0 if the record is truncated or malformed
+size_t decode_student_record(const uint8_t* in, size_t length, Student* student) {
+    const uint8_t* end = in + length;
+    uint64_t body_length;
+    const uint8_t* p = get_varint(in, end, &body_length);
+    if (!p || body_length > (uint64_t)(end - p)) {
+        return 0;
+    }
+    end = p + body_length;
+    memset(student, 0, sizeof(Student));
+
+    int64_t id, registered, practiced;
+    uint64_t name_length;
+    p = get_signed(p, end, &id);
+    p = p ? get_varint(p, end, &name_length) : NULL;
+    if (!p || name_length >= sizeof(student->name) || name_length > (uint64_t)(end - p)) {
+        return 0;
+    }
+    student->student_id = (int)id;
+    memcpy(student->name, p, name_length);
+    p = get_signed(p + name_length, end, &registered);
+    p = get_signed(p, end, &practiced);
+    student->registration_date = (time_t)registered;
+    student->last_practice = (time_t)(registered + practiced);
+
+    uint32_t counters[8];
+    for (int i = 0; i < 8; i++) {
+        p = get_u32(p, end, &counters[i]);
+    }
+    student->total_questions_attempted = (int)counters[0];
+    student->total_questions_correct = (int)counters[1];
+    student->learning_streak = (int)counters[2];
+    student->max_streak = (int)counters[3];
+    student->total_study_time = (int)counters[4];
+    student->current_level = (SkillLevel)counters[5];
+    student->interview_ready_score = (int)counters[6];
+    student->achievements = counters[7];
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        uint32_t attempted, correct;
+        p = get_u32(p, end, &attempted);
+        p = get_u32(p, end, &correct);
+        student->topic_questions_attempted[t] = (int)attempted;
+        student->topic_questions_correct[t] = (int)correct;
+    }
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        p = get_float(p, end, &student->topic_scores[t]);
+    }
+    p = get_float(p, end, &student->overall_accuracy);
+    p = get_float(p, end, &student->predicted_exam_score);
+    p = get_float(p, end, &student->learning_velocity);
+    return p ? (size_t)(end - in) : 0;
+}
+
+static void upgrade_student_record(const StudentRecordV1* old, Student* student) {
+    memset(student, 0, sizeof(Student));
+    size_t name_length = strnlen(old->name, sizeof(student->name) - 1);
+    memcpy(student->name, old->name, name_length);
+    student->name[name_length] = '\0';
+    student->student_id = old->student_id;
+    memcpy(student->topic_scores, old->topic_scores, sizeof(student->topic_scores));
+    memcpy(student->topic_questions_attempted, old->topic_questions_attempted,
+           sizeof(student->topic_questions_attempted));
+    memcpy(student->topic_questions_correct, old->topic_questions_correct, sizeof(student->topic_questions_correct));
+    student->total_questions_attempted = old->total_questions_attempted;
+    student->total_questions_correct = old->total_questions_correct;
+    student->overall_accuracy = old->overall_accuracy;
+    student->learning_streak = old->learning_streak;
+    student->max_streak = old->max_streak;
+    student->last_practice = old->last_practice;
+    student->registration_date = old->registration_date;
+    student->total_study_time = old->total_study_time;
+    student->current_level = old->current_level;
+    student->predicted_exam_score = old->predicted_exam_score;
+    student->interview_ready_score = old->interview_ready_score;
+    for (int a = 0; a < NUM_ACHIEVEMENTS; a++) {
+        student->achievements |= (uint32_t)(old->achievements[a] != 0) << a;
+    }
+    student->learning_velocity = old->learning_velocity;
+}
+
+// ============================================================================
+// SNAPSHOTS
+// ============================================================================
+
+static int write_progress_snapshot(const char* filename, uint64_t checkpoint_lsn) {
+    char temp_path[MAX_STRING + 8];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", filename);
+    FILE* fp = fopen(temp_path, "wb");
+    if (!fp) {
+        return 0;
+    }
+
+    ProgressSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PROGRESS_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = PROGRESS_SNAPSHOT_VERSION;
+    header.student_count = (uint32_t)get_total_students();
+    header.checkpoint_lsn = checkpoint_lsn;
+
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    uint32_t records = 2166136261u;
+    uint64_t record_bytes = 0;
+    uint8_t record[STUDENT_RECORD_MAX_BYTES];
+    for (int i = 0; ok && i < (int)header.student_count; i++) {
+        size_t length = encode_student_record(get_student_at(i), record);
+        records = checksum_update(records, record, length);
+        record_bytes += length;
+        ok = fwrite(record, 1, length, fp) == length;
+    }
+    ok = ok && record_bytes <= UINT32_MAX;
+    header.record_size = (uint32_t)record_bytes;
+    header.records_checksum = records;
+    header.header_checksum = snapshot_header_checksum(&header);
+    ok = ok && fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1 &&
+         fflush(fp) == 0;
+#ifndef _WIN32
+    ok = ok && fsync(fileno(fp)) == 0;
+#endif
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(temp_path, filename) != 0) {
+        remove(temp_path);
+        return 0;
+    }
+    return 1;
+}
+
+// Decodes every record in `data`, or none; returns the students, or NULL
+static Student* decode_snapshot_records(const ProgressSnapshotHeader* header, const uint8_t* data) {
+    Student* students = malloc((size_t)header->student_count * sizeof(Student) + 1);
+    size_t offset = 0;
+    for (uint32_t i = 0; students && i < header->student_count; i++) {
+        size_t length = decode_student_record(data + offset, header->record_size - offset, &students[i]);
+        if (length == 0) {
+            free(students);
+            return NULL;
+        }
+        offset += length;
+    }
+    if (students && offset != header->record_size) {
+        free(students);
+        return NULL;
+    }
+    return students;
+}
+
+// Registers every student in the snapshot; returns how many, or -1 if the
+// file exists but is unusable. A missing file is an empty snapshot.
+// Version 1 snapshots are upgraded as they load.
+static int load_progress_snapshot(const char* filename, uint64_t* checkpoint_lsn) {
+    *checkpoint_lsn = 0;
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) {
+        return 0;
+    }
+
+    ProgressSnapshotHeader header;
+    int ok = fread(&header, sizeof(header), 1, fp) == 1 &&
+             memcmp(header.magic, PROGRESS_SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+             header.header_checksum == snapshot_header_checksum(&header) &&
+             (header.version == PROGRESS_SNAPSHOT_VERSION ||
+              (header.version == 1 && header.record_size == sizeof(StudentRecordV1)));
+
+    // Check the whole snapshot before registering any of it
+    size_t data_size = !ok ? 0
+                       : header.version == 1 ? (size_t)header.student_count * sizeof(StudentRecordV1)
+                                             : header.record_size;
+    uint8_t* data = ok ? malloc(data_size + 1) : NULL;
+    ok = data && fread(data, 1, data_size, fp) == data_size &&
+         checksum_update(2166136261u, data, data_size) == header.records_checksum;
+    fclose(fp);
+
+    Student* students = NULL;
+    if (ok && header.version == 1) {
+        students = malloc((size_t)header.student_count * sizeof(Student) + 1);
+        for (uint32_t i = 0; students && i < header.student_count; i++) {
+            StudentRecordV1 old;
+            memcpy(&old, data + (size_t)i * sizeof(StudentRecordV1), sizeof(old));
+            upgrade_student_record(&old, &students[i]);
+        }
+    } else if (ok) {
+        students = decode_snapshot_records(&header, data);
+    }
+    free(data);
+    if (!students) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < header.student_count; i++) {
+        register_student(&students[i]);
+    }
+    free(students);
+    *checkpoint_lsn = header.checkpoint_lsn;
+    return (int)header.student_count;
+}
+
+// ============================================================================
+// RECOVERY
+// ============================================================================
+
+static void replay_progress_record(const ProgressRecord* record, Student** naming, size_t* name_fill) {
+    Student* student = find_student_by_id(record->student_id);
+
+    switch (record->kind) {
+    case PROGRESS_REGISTER:
+        if (!student) {
+            Student profile;
+            memset(&profile, 0, sizeof(profile));
+            profile.student_id = record->student_id;
+            reset_student_progress(&profile);
+            profile.registration_date = (time_t)record->data.registration.registered;
+            profile.last_practice = profile.registration_date;
+            student = register_student(&profile);
+        }
+        *naming = student;
+        *name_fill = 0;
+        break;
+    case PROGRESS_NAME:
+        // Name records directly follow their registration
+        if (student && student == *naming && *name_fill + record->length < sizeof(student->name)) {
+            memcpy(student->name + *name_fill, record->data.text, record->length);
+            *name_fill += record->length;
+            student->name[*name_fill] = '\0';
+        }
+        break;
+    case PROGRESS_ANSWER:
+        if (student && record->topic < NUM_C_TOPICS) {
+            apply_answer_to_student(student, (TopicIndex)record->topic, record->is_correct);
+            student->last_practice = (time_t)record->data.answer.timestamp;
+            if (record->lsn > get_activity_checkpoint_lsn()) {
+                record_activity(student, (TopicIndex)record->topic, record->is_correct, student->last_practice);
+            }
+            int slot = find_question_slot(record->data.answer.question_id);
+            if (slot >= 0 && record->lsn > get_review_checkpoint_lsn()) {
+                review_record_answer(student->student_id, slot, record->is_correct,
+                                     record->data.answer.time_taken, student->last_practice);
+            }
+        }
+        break;
+    }
+}
+
+// Replays every intact record past the snapshot and returns the number of
+// bytes that hold them; anything after that is a torn or stale tail
+static long replay_progress_log(FILE* fp, uint64_t checkpoint_lsn, uint64_t* last_lsn) {
+    ProgressRecord record;
+    Student* naming = NULL;
+    size_t name_fill = 0;
+    long valid_bytes = 0;
+
+    *last_lsn = checkpoint_lsn;
+    uint64_t expected = 0;
+    while (fread(&record, sizeof(record), 1, fp) == 1) {
+        if (record.checksum != record_checksum(&record) || (expected != 0 && record.lsn != expected)) {
+            break;
+        }
+        expected = record.lsn + 1;
+        valid_bytes += (long)sizeof(record);
+        if (record.lsn > checkpoint_lsn) {
+            replay_progress_record(&record, &naming, &name_fill);
+            progress_log.stats.records_replayed++;
+            *last_lsn = record.lsn;
+        }
+    }
+    return valid_bytes;
+}
+
+// Answers in a progress log, in log order, for batch replay. The log keeps
+// correctness rather than the option picked, so a wrong answer becomes the
+// option after the correct one. Stops at the first torn or corrupt record;
+// returns the number of answers, or -1 if the log cannot be read.
+int read_progress_log_answers(const char* log_path, GradedAnswer** answers) {
+    *answers = NULL;
+    FILE* fp = fopen(log_path, "rb");
+    if (!fp) {
+        return -1;
+    }
+
+    ProgressRecord record;
+    uint64_t expected = 0;
+    int count = 0;
+    int capacity = 0;
+    while (fread(&record, sizeof(record), 1, fp) == 1) {
+        if (record.checksum != record_checksum(&record) || (expected != 0 && record.lsn != expected)) {
+            break;
+        }
+        expected = record.lsn + 1;
+        if (record.kind != PROGRESS_ANSWER) {
+            continue;
+        }
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            GradedAnswer* grown = realloc(*answers, capacity * sizeof(GradedAnswer));
+            if (!grown) {
+                fclose(fp);
+                free(*answers);
+                *answers = NULL;
+                return -1;
+            }
+            *answers = grown;
+        }
+        const Question* question = get_question_by_id(record.data.answer.question_id);
+        GradedAnswer* answer = &(*answers)[count++];
+        answer->student_id = record.student_id;
+        answer->question_id = record.data.answer.question_id;
+        answer->answer = !question ? -1
+                         : record.is_correct ? question->correct_answer
+                                             : (question->correct_answer + 1) % MAX_OPTIONS;
+        answer->response_time = record.data.answer.time_taken;
+        answer->answered_at = (time_t)record.data.answer.timestamp;
+    }
+    fclose(fp);
+    return count;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+// Loads the snapshot, replays the log into the student registry and starts
+// the committer. Returns the number of registered students, or -1.
+// reviews_path may be NULL; otherwise review schedules are loaded from it
+// and checkpointed to it alongside the student snapshot. activity_path
+// likewise keeps the practice-day bitmaps behind streaks.
+int open_student_progress(const char* snapshot_path, const char* log_path, const char* reviews_path,
+                          const char* activity_path) {
+    if (progress_log_open) {
+        return get_total_students();
+    }
+    TRACE_SCOPE(TRACE_PROGRESS_RECOVERY);
+    memset(&progress_log.stats, 0, sizeof(ProgressLogStats));
+
+    uint64_t checkpoint_lsn = 0;
+    if (load_progress_snapshot(snapshot_path, &checkpoint_lsn) < 0) {
+        printf("⚠️  Ignoring %s: unrecognised format or corrupt data\n", snapshot_path);
+    }
+    if (reviews_path && load_review_decks(reviews_path) < 0) {
+        printf("⚠️  Ignoring %s: unrecognised format or corrupt data\n", reviews_path);
+    }
+    if (activity_path && load_student_activity(activity_path) < 0) {
+        printf("⚠️  Ignoring %s: unrecognised format or corrupt data\n", activity_path);
+    }
+
+    uint64_t last_lsn = checkpoint_lsn;
+    long valid_bytes = 0;
+    FILE* fp = fopen(log_path, "r+b");
+    if (fp) {
+        valid_bytes = replay_progress_log(fp, checkpoint_lsn, &last_lsn);
+#ifndef _WIN32
+        if (fseek(fp, 0, SEEK_END) == 0 && ftell(fp) > valid_bytes) {
+            if (ftruncate(fileno(fp), valid_bytes) != 0) {
+                valid_bytes = ftell(fp);
+            }
+        }
+#endif
+        fclose(fp);
+    }
+
+    progress_log.fp = fopen(log_path, "ab");
+    progress_log.pending = malloc(PROGRESS_LOG_BUFFER_RECORDS * sizeof(ProgressRecord));
+    progress_log.writing = malloc(PROGRESS_LOG_BUFFER_RECORDS * sizeof(ProgressRecord));
+    if (!progress_log.fp || !progress_log.pending || !progress_log.writing) {
+        goto fail;
+    }
+    snprintf(progress_log.snapshot_path, sizeof(progress_log.snapshot_path), "%s", snapshot_path);
+    snprintf(progress_log.log_path, sizeof(progress_log.log_path), "%s", log_path);
+    snprintf(progress_log.reviews_path, sizeof(progress_log.reviews_path), "%s", reviews_path ? reviews_path : "");
+    snprintf(progress_log.activity_path, sizeof(progress_log.activity_path), "%s",
+             activity_path ? activity_path : "");
+    progress_log.pending_count = 0;
+    progress_log.committing = 0;
+    progress_log.flush_requested = 0;
+    progress_log.stopping = 0;
+    progress_log.failed = 0;
+    progress_log.next_lsn = last_lsn + 1;
+    progress_log.durable_lsn = last_lsn;
+    progress_log.log_bytes = (uint64_t)valid_bytes;
+    covered_students = get_total_students();
+    pthread_cond_init(&progress_log.work, NULL);
+    pthread_cond_init(&progress_log.committed, NULL);
+    if (pthread_create(&progress_log.committer, NULL, progress_committer_main, NULL) != 0) {
+        pthread_cond_destroy(&progress_log.work);
+        pthread_cond_destroy(&progress_log.committed);
+        goto fail;
+    }
+    progress_log_open = 1;
+    return get_total_students();
+
+fail:
+    if (progress_log.fp) {
+        fclose(progress_log.fp);
+    }
+    free(progress_log.pending);
+    free(progress_log.writing);
+    progress_log.fp = NULL;
+    progress_log.pending = progress_log.writing = NULL;
+    return -1;
+}
+
+// Queues the delta for one answer the caller has already applied to
+// `student`. Returns its LSN (0 if the log is closed or failed); the record
+// is durable once wait_for_student_progress(lsn) returns. Students seen for
+// the first time are registered, and callers holding their own copy of a
+// student have it mirrored into the registry so checkpoints capture it.
+uint64_t log_student_answer(Student* student, const Question* question, int is_correct, float time_taken) {
+    if (!progress_log_open) {
+        return 0;
+    }
+    TRACE_SCOPE(TRACE_PROGRESS_LOG);
+
+    ProgressRecord record;
+    memset(&record, 0, sizeof(record));
+    record.student_id = student->student_id;
+    record.kind = PROGRESS_ANSWER;
+    record.topic = (uint8_t)question_topic(question);
+    record.is_correct = is_correct ? 1 : 0;
+    record.data.answer.question_id = question->id;
+    record.data.answer.time_taken = time_taken;
+    record.data.answer.timestamp = (uint32_t)student->last_practice;
+
+    pthread_mutex_lock(&progress_log.lock);
+    Student* tracked = track_student_locked(student);
+    if (tracked && tracked != student) {
+        *tracked = *student;
+    }
+    reserve_records_locked(1);
+    uint64_t lsn = append_record_locked(&record);
+    pthread_mutex_unlock(&progress_log.lock);
+    return lsn;
+}
+
+// Commits immediately and waits until every record up to lsn is on disk
+int wait_for_student_progress(uint64_t lsn) {
+    if (!progress_log_open) {
+        return 0;
+    }
+    pthread_mutex_lock(&progress_log.lock);
+    progress_log.flush_requested = 1;
+    pthread_cond_signal(&progress_log.work);
+    while (progress_log.durable_lsn < lsn && !progress_log.failed) {
+        pthread_cond_wait(&progress_log.committed, &progress_log.lock);
+    }
+    int ok = progress_log.durable_lsn >= lsn;
+    pthread_mutex_unlock(&progress_log.lock);
+    return ok;
+}
+
+// Waits until every answer logged so far is durable
+int flush_student_progress(void) {
+    if (!progress_log_open) {
+        return 0;
+    }
+    pthread_mutex_lock(&progress_log.lock);
+    uint64_t lsn = progress_log.next_lsn - 1;
+    pthread_mutex_unlock(&progress_log.lock);
+    return wait_for_student_progress(lsn);
+}
+
+int student_progress_checkpoint_due(void) {
+    if (!progress_log_open) {
+        return 0;
+    }
+    pthread_mutex_lock(&progress_log.lock);
+    int due = progress_log.log_bytes >= PROGRESS_LOG_COMPACT_BYTES;
+    pthread_mutex_unlock(&progress_log.lock);
+    return due;
+}
+
+// Writes the registry as a new snapshot and empties the log. No thread may
+// be applying answers meanwhile: the session engine calls this while its
+// workers are paused, everything else from the thread that answers.
+int checkpoint_student_progress(void) {
+    if (!progress_log_open) {
+        return 0;
+    }
+    TRACE_SCOPE(TRACE_PROGRESS_CHECKPOINT);
+    pthread_mutex_lock(&progress_log.lock);
+    progress_log.flush_requested = 1;
+    pthread_cond_signal(&progress_log.work);
+    while ((progress_log.pending_count > 0 || progress_log.committing) && !progress_log.failed) {
+        pthread_cond_wait(&progress_log.committed, &progress_log.lock);
+    }
+
+    // Holding the lock keeps appenders out until the log is truncated. If a
+    // backup is still reading the log, the records stay; replay skips them.
+    int ok = !progress_log.failed &&
+             (!progress_log.reviews_path[0] ||
+              save_review_decks(progress_log.reviews_path, progress_log.next_lsn - 1)) &&
+             (!progress_log.activity_path[0] ||
+              save_student_activity(progress_log.activity_path, progress_log.next_lsn - 1)) &&
+             write_progress_snapshot(progress_log.snapshot_path, progress_log.next_lsn - 1);
+#ifndef _WIN32
+    if (ok && begin_in_place_write(progress_log.log_path)) {
+        ok = ftruncate(fileno(progress_log.fp), 0) == 0 && fsync(fileno(progress_log.fp)) == 0;
+        end_in_place_write();
+    }
+#endif
+    if (ok) {
+        covered_students = get_total_students();
+        progress_log.log_bytes = 0;
+        progress_log.stats.checkpoints++;
+    }
+    pthread_mutex_unlock(&progress_log.lock);
+    return ok;
+}
+
+// Checkpoints, stops the committer and closes the log
+void close_student_progress(void) {
+    if (!progress_log_open) {
+        return;
+    }
+    checkpoint_student_progress();
+
+    pthread_mutex_lock(&progress_log.lock);
+    progress_log.stopping = 1;
+    pthread_cond_signal(&progress_log.work);
+    pthread_mutex_unlock(&progress_log.lock);
+    pthread_join(progress_log.committer, NULL);
+
+    fclose(progress_log.fp);
+    free(progress_log.pending);
+    free(progress_log.writing);
+    progress_log.fp = NULL;
+    progress_log.pending = progress_log.writing = NULL;
+    pthread_cond_destroy(&progress_log.work);
+    pthread_cond_destroy(&progress_log.committed);
+    progress_log_open = 0;
+}
+
+void get_progress_log_stats(ProgressLogStats* stats) {
+    pthread_mutex_lock(&progress_log.lock);
+    *stats = progress_log.stats;
+    pthread_mutex_unlock(&progress_log.lock);
+}
+
+// Copies the student's saved progress into *student, matched by student_id.
+// Returns 1 if the student is known.
+int load_student_progress(Student* student) {
+    pthread_mutex_lock(&progress_log.lock);
+    Student* saved = find_student_by_id(student->student_id);
+    if (saved && saved != student) {
+        *student = *saved;
+    }
+    pthread_mutex_unlock(&progress_log.lock);
+    return saved != NULL;
+}
+
+// Records the student's profile and waits until everything logged for it is
+// durable. Answers are logged as they happen; other profile edits reach disk
+// with the next checkpoint.
+int save_student_progress(Student* student) {
+    if (!progress_log_open) {
+        return 0;
+    }
+    pthread_mutex_lock(&progress_log.lock);
+    Student* tracked = track_student_locked(student);
+    if (tracked && tracked != student) {
+        *tracked = *student;
+    }
+    uint64_t lsn = progress_log.next_lsn - 1;
+    pthread_mutex_unlock(&progress_log.lock);
+    return tracked != NULL && wait_for_student_progress(lsn);
+}
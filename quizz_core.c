@@ -1,18 +1,18 @@
 // quiz_core.c - Core implementation of C Programming Quiz System
 // Contains main quiz logic, AI algorithms, and system management
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "quiz_system.h"
 
+#include <ctype.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 // ============================================================================
 // GLOBAL VARIABLES
 // ============================================================================
 
-static Question question_bank[MAX_QUESTIONS];
-static Student registered_students[MAX_STUDENTS];
-static SystemAnalytics system_stats;
-static int total_questions = 0;
-static int total_students = 0;
-
 // Topic names array
 const char* c_topic_names[NUM_C_TOPICS] = {
     "C Basics & Syntax",
@@ -50,7 +50,14 @@ int initialize_quiz_system(void) {
     }
     
     // Initialize system statistics
-    memset(&system_stats, 0, sizeof(SystemAnalytics));
+    reset_system_analytics();
+
+    // QUIZ_TEXT_CACHE_KB caps the question text kept in memory; 0 maps the
+    // whole question file instead
+    const char* text_cache_kb = getenv("QUIZ_TEXT_CACHE_KB");
+    if (text_cache_kb) {
+        set_text_cache_budget((size_t)strtoul(text_cache_kb, NULL, 10) * 1024);
+    }
     
     // Load questions from data files
     if (load_questions_from_file(QUESTIONS_FILE) == 0) {
@@ -58,189 +65,156 @@ int initialize_quiz_system(void) {
         create_default_question_bank();
     }
     
-    printf("✅ Quiz system initialized with %d questions\n", total_questions);
+    // Restore students, review schedules and practice days from the last
+    // checkpoint plus the progress log
+    int students = open_student_progress(PROGRESS_FILE, PROGRESS_LOG_FILE, REVIEWS_FILE, ANALYTICS_FILE);
+    if (students < 0) {
+        printf("⚠️  Student progress log unavailable; answers will not be saved\n");
+    }
+    
+    printf("✅ Quiz system initialized with %d questions and %d students\n",
+           get_total_questions(), get_total_students());
+
+    // Backs up what the last run left on disk while this one serves
+    backup_if_due();
     return 0;
 }
 
 void cleanup_quiz_system(void) {
     save_questions_to_file(QUESTIONS_FILE);
-    backup_data_files();
+    close_student_progress();
+    tutor_stop();
+    
+    // Backups run periodically while the quiz serves; one still running is
+    // abandoned rather than waited for, and this run's final state is
+    // backed up at the next startup
+    cancel_backup();
     printf("💾 System cleanup completed\n");
 }
 
 int get_total_questions(void) {
-    return total_questions;
+    return get_question_hot_table()->count;
 }
 
 // ============================================================================
 // QUESTION MANAGEMENT
 // ============================================================================
 
-void create_default_question_bank(void) {
-    printf("📚 Creating default C programming question bank...\n");
-    
-    // C BASICS QUESTIONS
-    add_c_basics_questions();
-    add_variables_datatypes_questions();
-    add_operators_expressions_questions();
-    add_control_structures_questions();
-    add_functions_questions();
-    add_arrays_strings_questions();
-    add_pointers_questions();
-    add_structures_unions_questions();
-    add_file_io_questions();
-    add_memory_management_questions();
-    add_preprocessor_questions();
-    add_advanced_c_questions();
-    
-    printf("✅ Created %d default questions across all topics\n", total_questions);
+int validate_question(const QuestionDraft* question) {
+    if (!question || !question->question || question->question[0] == '\0') {
+        return 0;
+    }
+    if (question->difficulty < 1 || question->difficulty > MAX_DIFFICULTY) {
+        return 0;
+    }
+    if (question->topic < 0 || question->topic >= NUM_C_TOPICS) {
+        return 0;
+    }
+    if (question->correct_answer < 0 || question->correct_answer >= MAX_OPTIONS) {
+        return 0;
+    }
+    if (question->code_snippet && strlen(question->code_snippet) >= MAX_CODE_LENGTH) {
+        return 0;
+    }
+    return 1;
 }
 
-void add_c_basics_questions(void) {
-    Question q;
+// Returns the new question's id, or -1 if the draft is rejected
+int add_question(const QuestionDraft* draft) {
+    if (!validate_question(draft)) {
+        return -1;
+    }
     
-    // Question 1: Basic C syntax
-    q.id = total_questions++;
-    strcpy(q.question, "Which of the following is the correct way to include a standard library in C?");
-    strcpy(q.options[0], "#include <stdio.h>");
-    strcpy(q.options[1], "include stdio.h");
-    strcpy(q.options[2], "#include stdio.h");
-    strcpy(q.options[3], "using stdio.h");
-    q.correct_answer = 0;
-    strcpy(q.explanation, "Standard libraries are included using #include <library_name.h> syntax");
-    q.difficulty = 1;
-    q.topic = C_BASICS;
-    q.type = MULTIPLE_CHOICE;
-    strcpy(q.hints[0], "Think about preprocessor directives");
-    strcpy(q.hints[1], "Standard libraries use angle brackets");
-    strcpy(q.hints[2], "The # symbol is important for preprocessor commands");
-    question_bank[q.id] = q;
+    QuestionDraft q = *draft;
+    if (q.id < 0) {
+        q.id = next_question_id();
+    } else if (find_question_slot(q.id) >= 0) {
+        return -1; // ids are unique
+    }
     
-    // Question 2: main function
-    q.id = total_questions++;
-    strcpy(q.question, "What is the correct signature for the main function in C?");
-    strcpy(q.options[0], "void main()");
-    strcpy(q.options[1], "int main()");
-    strcpy(q.options[2], "main()");
-    strcpy(q.options[3], "int main(void)");
-    q.correct_answer = 3;
-    strcpy(q.explanation, "int main(void) is the most precise way to declare main with no parameters");
-    q.difficulty = 2;
-    q.topic = C_BASICS;
-    q.type = MULTIPLE_CHOICE;
-    strcpy(q.hints[0], "Main should return an integer");
-    strcpy(q.hints[1], "Use void to explicitly indicate no parameters");
-    question_bank[q.id] = q;
+    int slot = question_store_append(&q);
+    if (slot < 0) {
+        return -1;
+    }
+    index_new_question(slot);
+    return q.id;
+}
+
+// Kept for existing callers; lookups go through the id hash index, which
+// does not depend on the bank's order
+Question* binary_search_question(int id) {
+    return get_question_by_id(id);
+}
+
+Question* get_question_by_id(int id) {
+    return question_at(find_question_slot(id));
+}
+
+Question* get_random_question(void) {
+    int count = get_total_questions();
+    return count > 0 ? question_at(rand() % count) : NULL;
+}
+
+Question* get_question_by_topic(TopicIndex topic) {
+    int total = count_questions_in_topic(topic);
+    if (total == 0) {
+        return NULL;
+    }
     
-    // Question 3: Code output
-    q.id = total_questions++;
-    strcpy(q.question, "What is the output of the following C code?");
-    strcpy(q.code_snippet, 
-        "#include <stdio.h>\n"
-        "int main(void) {\n"
-        "    printf(\"Hello, World!\\n\");\n"
-        "    return 0;\n"
-        "}");
-    strcpy(q.options[0], "Hello, World!");
-    strcpy(q.options[1], "Hello, World!\\n");
-    strcpy(q.options[2], "Hello, World! followed by a newline");
-    strcpy(q.options[3], "Compilation error");
-    q.correct_answer = 2;
-    strcpy(q.explanation, "\\n creates a newline character, so output is Hello, World! on one line followed by a newline");
-    q.difficulty = 1;
-    q.topic = C_BASICS;
-    q.type = CODE_OUTPUT;
-    strcpy(q.hints[0], "\\n represents a newline character");
-    question_bank[q.id] = q;
+    // Pick uniformly across the topic's difficulty buckets
+    int pick = rand() % total;
+    for (int d = 1; d <= MAX_DIFFICULTY; d++) {
+        int count;
+        const int* slots = get_question_bucket(topic, d, &count);
+        if (pick < count) {
+            return question_at(slots[pick]);
+        }
+        pick -= count;
+    }
+    return NULL;
 }
 
-void add_pointers_questions(void) {
-    Question q;
+// Difficulty 0 matches every difficulty. The caller frees the returned array;
+// get_question_bucket gives the same candidates without allocating.
+Question** filter_questions_by_criteria(TopicIndex topic, int difficulty, int* result_count) {
+    TRACE_SCOPE(TRACE_FILTER);
+    int first = difficulty == 0 ? 1 : difficulty;
+    int last = difficulty == 0 ? MAX_DIFFICULTY : difficulty;
+    int matches = difficulty == 0 ? count_questions_in_topic(topic) : 0;
+    *result_count = 0;
     
-    // Advanced pointer question
-    q.id = total_questions++;
-    strcpy(q.question, "What is the output of this pointer manipulation code?");
-    strcpy(q.code_snippet,
-        "#include <stdio.h>\n"
-        "int main(void) {\n"
-        "    int x = 10;\n"
-        "    int *p = &x;\n"
-        "    int **pp = &p;\n"
-        "    printf(\"%d\", **pp);\n"
-        "    return 0;\n"
-        "}");
-    strcpy(q.options[0], "10");
-    strcpy(q.options[1], "Address of x");
-    strcpy(q.options[2], "Address of p");
-    strcpy(q.options[3], "Compilation error");
-    q.correct_answer = 0;
-    strcpy(q.explanation, "**pp dereferences twice: first *pp gives p, then *p gives x which is 10");
-    q.difficulty = 4;
-    q.topic = POINTERS;
-    q.type = CODE_OUTPUT;
-    strcpy(q.hints[0], "pp is a pointer to a pointer");
-    strcpy(q.hints[1], "Each * dereferences one level");
-    strcpy(q.hints[2], "**pp = *(*(pp)) = *p = x = 10");
-    question_bank[q.id] = q;
+    if (difficulty != 0) {
+        get_question_bucket(topic, difficulty, &matches);
+    }
+    if (matches == 0) {
+        return NULL;
+    }
     
-    // Pointer arithmetic
-    q.id = total_questions++;
-    strcpy(q.question, "If int *p points to arr[2] where arr = {10,20,30,40,50}, what is *(p+1)?");
-    strcpy(q.options[0], "20");
-    strcpy(q.options[1], "30");
-    strcpy(q.options[2], "40");
-    strcpy(q.options[3], "Undefined behavior");
-    q.correct_answer = 2;
-    strcpy(q.explanation, "p points to arr[2] (value 30), so p+1 points to arr[3] (value 40)");
-    q.difficulty = 3;
-    q.topic = POINTERS;
-    q.type = MULTIPLE_CHOICE;
-    strcpy(q.hints[0], "Pointer arithmetic moves by sizeof(int) bytes");
-    strcpy(q.hints[1], "p+1 moves to the next array element");
-    question_bank[q.id] = q;
+    Question** results = malloc(matches * sizeof(Question*));
+    if (!results) {
+        return NULL;
+    }
+    for (int d = first; d <= last; d++) {
+        int count;
+        const int* slots = get_question_bucket(topic, d, &count);
+        for (int i = 0; i < count; i++) {
+            results[(*result_count)++] = question_at(slots[i]);
+        }
+    }
+    return results;
 }
 
-void add_memory_management_questions(void) {
-    Question q;
+// The built-in bank is compiled from questions/default_bank.def into
+// read-only data, which the store attaches without copying
+void create_default_question_bank(void) {
+    printf("📚 Creating default C programming question bank...\n");
     
-    // Memory allocation
-    q.id = total_questions++;
-    strcpy(q.question, "Which function should be used to allocate memory for an array of 10 integers initialized to zero?");
-    strcpy(q.options[0], "malloc(10 * sizeof(int))");
-    strcpy(q.options[1], "calloc(10, sizeof(int))");
-    strcpy(q.options[2], "realloc(NULL, 10 * sizeof(int))");
-    strcpy(q.options[3], "Both A and B are correct");
-    q.correct_answer = 1;
-    strcpy(q.explanation, "calloc() allocates memory and initializes it to zero, malloc() doesn't initialize");
-    q.difficulty = 3;
-    q.topic = MEMORY_MANAGEMENT;
-    q.type = MULTIPLE_CHOICE;
-    strcpy(q.hints[0], "Think about which function initializes memory to zero");
-    strcpy(q.hints[1], "calloc = cleared allocation");
-    question_bank[q.id] = q;
+    if (!attach_question_bank(&default_question_bank)) {
+        printf("❌ Not enough memory for the default question bank\n");
+        return;
+    }
     
-    // Memory leak detection
-    q.id = total_questions++;
-    strcpy(q.question, "Identify the problem in this code:");
-    strcpy(q.code_snippet,
-        "void function() {\n"
-        "    int *ptr = malloc(100 * sizeof(int));\n"
-        "    if (ptr == NULL) return;\n"
-        "    // ... use ptr ...\n"
-        "    return;\n"
-        "}");
-    strcpy(q.options[0], "No error checking");
-    strcpy(q.options[1], "Memory leak - missing free()");
-    strcpy(q.options[2], "Wrong allocation size");
-    strcpy(q.options[3], "Incorrect return type");
-    q.correct_answer = 1;
-    strcpy(q.explanation, "Memory allocated with malloc() must be freed with free() to avoid memory leaks");
-    q.difficulty = 3;
-    q.topic = MEMORY_MANAGEMENT;
-    q.type = DEBUG_CODE;
-    strcpy(q.hints[0], "What happens to allocated memory when function returns?");
-    strcpy(q.hints[1], "Every malloc() needs a corresponding free()");
-    question_bank[q.id] = q;
+    printf("✅ Created %d default questions across all topics\n", get_total_questions());
 }
 
 // ============================================================================
@@ -249,7 +223,16 @@ void add_memory_management_questions(void) {
 
 void initialize_student(Student* student) {
     student->student_id = rand() % 10000 + 1000;
+    reset_student_progress(student);
+    student->last_practice = time(NULL);
+    student->registration_date = time(NULL);
     
+    printf("✅ Student profile initialized for %s (ID: %d)\n", 
+           student->name, student->student_id);
+}
+
+// Starting statistics for a new profile; identity and dates are left alone
+void reset_student_progress(Student* student) {
     // Initialize all topic scores to 0.5 (neutral starting point)
     for (int i = 0; i < NUM_C_TOPICS; i++) {
         student->topic_scores[i] = 0.5f;
@@ -262,22 +245,47 @@ void initialize_student(Student* student) {
     student->overall_accuracy = 0.0f;
     student->learning_streak = 0;
     student->max_streak = 0;
-    student->last_practice = time(NULL);
-    student->registration_date = time(NULL);
     student->total_study_time = 0;
     student->current_level = BEGINNER;
     student->predicted_exam_score = 50.0f;
     student->interview_ready_score = 0;
     student->learning_velocity = 0.0f;
     
-    // Initialize achievements
-    memset(student->achievements, 0, sizeof(student->achievements));
-    
-    printf("✅ Student profile initialized for %s (ID: %d)\n", 
-           student->name, student->student_id);
+    student->achievements = 0;
 }
 
 void update_student_stats(Student* student, Question* question, int is_correct, float time_taken) {
+    update_student_stats_at(student, question, is_correct, time_taken, time(NULL));
+}
+
+// Applies an answer given at `answered_at`, so recorded answers replay with
+// the review schedule and activity days they had originally
+void update_student_stats_at(Student* student, Question* question, int is_correct, float time_taken,
+                             time_t answered_at) {
+    TRACE_SCOPE(TRACE_UPDATE_STATS);
+    apply_answer_to_student(student, question_topic(question), is_correct);
+    student->last_practice = answered_at;
+    record_question_attempt(question->slot, is_correct, time_taken);
+    
+    // Only this topic's cached recommendation needs repairing
+    refresh_question_recommendation(question->slot);
+    recommendation_record_answer(student, question, is_correct, time_taken);
+    record_activity(student, question_topic(question), is_correct, student->last_practice);
+    refresh_question_analytics(question->slot);
+    
+    // A 32-byte delta goes to the progress log; the snapshot is only
+    // rewritten once enough of them have piled up
+    log_student_answer(student, question, is_correct, time_taken);
+    if (student_progress_checkpoint_due()) {
+        checkpoint_student_progress();
+        backup_if_due();
+    }
+}
+
+// Student half of update_student_stats. Writes only this student; the one
+// shared structure it touches, the leaderboards, re-ranks it under their
+// lock. So the session engine can run it for different students in parallel.
+void apply_answer_to_student(Student* student, TopicIndex topic, int is_correct) {
     // Update overall stats
     student->total_questions_attempted++;
     if (is_correct) {
@@ -291,17 +299,16 @@ void update_student_stats(Student* student, Question* question, int is_correct,
     }
     
     // Update topic-specific stats
-    int topic = question->topic;
     student->topic_questions_attempted[topic]++;
     if (is_correct) {
         student->topic_questions_correct[topic]++;
     }
     
-    // Calculate topic score using weighted average
+    // Topic mastery is a moving average; per-question recall is tracked by
+    // the review scheduler
     float current_score = student->topic_scores[topic];
     float new_performance = is_correct ? 1.0f : 0.0f;
-    float weight = 0.8f; // Weight for existing performance
-    student->topic_scores[topic] = current_score * weight + new_performance * (1.0f - weight);
+    student->topic_scores[topic] = current_score * TOPIC_SCORE_RETENTION + new_performance * (1.0f - TOPIC_SCORE_RETENTION);
     
     // Update overall accuracy
     student->overall_accuracy = (float)student->total_questions_correct / student->total_questions_attempted;
@@ -309,13 +316,160 @@ void update_student_stats(Student* student, Question* question, int is_correct,
     // Update skill level
     student->current_level = determine_skill_level(student);
     
-    // Update question statistics
-    question->times_asked++;
+    student->last_practice = time(NULL);
+    
+    // O(log n) re-rank; leaderboards are never rebuilt by sorting
+    update_leaderboard(student, topic);
+}
+
+// Question half of update_student_stats, for single-threaded callers. The
+// session engine accumulates into per-worker shards instead.
+void record_question_attempt(int slot, int is_correct, float time_taken) {
+    QuestionHotTable* hot = get_question_hot_table();
+    hot->times_asked[slot]++;
     if (is_correct) {
-        question->times_correct++;
+        hot->times_correct[slot]++;
     }
     
     // Update average time
-    question->avg_time_taken = (question->avg_time_taken * (question->times_asked - 1) + time_taken) / question->times_asked;
+    hot->avg_time_taken[slot] = (hot->avg_time_taken[slot] * (hot->times_asked[slot] - 1) + time_taken) / hot->times_asked[slot];
+    record_response_time(slot, time_taken);
+}
+
+// ============================================================================
+// SCORING UTILITIES
+// ============================================================================
+
+float calculate_accuracy(int correct, int total) {
+    return total > 0 ? (float)correct / total : 0.0f;
+}
+
+// A level needs both the accuracy and enough answers behind it, so a lucky
+// first few questions do not jump a student straight to Expert
+SkillLevel determine_skill_level(Student* student) {
+    float accuracy = student->overall_accuracy;
+    int attempted = student->total_questions_attempted;
+    
+    if (accuracy >= 0.9f && attempted >= 200) {
+        return EXPERT;
+    }
+    if (accuracy >= 0.75f && attempted >= 100) {
+        return ADVANCED;
+    }
+    if (accuracy >= 0.6f && attempted >= 30) {
+        return INTERMEDIATE;
+    }
+    return BEGINNER;
+}
+
+// Comma-separated names of the practised topics a student is weak in
+// (mastery below WEAK_TOPIC_SCORE) or, with `strong`, strong in. Derived
+// from topic_scores each time; returns the number of topics listed.
+int describe_topics(const Student* student, int strong, char* buffer, size_t size) {
+    int count = 0;
+    size_t used = 0;
+    if (size > 0) {
+        buffer[0] = '\0';
+    }
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        float score = student->topic_scores[t];
+        if (student->topic_questions_attempted[t] == 0 ||
+            (strong ? score < STRONG_TOPIC_SCORE : score >= WEAK_TOPIC_SCORE)) {
+            continue;
+        }
+        int written = snprintf(buffer + used, used < size ? size - used : 0, "%s%s", count ? ", " : "",
+                               c_topic_names[t]);
+        used += written > 0 ? (size_t)written : 0;
+        count++;
+    }
+    return count;
+}
+
+// ============================================================================
+// STRING UTILITIES
+// ============================================================================
+
+char* trim_whitespace(char* str) {
+    while (isspace((unsigned char)*str)) {
+        str++;
+    }
+    char* end = str + strlen(str);
+    while (end > str && isspace((unsigned char)end[-1])) {
+        end--;
+    }
+    *end = '\0';
+    return str;
+}
+
+// "1h 05m", "12m 30s" or "45s"; the buffer is reused by the next call
+const char* format_time_duration(int seconds) {
+    static char buffer[32];
+    seconds = seconds > 0 ? seconds : 0;
+    if (seconds >= 3600) {
+        snprintf(buffer, sizeof(buffer), "%dh %02dm", seconds / 3600, seconds / 60 % 60);
+    } else if (seconds >= 60) {
+        snprintf(buffer, sizeof(buffer), "%dm %02ds", seconds / 60, seconds % 60);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%ds", seconds);
+    }
+    return buffer;
+}
+
+// ============================================================================
+// FILE UTILITIES
+// ============================================================================
+
+int file_exists(const char* filename) {
+    struct stat info;
+    return stat(filename, &info) == 0;
+}
+
+int create_directory(const char* path) {
+    return mkdir(path, 0755) == 0 || file_exists(path);
+}
+
+// ============================================================================
+// DISPLAY
+// ============================================================================
+
+const char* get_topic_name(TopicIndex topic) {
+    if (topic < 0 || topic >= NUM_C_TOPICS) {
+        return "Unknown Topic";
+    }
+    return c_topic_names[topic];
+}
+
+// Question prose is only read from the text arena here, at render time
+void display_question(Question* question) {
+    TRACE_SCOPE(TRACE_DISPLAY_QUESTION);
+    printf("\n📝 Question #%d [%s | %s]\n", question->id,
+           get_topic_name(question_topic(question)),
+           difficulty_names[question_difficulty(question) - 1]);
+    printf("%s\n", text_get(question->question));
+    
+    if (text_length(question->code_snippet) > 0) {
+        printf("\n%s\n\n", text_get(question->code_snippet));
+    }
     
-    student->last_practice = time(
+    for (int i = 0; i < MAX_OPTIONS; i++) {
+        if (text_length(question->options[i]) > 0) {
+            printf("  %d. %s\n", i + 1, text_get(question->options[i]));
+        }
+    }
+}
+
+// Shows the question's hint_level-th hint (from 1). Past the last hint the
+// tutor rules out the wrong answer given, if any, and points to a related
+// question; without it, falls back to the topic.
+void provide_intelligent_hint(Question* question, int wrong_answer, int hint_level) {
+    char reply[TUTOR_REPLY_LENGTH];
+    if (hint_level >= 1 && hint_level <= MAX_HINTS && text_length(question->hints[hint_level - 1]) > 0) {
+        printf("💡 Hint %d: %s\n", hint_level, text_get(question->hints[hint_level - 1]));
+    } else if (tutor_start() > 0 && tutor_hint(question->id, wrong_answer, reply, sizeof(reply)) > 0) {
+        printf("💡 %s\n", reply);
+    } else if (wrong_answer >= 0 && wrong_answer < MAX_OPTIONS && wrong_answer != question->correct_answer) {
+        printf("💡 It is not option %d.\n", wrong_answer + 1);
+    } else {
+        printf("💡 No more hints. Think about what %s covers.\n", get_topic_name(question_topic(question)));
+    }
+}
@@ -0,0 +1,111 @@
+// test_exam_plan.c - Exam assembly for the C Programming Quiz System
+// Samples many exams from one plan: each must match the blueprint with no
+// repeats, and the alias tables must favour questions asked less often
+
+#include "test_support.h"
+
+#define TEST_SPARSE_POOL 40  // drawn through the alias table
+#define TEST_DENSE_POOL 5    // drawn by a partial shuffle
+#define TEST_EXAMS 3000
+
+int main(void) {
+    // Ids 0.. are the sparse cell, 100.. the dense one
+    for (int i = 0; i < TEST_SPARSE_POOL; i++) {
+        test_add_question(i, POINTERS, 2, "What does this pointer expression evaluate to?", "pointer");
+    }
+    for (int i = 0; i < TEST_DENSE_POOL; i++) {
+        test_add_question(100 + i, FILE_IO, 1, "Which mode does fopen need here?", "fopen");
+    }
+
+    // The first half of the sparse cell has been asked often already
+    for (int i = 0; i < TEST_SPARSE_POOL / 2; i++) {
+        Question* question = get_question_by_id(i);
+        for (int a = 0; a < 30; a++) {
+            record_question_attempt(question->slot, a % 2, 20.0f);
+        }
+    }
+
+    ExamBlueprint blueprint;
+    memset(&blueprint, 0, sizeof(blueprint));
+    blueprint.counts[POINTERS][1] = 3;
+    blueprint.counts[FILE_IO][0] = 3;
+    ExamPlan* plan = exam_plan_build(&blueprint);
+    CHECK(plan != NULL);
+    if (!plan) {
+        return test_finish("exam plan alias sampling");
+    }
+    CHECK(exam_plan_size(plan) == 6);
+
+    int drawn[TEST_SPARSE_POOL] = { 0 };
+    int dense_drawn[TEST_DENSE_POOL] = { 0 };
+    int shape_errors = 0;
+    uint64_t state = 12345;
+    for (int e = 0; e < TEST_EXAMS; e++) {
+        int ids[EXAM_MAX_QUESTIONS];
+        float seconds = 0.0f;
+        int count = exam_plan_sample(plan, &state, ids, &seconds);
+        if (count != 6 || seconds <= 0.0f) {
+            shape_errors++;
+            continue;
+        }
+        int sparse = 0;
+        int dense = 0;
+        for (int i = 0; i < count; i++) {
+            for (int j = 0; j < i; j++) {
+                shape_errors += ids[i] == ids[j];
+            }
+            if (ids[i] >= 0 && ids[i] < TEST_SPARSE_POOL) {
+                drawn[ids[i]]++;
+                sparse++;
+            } else if (ids[i] >= 100 && ids[i] < 100 + TEST_DENSE_POOL) {
+                dense_drawn[ids[i] - 100]++;
+                dense++;
+            }
+        }
+        shape_errors += sparse != 3 || dense != 3;
+    }
+    CHECK(shape_errors == 0);
+
+    // Weights are 1 / (1 + asked / typical): with 30 asks against a typical
+    // 16, a fresh question should come up about 2.9 times as often
+    long fresh = 0;
+    long stale = 0;
+    int never_drawn = 0;
+    for (int i = 0; i < TEST_SPARSE_POOL; i++) {
+        if (i < TEST_SPARSE_POOL / 2) {
+            stale += drawn[i];
+        } else {
+            fresh += drawn[i];
+        }
+        never_drawn += drawn[i] == 0;
+    }
+    CHECK(fresh + stale == 3L * TEST_EXAMS);
+    CHECK(never_drawn == 0);
+    CHECK(stale > 0 && fresh > 2.3 * stale && fresh < 3.5 * stale);
+
+    // The dense cell is unweighted: 3 of 5 each time, about 1800 apiece
+    for (int i = 0; i < TEST_DENSE_POOL; i++) {
+        CHECK(dense_drawn[i] > 1600 && dense_drawn[i] < 2000);
+    }
+
+    // The same state draws the same exam
+    int first[EXAM_MAX_QUESTIONS];
+    int second[EXAM_MAX_QUESTIONS];
+    uint64_t a = 99;
+    uint64_t b = 99;
+    exam_plan_sample(plan, &a, first, NULL);
+    exam_plan_sample(plan, &b, second, NULL);
+    CHECK(memcmp(first, second, 6 * sizeof(int)) == 0);
+
+    // A blueprint the bank cannot fill has no plan
+    ExamBlueprint too_big = blueprint;
+    too_big.counts[FILE_IO][0] = TEST_DENSE_POOL + 1;
+    CHECK(exam_plan_build(&too_big) == NULL);
+
+    // Reloading the bank retires the plan
+    question_store_reset();
+    CHECK(exam_plan_sample(plan, &state, first, NULL) == -1);
+    exam_plan_free(plan);
+
+    return test_finish("exam plan alias sampling");
+}
@@ -0,0 +1,162 @@
+// test_progress_log.c - Student progress log for the C Programming Quiz System
+// A child process answers questions and exits without a checkpoint, as if
+// it had crashed; reopening the log must replay every durable answer into
+// the registry and the practice-day bitmaps, ignoring a torn record at the
+// tail. After a clean close, a fresh process gets the practice days back
+// from the activity file.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "test_support.h"
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TEST_SNAPSHOT_FILE "data/test_progress.dat"
+#define TEST_LOG_FILE "data/test_progress.log"
+#define TEST_ACTIVITY_FILE "data/test_activity.dat"
+#define TEST_STUDENT_ID 4242
+#define TEST_ANSWERS 60
+
+static void build_bank(void) {
+    for (int i = 0; i < 24; i++) {
+        test_add_question(i, (TopicIndex)(i % NUM_C_TOPICS), i % MAX_DIFFICULTY + 1,
+                          "Which header declares malloc?", "malloc");
+    }
+}
+
+static int answer_is_correct(int i) {
+    return i % 3 != 0;
+}
+
+// Runs in the child: answers, makes them durable, reports the student
+static void answer_and_crash(int report_fd) {
+    build_bank();
+    if (open_student_progress(TEST_SNAPSHOT_FILE, TEST_LOG_FILE, NULL, TEST_ACTIVITY_FILE) != 0) {
+        _exit(2);
+    }
+    Student profile;
+    memset(&profile, 0, sizeof(profile));
+    snprintf(profile.name, sizeof(profile.name), "Grace Hopper");
+    profile.student_id = TEST_STUDENT_ID;
+    reset_student_progress(&profile);
+    profile.registration_date = 1700000000;
+    profile.last_practice = profile.registration_date;
+    Student* student = register_student(&profile);
+    if (!student) {
+        _exit(3);
+    }
+    for (int i = 0; i < TEST_ANSWERS; i++) {
+        update_student_stats(student, get_question_by_id(i % 24), answer_is_correct(i), 5.0f + (float)(i % 4));
+    }
+    if (!flush_student_progress()) {
+        _exit(4);
+    }
+    ssize_t written = write(report_fd, student, sizeof(Student));
+    _exit(written == (ssize_t)sizeof(Student) ? 0 : 5);
+}
+
+// Runs in a second child, after the log was checkpointed and emptied. The
+// fork copied this process's analytics, so they are dropped first.
+static void reopen_and_check_activity(void) {
+    reset_system_analytics();
+    if (open_student_progress(TEST_SNAPSHOT_FILE, TEST_LOG_FILE, NULL, TEST_ACTIVITY_FILE) != 1) {
+        _exit(2);
+    }
+    time_t now = time(NULL);
+    int ok = get_practice_streak(TEST_STUDENT_ID, now) == 1 && get_active_days(TEST_STUDENT_ID, now, 7) == 1 &&
+             count_active_students(now, 1) == 1;
+    _exit(ok ? 0 : 3);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    test_reset_file(TEST_SNAPSHOT_FILE);
+    test_reset_file(TEST_LOG_FILE);
+    test_reset_file(TEST_ACTIVITY_FILE);
+
+    int report[2];
+    CHECK(pipe(report) == 0);
+    pid_t child = fork();
+    CHECK(child >= 0);
+    if (child == 0) {
+        close(report[0]);
+        answer_and_crash(report[1]);
+    }
+    close(report[1]);
+    Student expected;
+    CHECK(read(report[0], &expected, sizeof(expected)) == (ssize_t)sizeof(expected));
+    close(report[0]);
+    int status = 0;
+    CHECK(waitpid(child, &status, 0) == child);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    if (test_failures > 0) {
+        return test_finish("progress log append and replay");
+    }
+
+    // Half a record, as a crash in the middle of a write leaves it
+    FILE* fp = fopen(TEST_LOG_FILE, "ab");
+    CHECK(fp != NULL);
+    if (fp) {
+        fwrite("\x01\x02\x03\x04\x05\x06\x07", 1, 7, fp);
+        fclose(fp);
+    }
+
+    build_bank();
+    GradedAnswer* answers = NULL;
+    int count = read_progress_log_answers(TEST_LOG_FILE, &answers);
+    CHECK(count == TEST_ANSWERS);
+    for (int i = 0; i < count && i < TEST_ANSWERS; i++) {
+        const Question* question = get_question_by_id(answers[i].question_id);
+        CHECK(answers[i].student_id == TEST_STUDENT_ID);
+        CHECK(answers[i].question_id == i % 24);
+        CHECK(question && (answers[i].answer == question->correct_answer) == answer_is_correct(i));
+        CHECK(answers[i].response_time == 5.0f + (float)(i % 4));
+    }
+    free(answers);
+
+    CHECK(open_student_progress(TEST_SNAPSHOT_FILE, TEST_LOG_FILE, NULL, TEST_ACTIVITY_FILE) == 1);
+    Student* replayed = find_student_by_id(TEST_STUDENT_ID);
+    CHECK(replayed != NULL);
+    if (replayed) {
+        CHECK(strcmp(replayed->name, expected.name) == 0);
+        CHECK(replayed->total_questions_attempted == TEST_ANSWERS);
+        CHECK(replayed->total_questions_attempted == expected.total_questions_attempted);
+        CHECK(replayed->total_questions_correct == expected.total_questions_correct);
+        CHECK(replayed->learning_streak == expected.learning_streak);
+        CHECK(replayed->max_streak == expected.max_streak);
+        for (int t = 0; t < NUM_C_TOPICS; t++) {
+            CHECK(replayed->topic_questions_attempted[t] == expected.topic_questions_attempted[t]);
+            CHECK(replayed->topic_questions_correct[t] == expected.topic_questions_correct[t]);
+            CHECK(replayed->topic_scores[t] == expected.topic_scores[t]);
+        }
+    }
+
+    // The child practised today, and nothing was checkpointed: replay alone
+    // restores the day
+    CHECK(get_practice_streak(TEST_STUDENT_ID, time(NULL)) == 1);
+    CHECK(get_active_days(TEST_STUDENT_ID, time(NULL), 30) == 1);
+
+    // The torn tail was cut off, so a new answer follows the last whole record
+    if (replayed) {
+        update_student_stats(replayed, get_question_by_id(0), 1, 3.0f);
+    }
+    CHECK(flush_student_progress());
+    count = read_progress_log_answers(TEST_LOG_FILE, &answers);
+    CHECK(count == TEST_ANSWERS + 1);
+    if (count == TEST_ANSWERS + 1) {
+        CHECK(answers[TEST_ANSWERS].question_id == 0 && answers[TEST_ANSWERS].response_time == 3.0f);
+    }
+    free(answers);
+    close_student_progress();
+    CHECK(file_exists(TEST_ACTIVITY_FILE));
+
+    child = fork();
+    CHECK(child >= 0);
+    if (child == 0) {
+        reopen_and_check_activity();
+    }
+    CHECK(waitpid(child, &status, 0) == child);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    return test_finish("progress log append and replay");
+}
@@ -0,0 +1,103 @@
+// test_question_file.c - questions.dat round trip for the C Programming Quiz System
+// Saves a bank, reloads it into an empty store and expects every question,
+// its text and its usage stats back unchanged
+
+#include "test_support.h"
+
+#define TEST_QUESTIONS_FILE "data/test_questions.dat"
+#define TEST_QUESTION_COUNT 300
+
+int main(void) {
+    test_reset_file(TEST_QUESTIONS_FILE);
+
+    // Every topic and difficulty, distinct text, sparse ids
+    char text[MAX_STRING];
+    for (int i = 0; i < TEST_QUESTION_COUNT; i++) {
+        snprintf(text, sizeof(text), "Question %d: what does pointer arithmetic on element %d do?", i, i * 7);
+        int id = test_add_question(10 + i * 3, (TopicIndex)(i % NUM_C_TOPICS), i % MAX_DIFFICULTY + 1, text,
+                                   i % 2 ? "pointer" : "array");
+        CHECK(id == 10 + i * 3);
+    }
+    for (int i = 0; i < TEST_QUESTION_COUNT; i += 5) {
+        record_question_attempt(i, i % 10 == 0, 4.0f + i % 7);
+    }
+
+    // Copies of what was saved, since the reload replaces the store
+    QuestionHotTable* hot = get_question_hot_table();
+    CHECK(hot->count == TEST_QUESTION_COUNT);
+    static Question saved[TEST_QUESTION_COUNT];
+    static char saved_text[TEST_QUESTION_COUNT][4][MAX_STRING];
+    int saved_asked[TEST_QUESTION_COUNT];
+    int saved_correct[TEST_QUESTION_COUNT];
+    for (int slot = 0; slot < TEST_QUESTION_COUNT; slot++) {
+        saved[slot] = *question_at(slot);
+        text_copy(saved[slot].question, saved_text[slot][0], MAX_STRING);
+        text_copy(saved[slot].options[1], saved_text[slot][1], MAX_STRING);
+        text_copy(saved[slot].explanation, saved_text[slot][2], MAX_STRING);
+        text_copy(saved[slot].keywords[0], saved_text[slot][3], MAX_STRING);
+        saved_asked[slot] = hot->times_asked[slot];
+        saved_correct[slot] = hot->times_correct[slot];
+    }
+
+    CHECK(save_questions_to_file(TEST_QUESTIONS_FILE));
+    CHECK(verify_question_file(TEST_QUESTIONS_FILE));
+
+    question_store_reset();
+    CHECK(get_total_questions() == 0);
+    CHECK(load_questions_from_file(TEST_QUESTIONS_FILE) == TEST_QUESTION_COUNT);
+
+    hot = get_question_hot_table();
+    CHECK(hot->count == TEST_QUESTION_COUNT);
+    for (int slot = 0; slot < TEST_QUESTION_COUNT && slot < hot->count; slot++) {
+        Question* loaded = get_question_by_id(saved[slot].id);
+        CHECK(loaded != NULL);
+        if (!loaded) {
+            continue;
+        }
+        CHECK(question_topic(loaded) == (TopicIndex)(slot % NUM_C_TOPICS));
+        CHECK(question_difficulty(loaded) == slot % MAX_DIFFICULTY + 1);
+        CHECK(loaded->correct_answer == saved[slot].correct_answer);
+        CHECK(loaded->type == saved[slot].type);
+        CHECK(loaded->date_created == saved[slot].date_created);
+
+        char buffer[MAX_STRING];
+        text_copy(loaded->question, buffer, sizeof(buffer));
+        CHECK(strcmp(buffer, saved_text[slot][0]) == 0);
+        text_copy(loaded->options[1], buffer, sizeof(buffer));
+        CHECK(strcmp(buffer, saved_text[slot][1]) == 0);
+        text_copy(loaded->explanation, buffer, sizeof(buffer));
+        CHECK(strcmp(buffer, saved_text[slot][2]) == 0);
+        text_copy(loaded->keywords[0], buffer, sizeof(buffer));
+        CHECK(strcmp(buffer, saved_text[slot][3]) == 0);
+        text_copy(loaded->hints[0], buffer, sizeof(buffer));
+        CHECK(strcmp(buffer, "Read the question twice") == 0);
+
+        CHECK(hot->times_asked[loaded->slot] == saved_asked[slot]);
+        CHECK(hot->times_correct[loaded->slot] == saved_correct[slot]);
+    }
+
+    // A flipped byte in the question text fails verification
+    FILE* fp = fopen(TEST_QUESTIONS_FILE, "r+b");
+    CHECK(fp != NULL);
+    if (fp) {
+        static char file[1 << 20];
+        size_t size = fread(file, 1, sizeof(file), fp);
+        const char* needle = "Question 150:";
+        size_t needle_length = strlen(needle);
+        long found = -1;
+        for (size_t i = 0; found < 0 && i + needle_length <= size; i++) {
+            if (memcmp(file + i, needle, needle_length) == 0) {
+                found = (long)i;
+            }
+        }
+        CHECK(found >= 0);
+        if (found >= 0) {
+            fseek(fp, found, SEEK_SET);
+            fputc('q', fp);
+        }
+        fclose(fp);
+    }
+    CHECK(!verify_question_file(TEST_QUESTIONS_FILE));
+
+    return test_finish("questions.dat round trip");
+}
@@ -0,0 +1,84 @@
+// test_rank_tree.c - Order-statistic rank trees for the C Programming Quiz System
+// Compares rank_tree_rank and rank_tree_top against a sorted copy of the
+// same scores after inserts, score changes in both directions and ties
+
+#include "test_support.h"
+
+#define TEST_IDS 2000
+
+static double scores[TEST_IDS];
+
+// Rank order: highest score first, then lowest id
+static int ranks_before(int a, int b) {
+    return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+}
+
+static int compare_ranked(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return ranks_before(x, y) ? -1 : ranks_before(y, x) ? 1 : 0;
+}
+
+static void check_against_sort(const RankTree* tree) {
+    static int order[TEST_IDS];
+    for (int i = 0; i < TEST_IDS; i++) {
+        order[i] = i;
+    }
+    qsort(order, TEST_IDS, sizeof(int), compare_ranked);
+
+    CHECK(rank_tree_size(tree) == TEST_IDS);
+    int rank_errors = 0;
+    for (int r = 0; r < TEST_IDS; r++) {
+        rank_errors += rank_tree_rank(tree, order[r]) != r + 1;
+    }
+    CHECK(rank_errors == 0);
+
+    int top[50];
+    float top_scores[50];
+    CHECK(rank_tree_top(tree, top, top_scores, 50) == 50);
+    for (int r = 0; r < 50; r++) {
+        CHECK(top[r] == order[r]);
+        CHECK(top_scores[r] == (float)scores[order[r]]);
+    }
+}
+
+int main(void) {
+    RankTree tree;
+    rank_tree_init(&tree);
+    CHECK(rank_tree_size(&tree) == 0);
+    CHECK(rank_tree_rank(&tree, 7) == 0);
+    CHECK(rank_tree_top(&tree, NULL, NULL, 10) == 0);
+
+    // Few distinct scores, so ties are common and broken by id
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (int id = 0; id < TEST_IDS; id++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        scores[id] = (double)((state >> 33) % 97);
+        rank_tree_set(&tree, id, scores[id]);
+    }
+    check_against_sort(&tree);
+
+    // Moves up and down, and setting the same score again
+    for (int i = 0; i < TEST_IDS * 3; i++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        int id = (int)((state >> 33) % TEST_IDS);
+        scores[id] = (double)((state >> 45) % 97) + (i % 2 ? 0.5 : 0.0);
+        rank_tree_set(&tree, id, scores[id]);
+        rank_tree_set(&tree, id, scores[id]);
+    }
+    check_against_sort(&tree);
+
+    // A new leader and a new last place
+    scores[123] = 1000.0;
+    rank_tree_set(&tree, 123, scores[123]);
+    scores[0] = -1.0;
+    rank_tree_set(&tree, 0, scores[0]);
+    CHECK(rank_tree_rank(&tree, 123) == 1);
+    CHECK(rank_tree_rank(&tree, 0) == TEST_IDS);
+    int leader;
+    CHECK(rank_tree_top(&tree, &leader, NULL, 1) == 1 && leader == 123);
+    check_against_sort(&tree);
+
+    rank_tree_free(&tree);
+    return test_finish("rank tree rank and top");
+}
@@ -0,0 +1,66 @@
+// test_recommend.c - Question recommendations for the C Programming Quiz System
+// A student keeps missing a topic with only a few questions; the recommender
+// must move on to other material rather than serve a question just answered
+
+#include "test_support.h"
+
+#define TEST_WEAK_POOL 3   // fewer questions than the recent-answer window
+#define TEST_WINDOW 8      // RECENT_QUESTIONS in quiz_recommend.c
+#define TEST_PICKS 40
+
+int main(void) {
+    for (int i = 0; i < TEST_WEAK_POOL; i++) {
+        test_add_question(i, POINTERS, 1, "What does this pointer expression evaluate to?", "pointer");
+    }
+    int id = 100;
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        for (int d = 1; d <= MAX_DIFFICULTY && t != POINTERS; d++) {
+            test_add_question(id++, (TopicIndex)t, d, "Which header declares malloc?", "malloc");
+        }
+    }
+
+    Student profile;
+    memset(&profile, 0, sizeof(profile));
+    snprintf(profile.name, sizeof(profile.name), "Ken Thompson");
+    profile.student_id = 7;
+    reset_student_progress(&profile);
+    // Strong and well practised everywhere but pointers
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        profile.topic_scores[t] = 0.95f;
+        profile.topic_questions_attempted[t] = 100;
+        profile.topic_questions_correct[t] = 95;
+    }
+    profile.topic_scores[POINTERS] = 0.0f;
+    profile.topic_questions_attempted[POINTERS] = 0;
+    profile.topic_questions_correct[POINTERS] = 0;
+    Student* student = register_student(&profile);
+    CHECK(student != NULL);
+    if (!student) {
+        return test_finish("recommendations skip recent questions");
+    }
+
+    // Every answer is wrong, so the small topic stays the weakest
+    int served[TEST_PICKS];
+    int repeats = 0;
+    int weak_served = 0;
+    for (int p = 0; p < TEST_PICKS; p++) {
+        AIRecommendation rec = get_ai_recommendation(student);
+        CHECK(rec.recommended_question != NULL);
+        if (!rec.recommended_question) {
+            break;
+        }
+        Question* question = rec.recommended_question;
+        served[p] = question->id;
+        for (int back = 1; back <= TEST_WINDOW && back <= p; back++) {
+            repeats += served[p - back] == served[p];
+        }
+        weak_served += question_topic(question) == POINTERS;
+        update_student_stats(student, question, 0, 5.0f);
+    }
+    CHECK(repeats == 0);
+
+    // It still comes back to the weak topic once its questions age out
+    CHECK(weak_served >= TEST_WEAK_POOL * 2);
+
+    return test_finish("recommendations skip recent questions");
+}
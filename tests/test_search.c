@@ -0,0 +1,88 @@
+// test_search.c - Full-text search for the C Programming Quiz System
+// Checks which questions multi-term AND and OR queries and prefixes match,
+// and that keyword matches outrank mentions in the question text
+
+#include "test_support.h"
+
+static int hit_ids_equal(const SearchHit* hits, int count, const int* ids, int id_count) {
+    if (count != id_count) {
+        return 0;
+    }
+    for (int i = 0; i < id_count; i++) {
+        int found = 0;
+        for (int h = 0; h < count; h++) {
+            found |= hits[h].question_id == ids[i];
+        }
+        if (!found) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(void) {
+    test_add_question(1, POINTERS, 2, "What does dereferencing a null pointer do?", "pointer");
+    test_add_question(2, ARRAYS_STRINGS, 2, "How does an array decay into a pointer?", "array");
+    test_add_question(3, ARRAYS_STRINGS, 1, "What is the size of an array of ten ints?", "array");
+    test_add_question(4, MEMORY_MANAGEMENT, 3, "When must memory from malloc be freed?", "malloc");
+    test_add_question(5, POINTERS, 4, "Can a pointer to pointer point to itself?", "indirection");
+
+    SearchHit hits[16];
+
+    // AND: every term must match, in any field
+    int total = search_questions("array pointer", SEARCH_ALL, hits, 16);
+    CHECK(total == 1);
+    CHECK(hits[0].question_id == 2);
+
+    // OR: any term matches
+    total = search_questions("array malloc", SEARCH_ANY, hits, 16);
+    int any[] = { 2, 3, 4 };
+    CHECK(total == 3);
+    CHECK(hit_ids_equal(hits, total, any, 3));
+
+    // Single term, ranked: a keyword outweighs a mention in the text
+    total = search_questions("pointer", SEARCH_ALL, hits, 16);
+    int pointer[] = { 1, 2, 5 };
+    CHECK(total == 3);
+    CHECK(hit_ids_equal(hits, total, pointer, 3));
+    CHECK(hits[0].question_id == 1);
+    for (int i = 1; i < total; i++) {
+        CHECK(hits[i - 1].score >= hits[i].score);
+    }
+
+    // The buffer holds the best max_hits; the total still counts them all
+    SearchHit best;
+    CHECK(search_questions("pointer", SEARCH_ALL, &best, 1) == 3);
+    CHECK(best.question_id == 1);
+
+    // A trailing '*' matches every term with that prefix
+    total = search_questions("mall*", SEARCH_ALL, hits, 16);
+    CHECK(total == 1 && hits[0].question_id == 4);
+    total = search_questions("point* decay", SEARCH_ALL, hits, 16);
+    CHECK(total == 1 && hits[0].question_id == 2);
+
+    // Words too short to index do not make an AND query fail
+    CHECK(search_questions("a pointer", SEARCH_ALL, hits, 16) == 3);
+    CHECK(search_questions("a", SEARCH_ALL, hits, 16) == 0);
+
+    // Case folds; unknown terms match nothing under AND
+    CHECK(search_questions("MALLOC", SEARCH_ALL, hits, 16) == 1);
+    CHECK(search_questions("pointer zebra", SEARCH_ALL, hits, 16) == 0);
+    CHECK(search_questions("pointer zebra", SEARCH_ANY, hits, 16) == 3);
+
+    // The array form returns the same ranking
+    int count = 0;
+    Question** found = search_questions_by_keyword("pointer", &count);
+    CHECK(count == 3 && found != NULL);
+    total = search_questions("pointer", SEARCH_ALL, hits, 16);
+    for (int i = 0; found && i < count && i < total; i++) {
+        CHECK(found[i]->id == hits[i].question_id);
+    }
+    free(found);
+
+    // Questions added later are found without a rebuild
+    test_add_question(6, POINTERS, 1, "Is a void pointer arithmetic legal?", "pointer");
+    CHECK(search_questions("pointer", SEARCH_ALL, hits, 16) == 4);
+
+    return test_finish("search AND/OR queries");
+}
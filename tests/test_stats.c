@@ -0,0 +1,167 @@
+// test_stats.c - Batch statistics for the C Programming Quiz System
+// Checks the block kernels against a two-pass reference, the threaded
+// split-and-merge against the serial result, and that the cohort fit
+// fills predicted_exam_score for an export
+
+#include "test_support.h"
+
+#define TEST_MIN_PER_THREAD 65536 // STATS_MIN_PER_THREAD in quiz_stats.c
+#define TEST_VALUES (3 * TEST_MIN_PER_THREAD + 1234)
+#define TEST_SMALL 5000
+#define TEST_STUDENTS 40
+#define TEST_EXPORT_FILE "data/test_cohort.csv"
+
+static float xs[TEST_VALUES];
+static float ys[TEST_VALUES];
+
+static int close_to(double actual, double expected, double tolerance) {
+    return fabs(actual - expected) <= tolerance * (fabs(expected) > 1.0 ? fabs(expected) : 1.0);
+}
+
+// Textbook two passes in double: means first, then deviations
+static void two_pass(const float* x, const float* y, int count, PairedStats* out) {
+    double sum_x = 0.0;
+    double sum_y = 0.0;
+    for (int i = 0; i < count; i++) {
+        sum_x += x[i];
+        sum_y += y[i];
+    }
+    paired_stats_init(out);
+    out->count = (uint64_t)count;
+    out->mean_x = sum_x / count;
+    out->mean_y = sum_y / count;
+    for (int i = 0; i < count; i++) {
+        double dx = x[i] - out->mean_x;
+        double dy = y[i] - out->mean_y;
+        out->m2_x += dx * dx;
+        out->m2_y += dy * dy;
+        out->c_xy += dx * dy;
+    }
+}
+
+static void check_paired(const PairedStats* actual, const PairedStats* expected, double tolerance) {
+    CHECK(actual->count == expected->count);
+    CHECK(close_to(actual->mean_x, expected->mean_x, tolerance));
+    CHECK(close_to(actual->mean_y, expected->mean_y, tolerance));
+    CHECK(close_to(actual->m2_x, expected->m2_x, tolerance));
+    CHECK(close_to(actual->m2_y, expected->m2_y, tolerance));
+    CHECK(close_to(actual->c_xy, expected->c_xy, tolerance));
+}
+
+static void check_kernels(void) {
+    // A large offset, so a naive sum of squares would cancel badly
+    uint64_t state = 42;
+    for (int i = 0; i < TEST_VALUES; i++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        float noise = (float)((state >> 40) % 1000) / 100.0f;
+        xs[i] = 10000.0f + noise;
+        ys[i] = 0.5f * xs[i] + (float)((state >> 20) % 100) / 50.0f;
+    }
+
+    PairedStats reference;
+    two_pass(xs, ys, TEST_VALUES, &reference);
+
+    RunningStats single;
+    running_stats_init(&single);
+    stats_accumulate(&single, xs, TEST_VALUES);
+    CHECK(single.count == (uint64_t)TEST_VALUES);
+    CHECK(close_to(single.mean, reference.mean_x, 1e-12));
+    CHECK(close_to(single.m2, reference.m2_x, 1e-9));
+    CHECK(close_to(calculate_standard_deviation(xs, TEST_VALUES), sqrt(reference.m2_x / TEST_VALUES), 1e-6));
+
+    PairedStats paired;
+    paired_stats_init(&paired);
+    stats_accumulate_paired(&paired, xs, ys, TEST_VALUES);
+    check_paired(&paired, &reference, 1e-9);
+
+    // Pushing one pair at a time takes the same path as the merges
+    PairedStats pushed;
+    paired_stats_init(&pushed);
+    for (int i = 0; i < TEST_VALUES; i++) {
+        paired_stats_push(&pushed, xs[i], ys[i]);
+    }
+    check_paired(&pushed, &reference, 1e-9);
+
+    double slope, intercept;
+    paired_stats_fit(&paired, &slope, &intercept);
+    CHECK(close_to(slope, reference.c_xy / reference.m2_x, 1e-9));
+    CHECK(close_to(intercept, reference.mean_y - slope * reference.mean_x, 1e-9));
+
+    // Split across threads and merged, the result matches the serial one
+    for (int threads = 2; threads <= 8; threads *= 2) {
+        RunningStats parallel;
+        running_stats_init(&parallel);
+        stats_accumulate_parallel(&parallel, xs, TEST_VALUES, threads);
+        CHECK(parallel.count == single.count);
+        CHECK(close_to(parallel.mean, single.mean, 1e-12));
+        CHECK(close_to(parallel.m2, single.m2, 1e-9));
+
+        PairedStats paired_parallel;
+        paired_stats_init(&paired_parallel);
+        stats_accumulate_paired_parallel(&paired_parallel, xs, ys, TEST_VALUES, threads);
+        check_paired(&paired_parallel, &paired, 1e-9);
+    }
+
+    // Too few values to split: the serial path runs, bit for bit
+    RunningStats small_serial;
+    RunningStats small_parallel;
+    running_stats_init(&small_serial);
+    running_stats_init(&small_parallel);
+    stats_accumulate(&small_serial, xs, TEST_SMALL);
+    stats_accumulate_parallel(&small_parallel, xs, TEST_SMALL, 8);
+    CHECK(memcmp(&small_serial, &small_parallel, sizeof(RunningStats)) == 0);
+
+    PairedStats small_reference;
+    two_pass(xs, ys, TEST_SMALL, &small_reference);
+    PairedStats small_paired;
+    paired_stats_init(&small_paired);
+    stats_accumulate_paired_parallel(&small_paired, xs, ys, TEST_SMALL, 8);
+    check_paired(&small_paired, &small_reference, 1e-9);
+}
+
+// Students whose topic accuracy tracks their overall accuracy
+static void check_cohort_prediction(void) {
+    for (int s = 0; s < TEST_STUDENTS; s++) {
+        Student profile;
+        memset(&profile, 0, sizeof(profile));
+        snprintf(profile.name, sizeof(profile.name), "Student %d", s);
+        profile.student_id = 1000 + s;
+        reset_student_progress(&profile);
+        for (int t = 0; t < NUM_C_TOPICS; t++) {
+            profile.topic_questions_attempted[t] = 20;
+            profile.topic_questions_correct[t] = s * 20 / TEST_STUDENTS;
+            profile.total_questions_attempted += 20;
+            profile.total_questions_correct += profile.topic_questions_correct[t];
+        }
+        profile.overall_accuracy = (float)profile.total_questions_correct / profile.total_questions_attempted;
+        CHECK(register_student(&profile) != NULL);
+    }
+
+    // The export refits the model before writing, so no row keeps the default
+    test_reset_file(TEST_EXPORT_FILE);
+    CohortExportOptions options = { REPORT_FORMAT_CSV, 2 };
+    CohortExportStats export_stats;
+    CHECK(export_cohort_report(TEST_EXPORT_FILE, &options, &export_stats) >= 0);
+    CHECK(export_stats.students == TEST_STUDENTS);
+
+    Student* weakest = find_student_by_id(1000);
+    Student* strongest = find_student_by_id(1000 + TEST_STUDENTS - 1);
+    CHECK(weakest && strongest);
+    if (weakest && strongest) {
+        CHECK(weakest->predicted_exam_score < 5.0f);
+        CHECK(strongest->predicted_exam_score > 90.0f);
+    }
+    int ordered = 1;
+    for (int s = 1; s < TEST_STUDENTS; s++) {
+        Student* previous = find_student_by_id(1000 + s - 1);
+        Student* student = find_student_by_id(1000 + s);
+        ordered &= previous && student && previous->predicted_exam_score <= student->predicted_exam_score;
+    }
+    CHECK(ordered);
+}
+
+int main(void) {
+    check_kernels();
+    check_cohort_prediction();
+    return test_finish("statistics kernels and cohort fit");
+}
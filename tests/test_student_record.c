@@ -0,0 +1,92 @@
+// test_student_record.c - Student record encoding for the C Programming Quiz System
+// encode_student_record and decode_student_record must round-trip every
+// field, stay within STUDENT_RECORD_MAX_BYTES and refuse truncated input
+
+#include "test_support.h"
+
+static void check_same_student(const Student* expected, const Student* actual) {
+    CHECK(strcmp(expected->name, actual->name) == 0);
+    CHECK(expected->student_id == actual->student_id);
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        CHECK(expected->topic_scores[t] == actual->topic_scores[t]);
+        CHECK(expected->topic_questions_attempted[t] == actual->topic_questions_attempted[t]);
+        CHECK(expected->topic_questions_correct[t] == actual->topic_questions_correct[t]);
+    }
+    CHECK(expected->total_questions_attempted == actual->total_questions_attempted);
+    CHECK(expected->total_questions_correct == actual->total_questions_correct);
+    CHECK(expected->overall_accuracy == actual->overall_accuracy);
+    CHECK(expected->learning_streak == actual->learning_streak);
+    CHECK(expected->max_streak == actual->max_streak);
+    CHECK(expected->last_practice == actual->last_practice);
+    CHECK(expected->registration_date == actual->registration_date);
+    CHECK(expected->total_study_time == actual->total_study_time);
+    CHECK(expected->current_level == actual->current_level);
+    CHECK(expected->predicted_exam_score == actual->predicted_exam_score);
+    CHECK(expected->interview_ready_score == actual->interview_ready_score);
+    CHECK(expected->achievements == actual->achievements);
+    CHECK(expected->learning_velocity == actual->learning_velocity);
+}
+
+static void check_round_trip(const Student* student) {
+    uint8_t record[STUDENT_RECORD_MAX_BYTES];
+    size_t length = encode_student_record(student, record);
+    CHECK(length > 0 && length <= STUDENT_RECORD_MAX_BYTES);
+
+    Student decoded;
+    CHECK(decode_student_record(record, length, &decoded) == length);
+    check_same_student(student, &decoded);
+
+    // Every proper prefix is incomplete
+    for (size_t cut = 0; cut < length; cut++) {
+        CHECK(decode_student_record(record, cut, &decoded) == 0);
+    }
+}
+
+int main(void) {
+    // A fresh profile: mostly zeros, the smallest encoding
+    Student fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    snprintf(fresh.name, sizeof(fresh.name), "Ada");
+    fresh.student_id = 1001;
+    fresh.current_level = BEGINNER;
+    fresh.registration_date = 1700000000;
+    fresh.last_practice = 1700000000;
+    check_round_trip(&fresh);
+
+    // Every field set, large counters, negative and extreme values
+    Student busy;
+    memset(&busy, 0, sizeof(busy));
+    memset(busy.name, 'x', sizeof(busy.name) - 1);
+    busy.student_id = INT32_MAX;
+    for (int t = 0; t < NUM_C_TOPICS; t++) {
+        busy.topic_scores[t] = 0.01f * (float)(t * 7 + 3);
+        busy.topic_questions_attempted[t] = 1000000 + t * 12345;
+        busy.topic_questions_correct[t] = 500000 + t * 999;
+    }
+    busy.total_questions_attempted = INT32_MAX;
+    busy.total_questions_correct = 2000000000;
+    busy.overall_accuracy = 0.8125f;
+    busy.learning_streak = 4095;
+    busy.max_streak = 65536;
+    busy.last_practice = (time_t)4102444800; // 2100-01-01
+    busy.registration_date = (time_t)-86400;
+    busy.total_study_time = 1 << 30;
+    busy.current_level = EXPERT;
+    busy.predicted_exam_score = 97.5f;
+    busy.interview_ready_score = 100;
+    busy.achievements = (1u << NUM_ACHIEVEMENTS) - 1;
+    busy.learning_velocity = -3.25f;
+    check_round_trip(&busy);
+
+    // Records are self-delimiting: two back to back decode one at a time
+    uint8_t pair[2 * STUDENT_RECORD_MAX_BYTES];
+    size_t first = encode_student_record(&busy, pair);
+    size_t second = encode_student_record(&fresh, pair + first);
+    Student decoded;
+    CHECK(decode_student_record(pair, first + second, &decoded) == first);
+    check_same_student(&busy, &decoded);
+    CHECK(decode_student_record(pair + first, second, &decoded) == second);
+    check_same_student(&fresh, &decoded);
+
+    return test_finish("student record encoding");
+}
@@ -0,0 +1,64 @@
+// test_support.h - Shared checks for the C Programming Quiz System tests
+// Every test is its own program that ctest runs in a scratch directory.
+// A failed CHECK reports where it failed and the test carries on, so one
+// run shows every broken expectation; test_finish sets the exit status.
+
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include "quiz_system.h"
+
+static int test_checks = 0;
+static int test_failures = 0;
+
+#define CHECK(condition)                                                         \
+    do {                                                                         \
+        test_checks++;                                                           \
+        if (!(condition)) {                                                      \
+            printf("❌ %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            test_failures++;                                                     \
+        }                                                                        \
+    } while (0)
+
+// Makes sure data/ exists and path does not, whatever an earlier run left
+static inline void test_reset_file(const char* path) {
+    if (!file_exists("data")) {
+        create_directory("data");
+    }
+    remove(path);
+}
+
+// A question with every text field filled, so round trips cover them all
+static inline int test_add_question(int id, TopicIndex topic, int difficulty, const char* question,
+                                    const char* keyword) {
+    QuestionDraft draft;
+    memset(&draft, 0, sizeof(draft));
+    draft.id = id;
+    draft.question = question;
+    draft.options[0] = "The first option";
+    draft.options[1] = "The second option";
+    draft.options[2] = "The third option";
+    draft.options[3] = "The fourth option";
+    draft.correct_answer = id >= 0 ? id % MAX_OPTIONS : 0;
+    draft.explanation = "Because the standard says so";
+    draft.code_snippet = "int x = 0;";
+    draft.difficulty = difficulty;
+    draft.topic = topic;
+    draft.type = MULTIPLE_CHOICE;
+    draft.hints[0] = "Read the question twice";
+    draft.keywords[0] = keyword;
+    draft.author = "tests";
+    draft.date_created = 1700000000;
+    return add_question(&draft);
+}
+
+static inline int test_finish(const char* name) {
+    if (test_failures > 0) {
+        printf("❌ %s: %d of %d checks failed\n", name, test_failures, test_checks);
+        return 1;
+    }
+    printf("✅ %s: %d checks passed\n", name, test_checks);
+    return 0;
+}
+
+#endif
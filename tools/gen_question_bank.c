@@ -0,0 +1,479 @@
+// gen_question_bank.c - Question bank generator for the C Programming Quiz System
+// Compiles a declarative bank (questions/default_bank.def) into a C source
+// file of const Question records, hot-table columns and a text arena pool,
+// which the question store attaches in place at startup
+//
+// Usage: gen_question_bank <input.def> <output.c>
+
+#include "quiz_system.h"
+
+// ============================================================================
+// PARSED QUESTIONS
+// ============================================================================
+
+#define GEN_MAX_LINE 4096
+
+typedef struct {
+    int id;
+    int line; // where the [question] header was, for messages
+    int topic;
+    int difficulty;
+    int type;
+    int answer;
+    char* question;
+    char* code;
+    char* options[MAX_OPTIONS];
+    int option_count;
+    char* explanation;
+    char* hints[MAX_HINTS];
+    int hint_count;
+    char* keywords[MAX_KEYWORDS];
+    int keyword_count;
+    char* author;
+} GenQuestion;
+
+static const char* topic_names[NUM_C_TOPICS] = {
+    "C_BASICS", "VARIABLES_DATATYPES", "OPERATORS_EXPRESSIONS", "CONTROL_STRUCTURES",
+    "FUNCTIONS", "ARRAYS_STRINGS", "POINTERS", "STRUCTURES_UNIONS",
+    "FILE_IO", "MEMORY_MANAGEMENT", "PREPROCESSOR", "ADVANCED_C"
+};
+
+#define NUM_QUESTION_TYPES 7
+static const char* type_names[NUM_QUESTION_TYPES] = {
+    "MULTIPLE_CHOICE", "CODE_OUTPUT", "FILL_BLANK", "DEBUG_CODE",
+    "TRUE_FALSE", "CODE_COMPLETION", "ALGORITHM_TRACE"
+};
+
+static const char* input_path;
+static int line_number;
+
+static void fail(const char* message, const char* detail) {
+    fprintf(stderr, "%s:%d: %s%s%s\n", input_path, line_number, message, detail ? ": " : "", detail ? detail : "");
+    exit(1);
+}
+
+static char* copy_text(const char* text) {
+    char* copy = malloc(strlen(text) + 1);
+    if (!copy) {
+        fail("out of memory", NULL);
+    }
+    return strcpy(copy, text);
+}
+
+static int lookup_name(const char* const* names, int count, const char* value) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(names[i], value) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int parse_number(const char* value, int low, int high) {
+    char* end;
+    long number = strtol(value, &end, 10);
+    if (end == value || *end != '\0' || number < low || number > high) {
+        fail("expected a number in range", value);
+    }
+    return (int)number;
+}
+
+static void append_code_line(GenQuestion* q, const char* value) {
+    size_t old_length = q->code ? strlen(q->code) : 0;
+    char* code = realloc(q->code, old_length + strlen(value) + 2);
+    if (!code) {
+        fail("out of memory", NULL);
+    }
+    if (q->code) {
+        code[old_length++] = '\n';
+    }
+    strcpy(code + old_length, value);
+    q->code = code;
+}
+
+static void set_field(GenQuestion* q, const char* key, const char* value) {
+    if (strcmp(key, "id") == 0) {
+        q->id = parse_number(value, 0, INT32_MAX);
+    } else if (strcmp(key, "topic") == 0) {
+        if ((q->topic = lookup_name(topic_names, NUM_C_TOPICS, value)) < 0) {
+            fail("unknown topic", value);
+        }
+    } else if (strcmp(key, "difficulty") == 0) {
+        q->difficulty = parse_number(value, 1, MAX_DIFFICULTY);
+    } else if (strcmp(key, "type") == 0) {
+        if ((q->type = lookup_name(type_names, NUM_QUESTION_TYPES, value)) < 0) {
+            fail("unknown question type", value);
+        }
+    } else if (strcmp(key, "answer") == 0) {
+        q->answer = parse_number(value, 0, MAX_OPTIONS - 1);
+    } else if (strcmp(key, "question") == 0) {
+        q->question = copy_text(value);
+    } else if (strcmp(key, "code") == 0) {
+        append_code_line(q, value);
+    } else if (strcmp(key, "option") == 0) {
+        if (q->option_count == MAX_OPTIONS) {
+            fail("too many options", NULL);
+        }
+        q->options[q->option_count++] = copy_text(value);
+    } else if (strcmp(key, "explanation") == 0) {
+        q->explanation = copy_text(value);
+    } else if (strcmp(key, "hint") == 0) {
+        if (q->hint_count == MAX_HINTS) {
+            fail("too many hints", NULL);
+        }
+        q->hints[q->hint_count++] = copy_text(value);
+    } else if (strcmp(key, "keyword") == 0) {
+        if (q->keyword_count == MAX_KEYWORDS) {
+            fail("too many keywords", NULL);
+        }
+        q->keywords[q->keyword_count++] = copy_text(value);
+    } else if (strcmp(key, "author") == 0) {
+        q->author = copy_text(value);
+    } else {
+        fail("unknown key", key);
+    }
+}
+
+// The same checks add_question applies through validate_question, so a bad
+// entry fails the build instead of being dropped at startup
+static void check_question(const GenQuestion* q) {
+    line_number = q->line;
+    if (!q->question || q->question[0] == '\0') {
+        fail("question has no text", NULL);
+    }
+    if (q->topic < 0 || q->difficulty < 1 || q->type < 0 || q->answer < 0) {
+        fail("question needs topic, difficulty, type and answer", NULL);
+    }
+    if (q->answer >= q->option_count) {
+        fail("answer refers to a missing option", NULL);
+    }
+    if (q->code && strlen(q->code) >= MAX_CODE_LENGTH) {
+        fail("code snippet too long", NULL);
+    }
+}
+
+static GenQuestion* parse_bank(FILE* fp, int* count) {
+    GenQuestion* questions = NULL;
+    int capacity = 0;
+    char line[GEN_MAX_LINE];
+    *count = 0;
+
+    while (fgets(line, sizeof(line), fp)) {
+        line_number++;
+        size_t length = strlen(line);
+        if (length > 0 && line[length - 1] != '\n' && !feof(fp)) {
+            fail("line too long", NULL);
+        }
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+            line[--length] = '\0';
+        }
+        if (length == 0 || line[0] == '#') {
+            continue;
+        }
+
+        if (strcmp(line, "[question]") == 0) {
+            if (*count == capacity) {
+                capacity = capacity ? capacity * 2 : 64;
+                questions = realloc(questions, capacity * sizeof(GenQuestion));
+                if (!questions) {
+                    fail("out of memory", NULL);
+                }
+            }
+            GenQuestion* q = &questions[(*count)++];
+            memset(q, 0, sizeof(GenQuestion));
+            q->id = -1;
+            q->line = line_number;
+            q->topic = q->type = q->answer = -1;
+            continue;
+        }
+
+        // "key = value": the value is everything after "= ", verbatim
+        char* equals = strstr(line, " =");
+        if (!equals || *count == 0) {
+            fail(*count == 0 ? "field outside a [question]" : "expected key = value", line);
+        }
+        *equals = '\0';
+        char* value = equals + 2;
+        if (*value == ' ') {
+            value++;
+        }
+        set_field(&questions[*count - 1], line, value);
+    }
+    return questions;
+}
+
+static void free_bank(GenQuestion* questions, int count) {
+    for (int i = 0; i < count; i++) {
+        GenQuestion* q = &questions[i];
+        free(q->question);
+        free(q->code);
+        free(q->explanation);
+        free(q->author);
+        for (int k = 0; k < q->option_count; k++) {
+            free(q->options[k]);
+        }
+        for (int k = 0; k < q->hint_count; k++) {
+            free(q->hints[k]);
+        }
+        for (int k = 0; k < q->keyword_count; k++) {
+            free(q->keywords[k]);
+        }
+    }
+    free(questions);
+}
+
+// ============================================================================
+// TEXT POOL
+// ============================================================================
+
+// Same entry layout as the runtime text arena: a 4-byte length, the bytes,
+// a NUL, padded to 4 bytes. Offset 0 is the empty string.
+typedef struct {
+    char* data;
+    uint32_t size;
+    uint32_t capacity;
+} GenPool;
+
+static uint32_t pool_entry_size(uint32_t length) {
+    return (uint32_t)(sizeof(uint32_t) + length + 1 + 3) & ~3u;
+}
+
+static TextRef pool_find(const GenPool* pool, const char* text, uint32_t length) {
+    for (uint32_t ref = pool_entry_size(0); ref < pool->size;) {
+        uint32_t entry_length;
+        memcpy(&entry_length, pool->data + ref, sizeof(uint32_t));
+        if (entry_length == length && memcmp(pool->data + ref + sizeof(uint32_t), text, length) == 0) {
+            return ref;
+        }
+        ref += pool_entry_size(entry_length);
+    }
+    return TEXT_REF_EMPTY;
+}
+
+// A bank is a few hundred strings, so a linear search keeps this simple
+static TextRef pool_intern(GenPool* pool, const char* text) {
+    if (!text || text[0] == '\0') {
+        return TEXT_REF_EMPTY;
+    }
+    uint32_t length = (uint32_t)strlen(text);
+    TextRef ref = pool_find(pool, text, length);
+    if (ref != TEXT_REF_EMPTY) {
+        return ref;
+    }
+
+    uint32_t entry_size = pool_entry_size(length);
+    if (pool->size + entry_size > pool->capacity) {
+        pool->capacity = (pool->size + entry_size) * 2;
+        pool->data = realloc(pool->data, pool->capacity);
+        if (!pool->data) {
+            fail("out of memory", NULL);
+        }
+    }
+    ref = pool->size;
+    memset(pool->data + ref, 0, entry_size);
+    memcpy(pool->data + ref, &length, sizeof(uint32_t));
+    memcpy(pool->data + ref + sizeof(uint32_t), text, length);
+    pool->size += entry_size;
+    return ref;
+}
+
+// ============================================================================
+// OUTPUT
+// ============================================================================
+
+static void write_escaped(FILE* out, const char* bytes, uint32_t length) {
+    // Octal escapes are always three digits so a following digit is safe
+    for (uint32_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)bytes[i];
+        if (c == '"' || c == '\\') {
+            fprintf(out, "\\%c", c);
+        } else if (c == '?') {
+            fputs("\\?", out); // no accidental trigraphs
+        } else if (c == '\n') {
+            fputs("\\n", out);
+        } else if (c < 0x20 || c >= 0x7f) {
+            fprintf(out, "\\%03o", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+}
+
+static void write_pool(FILE* out, const GenPool* pool) {
+    fprintf(out, "static const char pool[] =\n");
+    for (uint32_t ref = 0; ref < pool->size;) {
+        uint32_t length;
+        memcpy(&length, pool->data + ref, sizeof(uint32_t));
+        uint32_t entry_size = pool_entry_size(length);
+        fprintf(out, "    /* %5u */ \"", ref);
+        for (size_t i = 0; i < sizeof(uint32_t); i++) {
+            fprintf(out, "\\%03o", (unsigned char)pool->data[ref + i]);
+        }
+        fputs("\" \"", out);
+        write_escaped(out, pool->data + ref + sizeof(uint32_t), entry_size - sizeof(uint32_t));
+        fputs("\"\n", out);
+        ref += entry_size;
+    }
+    fprintf(out, "    ;\n\n");
+}
+
+static void write_refs(FILE* out, const char* field, const TextRef* refs, int count) {
+    int used = 0;
+    for (int i = 0; i < count; i++) {
+        if (refs[i] != TEXT_REF_EMPTY) {
+            used = i + 1;
+        }
+    }
+    if (used == 0) {
+        return;
+    }
+    fprintf(out, "        .%s = {", field);
+    for (int i = 0; i < used; i++) {
+        fprintf(out, "%s%u", i ? ", " : " ", refs[i]);
+    }
+    fprintf(out, " },\n");
+}
+
+static const char* column_separator(int index) {
+    return index == 0 ? "\n    " : index % 16 ? ", " : ",\n    ";
+}
+
+typedef struct {
+    TextRef question;
+    TextRef options[MAX_OPTIONS];
+    TextRef explanation;
+    TextRef code;
+    TextRef hints[MAX_HINTS];
+    TextRef keywords[MAX_KEYWORDS];
+    TextRef author;
+} GenRefs;
+
+static void intern_question(GenPool* pool, const GenQuestion* q, GenRefs* refs) {
+    memset(refs, 0, sizeof(GenRefs));
+    refs->question = pool_intern(pool, q->question);
+    for (int k = 0; k < q->option_count; k++) {
+        refs->options[k] = pool_intern(pool, q->options[k]);
+    }
+    refs->explanation = pool_intern(pool, q->explanation);
+    refs->code = pool_intern(pool, q->code);
+    for (int k = 0; k < q->hint_count; k++) {
+        refs->hints[k] = pool_intern(pool, q->hints[k]);
+    }
+    for (int k = 0; k < q->keyword_count; k++) {
+        refs->keywords[k] = pool_intern(pool, q->keywords[k]);
+    }
+    refs->author = pool_intern(pool, q->author);
+}
+
+static void write_bank(FILE* out, const GenQuestion* questions, int count) {
+    // calloc leaves the empty string's entry at offset 0
+    GenPool pool = { calloc(1, 4096), pool_entry_size(0), 4096 };
+    GenRefs* refs = malloc(count * sizeof(GenRefs));
+    if (!pool.data || !refs) {
+        fail("out of memory", NULL);
+    }
+    for (int i = 0; i < count; i++) {
+        intern_question(&pool, &questions[i], &refs[i]);
+    }
+
+    fprintf(out, "// quiz_default_bank.c - Built-in question bank for the C Programming Quiz System\n");
+    fprintf(out, "// Generated from questions/default_bank.def by tools/gen_question_bank.c;\n");
+    fprintf(out, "// edit the .def file and rebuild rather than changing this file\n\n");
+    fprintf(out, "#include \"quiz_system.h\"\n\n");
+    write_pool(out, &pool);
+
+    fprintf(out, "static const Question records[%d] = {\n", count);
+    for (int i = 0; i < count; i++) {
+        const GenQuestion* q = &questions[i];
+        fprintf(out, "    {\n        .id = %d,\n        .slot = %d,\n", q->id, i);
+        fprintf(out, "        .correct_answer = %d,\n        .type = %s,\n", q->answer, type_names[q->type]);
+        fprintf(out, "        .question = %u,\n", refs[i].question);
+        write_refs(out, "options", refs[i].options, MAX_OPTIONS);
+        if (refs[i].explanation) {
+            fprintf(out, "        .explanation = %u,\n", refs[i].explanation);
+        }
+        if (refs[i].code) {
+            fprintf(out, "        .code_snippet = %u,\n", refs[i].code);
+        }
+        write_refs(out, "hints", refs[i].hints, MAX_HINTS);
+        write_refs(out, "keywords", refs[i].keywords, MAX_KEYWORDS);
+        if (refs[i].author) {
+            fprintf(out, "        .author = %u,\n", refs[i].author);
+        }
+        fprintf(out, "    },\n");
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const int ids[%d] = {", count);
+    for (int i = 0; i < count; i++) {
+        fprintf(out, "%s%d", column_separator(i), questions[i].id);
+    }
+    fprintf(out, "\n};\n\nstatic const unsigned char topics[%d] = {\n", count);
+    for (int i = 0; i < count; i++) {
+        fprintf(out, "    %s,\n", topic_names[questions[i].topic]);
+    }
+    fprintf(out, "};\n\nstatic const unsigned char difficulties[%d] = {", count);
+    for (int i = 0; i < count; i++) {
+        fprintf(out, "%s%d", column_separator(i), questions[i].difficulty);
+    }
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "const QuestionBankImage default_question_bank = {\n");
+    fprintf(out, "    records, ids, topics, difficulties, %d, pool, %u\n};\n", count, pool.size);
+    free(refs);
+    free(pool.data);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <input.def> <output.c>\n", argv[0]);
+        return 2;
+    }
+    input_path = argv[1];
+    FILE* in = fopen(input_path, "r");
+    if (!in) {
+        perror(input_path);
+        return 1;
+    }
+    int count;
+    GenQuestion* questions = parse_bank(in, &count);
+    fclose(in);
+    if (count == 0) {
+        fail("no questions", NULL);
+    }
+
+    // Ids default to one past the highest so far, like add_question
+    int next_id = 0;
+    for (int i = 0; i < count; i++) {
+        check_question(&questions[i]);
+        if (questions[i].id < 0) {
+            questions[i].id = next_id;
+        }
+        for (int k = 0; k < i; k++) {
+            if (questions[k].id == questions[i].id) {
+                fail("duplicate id", NULL);
+            }
+        }
+        if (questions[i].id >= next_id) {
+            next_id = questions[i].id + 1;
+        }
+    }
+
+    // Written beside the target and renamed, so a failed run never leaves a
+    // half-written source for the build to pick up
+    char temp_path[GEN_MAX_LINE];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", argv[2]);
+    FILE* out = fopen(temp_path, "w");
+    if (!out) {
+        perror(temp_path);
+        return 1;
+    }
+    write_bank(out, questions, count);
+    free_bank(questions, count);
+    if (fclose(out) != 0 || rename(temp_path, argv[2]) != 0) {
+        perror(argv[2]);
+        remove(temp_path);
+        return 1;
+    }
+    return 0;
+}